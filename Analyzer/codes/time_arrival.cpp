@@ -3,16 +3,17 @@
 using namespace std;
 float xPosition;
 float yPosition;
-int  Fibre_0;
-int  Fibre_1;
-int  Fibre_2;
-int  Fibre_3;
-int  NPhot_Fib;
-int  NPhot_Fib2;
-int  NPhot_Fib3;
-int  NPhot_Fib4;
-vector<float> *Process_deposit;
-vector<float> *Time_deposit;
+float Fibre_0;
+float Fibre_1;
+float Fibre_2;
+float Fibre_3;
+float NPhot_Fib;
+float NPhot_Fib2;
+float NPhot_Fib3;
+float NPhot_Fib4;
+vector<unsigned short> *Photon_time;
+vector<Char_t> *Photon_code;
+float Photon_timeStep;
 
 void time_arrival(){
   TCanvas *canvas = new TCanvas("time_arrival","time_arrival");
@@ -28,8 +29,9 @@ void time_arrival(){
   tree->SetBranchAddress("NPhot_Fib2", &NPhot_Fib2);
   tree->SetBranchAddress("NPhot_Fib3", &NPhot_Fib3);
   tree->SetBranchAddress("NPhot_Fib4", &NPhot_Fib4);
-  tree->SetBranchAddress("Process_deposit", &Process_deposit);
-  tree->SetBranchAddress("Time_deposit", &Time_deposit);
+  tree->SetBranchAddress("Photon_time", &Photon_time);
+  tree->SetBranchAddress("Photon_code", &Photon_code);
+  tree->SetBranchAddress("Photon_timeStep", &Photon_timeStep);
   TH1F *WLS_center = new TH1F("WLS time arrival at center","WLS time arrival at center",1024,-0.1,204.7);
   TH1F *WLS_fiber = new TH1F("WLS time arrival near fiber","WLS time arrival near fiber",1024,-0.1,204.7);
   TH1F *fscint_center = new TH1F("fiber scintillation time arrival at center","fiber scintillation time arrival at center",1024,-0.1,204.7);
@@ -40,11 +42,13 @@ void time_arrival(){
   for (Long64_t jentry=0; jentry<nentries;jentry++){
     Long64_t ientry = tree->LoadTree(jentry);
     nb = tree->GetEntry(jentry);   nbytes += nb;
-    for (int i = 0;i < Process_deposit->size();i++){
-      if (TMath::Abs(xPosition+18.5)<1 && TMath::Abs(yPosition)<1 && Process_deposit->at(i)==1) WLS_center->Fill(Time_deposit->at(i)-5.0);
-      if (TMath::Abs(xPosition+25.5)<1 && TMath::Abs(yPosition+7)<1 && Process_deposit->at(i)==1) WLS_fiber->Fill(Time_deposit->at(i)-5.0);
-      if (TMath::Abs(xPosition+18.5)<1 && TMath::Abs(yPosition)<1 && Process_deposit->at(i)==2) fscint_center->Fill(Time_deposit->at(i)-5.0);
-      if (TMath::Abs(xPosition+25.5)<1 && TMath::Abs(yPosition+7)<1 && Process_deposit->at(i)==2) fscint_fiber->Fill(Time_deposit->at(i)-5.0);
+    for (int i = 0;i < Photon_code->size();i++){
+      int code = (signed char)Photon_code->at(i);
+      float time = Photon_time->at(i)*Photon_timeStep;
+      if (TMath::Abs(xPosition+18.5)<1 && TMath::Abs(yPosition)<1 && code==1) WLS_center->Fill(time-5.0);
+      if (TMath::Abs(xPosition+25.5)<1 && TMath::Abs(yPosition+7)<1 && code==1) WLS_fiber->Fill(time-5.0);
+      if (TMath::Abs(xPosition+18.5)<1 && TMath::Abs(yPosition)<1 && code==2) fscint_center->Fill(time-5.0);
+      if (TMath::Abs(xPosition+25.5)<1 && TMath::Abs(yPosition+7)<1 && code==2) fscint_fiber->Fill(time-5.0);
     }
   }
   WLS_center->Scale(1.0/WLS_center->Integral());
@@ -64,6 +64,11 @@
 
 // Fixed size dimensions of array or collections stored in the TTree if any.
 
+// vertex z quantum of the Photon_z branch [mm], as CreateTree::kZStep
+const float photonZStep = 0.02;
+// bins of the Waveform_N branches over 0-200 ns, as CreateTree::nWaveformBins
+const int waveformBins = 1024;
+
 class Analyzer {
 public :
    TTree          *fChain;   //!pointer to the analyzed TTree or TChain
@@ -104,10 +109,11 @@ public :
 
    // Declaration of leaf types
    Int_t           Event;
-   std::vector<float>   *Time_deposit;
+   Float_t         Photon_timeStep;
+   std::vector<unsigned short> *Photon_time;
+   std::vector<short>   *Photon_z;
+   std::vector<Char_t>  *Photon_code;
    std::vector<float>   *Eact_layer;
-   std::vector<float>   *Process_deposit;
-   std::vector<float>   *Z_deposit;
    std::vector<float>   *opPhoton_time;
    std::vector<int>     *opPhoton_process;
    Float_t         Eabs;
@@ -115,23 +121,31 @@ public :
    Float_t         EfibrCore;
    Float_t         EfibrClad;
    Int_t           nLayers;
-   Int_t           Fibre_0;
-   Int_t           Fibre_1;
-   Int_t           Fibre_2;
-   Int_t           Fibre_3;
+   Float_t         Fibre_0;
+   Float_t         Fibre_1;
+   Float_t         Fibre_2;
+   Float_t         Fibre_3;
    Float_t         xPosition;
    Float_t         yPosition;
    Float_t         EOpt_0;
    Float_t         EOpt_1;
    Float_t         EOpt_2;
    Float_t         EOpt_3;
+   Float_t         Waveform_0[waveformBins];
+   Float_t         Waveform_1[waveformBins];
+   Float_t         Waveform_2[waveformBins];
+   Float_t         Waveform_3[waveformBins];
 
    // List of branches
    TBranch        *b_Event;   //!
+   TBranch        *b_Photon_timeStep;   //!
+   TBranch        *b_Photon_time;   //!
+   TBranch        *b_Photon_z;   //!
+   TBranch        *b_Photon_code;   //!
    TBranch        *b_Time_deposit;   //!
-   TBranch        *b_Eact_layer;   //!
    TBranch        *b_Process_deposit;   //!
    TBranch        *b_Z_deposit;   //!
+   TBranch        *b_Eact_layer;   //!
    TBranch        *b_opPhoton_time;   //!
    TBranch        *b_opPhoton_process;   //!
    TBranch        *b_Eabs;   //!
@@ -149,6 +163,21 @@ public :
    TBranch        *b_EOpt_1;   //!
    TBranch        *b_EOpt_2;   //!
    TBranch        *b_EOpt_3;   //!
+   TBranch        *b_Waveform_0;   //!
+   TBranch        *b_Waveform_1;   //!
+   TBranch        *b_Waveform_2;   //!
+   TBranch        *b_Waveform_3;   //!
+
+   // detected photons, decoded from the packed branches by UnpackPhotons()
+   // or, in files without them, read from the float branches directly
+   Bool_t               packedPhotons;
+   std::vector<float>   *Time_deposit;
+   std::vector<float>   *Process_deposit;
+   std::vector<float>   *Z_deposit;
+
+   // files written with WAVEFORM=1 have the photons binned per fibre in
+   // the Waveform_N branches and no photon branches
+   Bool_t               waveformMode;
 
    Analyzer(TTree *tree=0);
    virtual ~Analyzer();
@@ -158,6 +187,7 @@ public :
    virtual void     Init(TTree *tree);
    virtual void     Loop(std::string setup, std::string energy);
    virtual Bool_t   Notify();
+   void             UnpackPhotons();
    virtual void     Show(Long64_t entry = -1);
    void addHisto(TString name, int nBins, float XLow, float XUp,TString XLabel);
    void addHisto2D(TString name, int nBinsX, float XLow, float XUp,TString XLabel,int nBinsY, float YLow, float YUp,TString YLabel);
@@ -188,6 +218,9 @@ Analyzer::Analyzer(TTree *tree) : fChain(0)
 
 Analyzer::~Analyzer()
 {
+   delete Time_deposit;
+   delete Process_deposit;
+   delete Z_deposit;
    if (!fChain) return;
    delete fChain->GetCurrentFile();
 }
@@ -196,7 +229,9 @@ Int_t Analyzer::GetEntry(Long64_t entry)
 {
 // Read contents of entry.
    if (!fChain) return 0;
-   return fChain->GetEntry(entry);
+   Int_t nb = fChain->GetEntry(entry);
+   UnpackPhotons();
+   return nb;
 }
 Long64_t Analyzer::LoadTree(Long64_t entry)
 {
@@ -248,10 +283,15 @@ void Analyzer::Init(TTree *tree)
 
 
    // Set object pointer
-   Time_deposit = 0;
+   Photon_time = 0;
+   Photon_z = 0;
+   Photon_code = 0;
    Eact_layer = 0;
-   Process_deposit = 0;
-   Z_deposit = 0;
+   Time_deposit = new std::vector<float>;
+   Process_deposit = new std::vector<float>;
+   Z_deposit = new std::vector<float>;
+   packedPhotons = kFALSE;
+   waveformMode = kFALSE;
    opPhoton_time = 0;
    opPhoton_process = 0;
    // Set branch addresses and branch pointers
@@ -261,10 +301,21 @@ void Analyzer::Init(TTree *tree)
    fChain->SetMakeClass(1);
 
    fChain->SetBranchAddress("Event", &Event, &b_Event);
-   fChain->SetBranchAddress("Time_deposit", &Time_deposit, &b_Time_deposit);
+   // files of the variants that still write the float photon vectors
+   packedPhotons = fChain->GetBranch("Photon_time") != 0;
+   if (packedPhotons) {
+      fChain->SetBranchAddress("Photon_timeStep", &Photon_timeStep, &b_Photon_timeStep);
+      fChain->SetBranchAddress("Photon_time", &Photon_time, &b_Photon_time);
+      fChain->SetBranchAddress("Photon_z", &Photon_z, &b_Photon_z);
+      fChain->SetBranchAddress("Photon_code", &Photon_code, &b_Photon_code);
+   }
+   else if (fChain->GetBranch("Time_deposit")) {
+      fChain->SetBranchAddress("Time_deposit", &Time_deposit, &b_Time_deposit);
+      fChain->SetBranchAddress("Process_deposit", &Process_deposit, &b_Process_deposit);
+      if (fChain->GetBranch("Z_deposit"))
+         fChain->SetBranchAddress("Z_deposit", &Z_deposit, &b_Z_deposit);
+   }
    fChain->SetBranchAddress("Eact_layer", &Eact_layer, &b_Eact_layer);
-   fChain->SetBranchAddress("Process_deposit", &Process_deposit, &b_Process_deposit);
-   fChain->SetBranchAddress("Z_deposit", &Z_deposit, &b_Z_deposit);
    fChain->SetBranchAddress("opPhoton_time", &opPhoton_time, &b_opPhoton_time);
    fChain->SetBranchAddress("opPhoton_process", &opPhoton_process, &b_opPhoton_process);
    fChain->SetBranchAddress("Eabs", &Eabs, &b_Eabs);
@@ -282,6 +333,13 @@ void Analyzer::Init(TTree *tree)
    fChain->SetBranchAddress("EOpt_1", &EOpt_1, &b_EOpt_1);
    fChain->SetBranchAddress("EOpt_2", &EOpt_2, &b_EOpt_2);
    fChain->SetBranchAddress("EOpt_3", &EOpt_3, &b_EOpt_3);
+   waveformMode = fChain->GetBranch("Waveform_0") != 0;
+   if (waveformMode) {
+      fChain->SetBranchAddress("Waveform_0", Waveform_0, &b_Waveform_0);
+      fChain->SetBranchAddress("Waveform_1", Waveform_1, &b_Waveform_1);
+      fChain->SetBranchAddress("Waveform_2", Waveform_2, &b_Waveform_2);
+      fChain->SetBranchAddress("Waveform_3", Waveform_3, &b_Waveform_3);
+   }
    Notify();
 }
 
@@ -296,6 +354,25 @@ Bool_t Analyzer::Notify()
    return kTRUE;
 }
 
+void Analyzer::UnpackPhotons()
+{
+   // back to the float vectors used in Loop(), reusing their capacity; the
+   // float branches, if read instead, fill them in GetEntry()
+   if (!packedPhotons) return;
+   Time_deposit->clear();
+   Process_deposit->clear();
+   Z_deposit->clear();
+   if (!Photon_time) return;
+   Time_deposit->reserve(Photon_time->size());
+   Process_deposit->reserve(Photon_time->size());
+   Z_deposit->reserve(Photon_time->size());
+   for (size_t i = 0; i < Photon_time->size(); ++i) {
+      Time_deposit->push_back(Photon_time->at(i)*Photon_timeStep);
+      Process_deposit->push_back((signed char)Photon_code->at(i));
+      Z_deposit->push_back(Photon_z->at(i)*photonZStep);
+   }
+}
+
 void Analyzer::Show(Long64_t entry)
 {
 // Print contents of entry.
@@ -175,7 +175,7 @@ void Analyzer::Loop(std::string setup, std::string energy)
 
   int nPhotTiming=200;
   LoadTree(0);
-  fChain->GetEntry(0);
+  GetEntry(0);
   //  nPhotTiming=(int)(Time_deposit->size()*0.01);
   std::cout<<"averaging time on "<<nPhotTiming<<" photons"<<std::endl;
 
@@ -207,7 +207,7 @@ void Analyzer::Loop(std::string setup, std::string energy)
    for (Long64_t jentry=0; jentry<nentries;jentry++) {
       Long64_t ientry = LoadTree(jentry);
       if (ientry < 0) break;
-      nb = fChain->GetEntry(jentry);   nbytes += nb;
+      nb = GetEntry(jentry);   nbytes += nb;
       // if (Cut(ientry) < 0) continue;
       if(jentry%100 == 0)std::cout<<"Entry:"<<jentry<<"/"<<nentries<<std::endl;
       float averageTiming = 0;
@@ -266,6 +266,17 @@ void Analyzer::Loop(std::string setup, std::string energy)
 	}
       }
 
+      // in waveform files the simulation has already binned the photons
+      // of the four fibres like wave; a kernel applied there
+      // (WAVEFORM_KERNEL) is not to be applied again with DOSHAPING
+      if(waveformMode){
+	for(int i=0;i<waveformBins;++i){
+	  float sample = Waveform_0[i]+Waveform_1[i]+Waveform_2[i]+Waveform_3[i];
+	  wave->SetBinContent(i+1,sample);
+	  if(jentry<10)	histos_["waveform_total"]->Fill(wave->GetBinCenter(i+1),sample);
+	}
+      }
+
 
 
 
@@ -342,6 +353,9 @@ void Analyzer::Loop(std::string setup, std::string energy)
       }
 	  wave->Reset();	
 
+      // the rest needs the single photons
+      if(waveformMode) continue;
+
 
       if(setup_=="SingleFibre" || setup_=="Ideal2016")         nPhotTiming=(int)(Time_deposit->size()*0.01);
       else nPhotTiming=(int)(Time_deposit->size()*0.01);
@@ -407,7 +421,7 @@ void Analyzer::Loop(std::string setup, std::string energy)
 
 
 
-   fitHisto(histos_["timeArrival_avg"],resValueTime,resValueTimeErr);
+   if(!waveformMode) fitHisto(histos_["timeArrival_avg"],resValueTime,resValueTimeErr);
    fitHisto(histos_["time_frac50"],resValueTime_frac50,resValueTimeErr_frac50);
    fitHisto(histos_["nPhotons"],resValueEnergy,resValueEnergyErr,true,meanValueEnergy,meanValueEnergyErr);
    fitHisto(histos_["EactLYScaled"],resValueEactLYScaled,resValueEactLYScaledErr,true,meanValueEactLYScaled,meanValueEactLYScaledErr);
@@ -24,10 +24,21 @@ class CreateTree
   static CreateTree* Instance() { return fInstance; };
   static CreateTree* fInstance;
   int Event;
-  std::vector<float> Time_deposit;
-  std::vector<float> Z_deposit;
-  std::vector<float> Process_deposit;//1 is WLS, 2 Scintillation, 3 Cerenkov
-  std::vector<float> Theta_deposit;
+  // detected photons, one element per photon in each vector, filled with
+  // AddPhoton(); the vectors keep their capacity from one event to the next
+  void AddPhoton(float time, float z, float theta, int code);
+  // time quantum [ns], 0.01 ns (655 ns range) unless set otherwise
+  static void  SetTimeStep(float step) { fTimeStep = step; };
+  static float GetTimeStep() { return fTimeStep; };
+  static float fTimeStep;
+  static const float kZStep;      // [mm] per count of Photon_z
+  static const float kThetaStep;  // [rad] per count of Photon_theta
+  std::vector<unsigned short> Photon_time;  // [Photon_timeStep], 65535 = later
+  std::vector<short> Photon_z;              // vertex z
+  std::vector<unsigned short> Photon_theta; // vertex polar angle
+  std::vector<Char_t> Photon_code;  // 3*fibre + 1 WLS, 2 Scintillation, 3 Cerenkov; -1 other,
+                                    // read back through signed char: plain char is unsigned on ARM
+  float Photon_timeStep;
   std::vector<float> opPhoton_time;
   std::vector<int> opPhoton_process;
   float  Eabs;
@@ -39,21 +50,21 @@ class CreateTree
   float  Eact_1x3;
   float Eact_CentralXtal;
   float Eabs_CentralXtal;
-  int    NPhot_Act;
-  int    NPhot_Fib;
-  int    NPhot_Fib2;
-  int    NPhot_Fib3;
-  int    NPhot_Fib4;
+  float  NPhot_Act;
+  float  NPhot_Fib;
+  float  NPhot_Fib2;
+  float  NPhot_Fib3;
+  float  NPhot_Fib4;
   float  EfibrCore;
   float  EfibrClad;
   int    nLayers;
 
-  int   Fibre_start_0;
+  float Fibre_start_0;
 
-  int   Fibre_0;
-  int   Fibre_1;
-  int   Fibre_2;
-  int   Fibre_3;
+  float Fibre_0;
+  float Fibre_1;
+  float Fibre_2;
+  float Fibre_3;
 
   float  xPosition;
   float  yPosition;
@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashMatrixParameterisation.hh
+/// \brief Definition of the EEShashMatrixParameterisation class
+
+#ifndef EEShashMatrixParameterisation_h
+#define EEShashMatrixParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+/// Placement of the channels of the matrix around the central one
+///
+/// The channels made of one logical volume are the copies of a single
+/// G4PVParameterised, placed in an envelope which contains nothing else
+/// (Geant4 does not allow other daughters next to a parameterised volume).
+/// Copy i is translated to the centre of the i-th cell added, (ix,iy) on a
+/// square grid of the given pitch, in the frame of the envelope whose
+/// centre is the cell (centreIx,0): the rotation to the beam is the one of
+/// the envelope. The copies share one physical volume and the navigation
+/// uses the smart voxels of the parameterisation.
+
+class EEShashMatrixParameterisation : public G4VPVParameterisation
+{
+  public:
+    EEShashMatrixParameterisation(G4double pitch, G4double centreIx);
+    virtual ~EEShashMatrixParameterisation();
+
+    void AddCell(G4int ix, G4int iy);
+    G4int GetNumberOfCells() const { return fPositions.size(); }
+
+    virtual void ComputeTransformation(const G4int copyNo,
+                                       G4VPhysicalVolume* physVol) const;
+
+  private:
+    G4double fPitch;     // distance between the centres of the channels
+    G4double fCentreIx;  // cell at the centre of the envelope, along x
+    std::vector<G4ThreeVector> fPositions;  // in the envelope, per copy
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
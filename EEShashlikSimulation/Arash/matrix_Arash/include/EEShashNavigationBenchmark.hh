@@ -0,0 +1,54 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashNavigationBenchmark.hh
+/// \brief Definition of the EEShashNavigationBenchmark class
+
+#ifndef EEShashNavigationBenchmark_h
+#define EEShashNavigationBenchmark_h 1
+
+#include "globals.hh"
+#include "G4SystemOfUnits.hh"
+
+/// Timing of the Geant4 navigation in the constructed geometry
+///
+/// GeantinoScan() steps straight rays through the world with a private
+/// G4Navigator, as the transportation does for geantinos but without the
+/// tracking and physics: the rays start upstream of the calorimeter on a
+/// square grid around the beam axis, with small tilts, and are followed
+/// from boundary to boundary until they leave the world. The time per step
+/// is what the geometry costs, e.g. placements against parameterised
+/// volumes (PARAMETERISED_MATRIX=0/1 in main).
+/// To be called on the master after the run manager is initialised.
+
+class EEShashNavigationBenchmark
+{
+  public:
+    static void GeantinoScan(G4int nRays, G4double halfWidth = 50.*CLHEP::mm);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -42,6 +42,7 @@ std::vector<float> time_vector;
 
 #include "EEShashDetectorConstruction.hh"
 #include "EEShashActionInitialization.hh"
+#include "EEShashNavigationBenchmark.hh"
 #include "SteppingAction.hh"
 #include "TrackingAction.hh"
 
@@ -174,6 +175,11 @@ int main(int argc,char** argv)
 
   // Initialize DetectorConstruction
   EEShashDetectorConstruction* detConstruction = new EEShashDetectorConstruction(rotation, zTras);
+  // Cells around the central channels parameterised (default) or placed one
+  // by one (PARAMETERISED_MATRIX=0)
+  if( std::getenv("PARAMETERISED_MATRIX") ) {
+    detConstruction->SetParameterisedMatrix(atoi(std::getenv("PARAMETERISED_MATRIX")) != 0);
+  }
   runManager->SetUserInitialization(detConstruction);
 
   // Switch on relevant physics
@@ -234,6 +240,18 @@ int main(int argc,char** argv)
   // Initialize G4 kernel
   //
   runManager->Initialize();
+
+  // Optional timing of the per-step volume classification on the steps of
+  // the run, replayed every <nSteps> steps (ROLEBENCH=<nSteps>)
+  if( std::getenv("ROLEBENCH") ) {
+    EEShashVolumeRoleTable::SetBenchmark(atoi(std::getenv("ROLEBENCH")));
+  }
+
+  // Optional timing of the navigation with straight geantino rays
+  // (GEANTINOSCAN=<nRays>), e.g. with and without the parameterised matrix
+  if( std::getenv("GEANTINOSCAN") ) {
+    EEShashNavigationBenchmark::GeantinoScan(atoi(std::getenv("GEANTINOSCAN")));
+  }
   
 #ifdef G4VIS_USE
   // Initialize visualization
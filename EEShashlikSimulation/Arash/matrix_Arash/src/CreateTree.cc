@@ -1,9 +1,14 @@
 #include "CreateTree.h"
 
+#include <cmath>
 
 
 CreateTree* CreateTree::fInstance = NULL;
 
+float CreateTree::fTimeStep = 0.01;
+const float CreateTree::kZStep = 0.02;
+const float CreateTree::kThetaStep = 3.14159265359/65535.;
+
 
 
 CreateTree::CreateTree(TString name)
@@ -28,29 +33,30 @@ CreateTree::CreateTree(TString name)
   this->GetTree()->Branch("Eabs_CentralXtal",&this->Eabs_CentralXtal,"Eabs_CentralXtal");
   this->GetTree()->Branch("Eact_CentralXtal",&this->Eact_CentralXtal,"Eact_CentralXtal");
   
-  this->GetTree()->Branch("Time_deposit",&this->Time_deposit);
-  this->GetTree()->Branch("Process_deposit",&this->Process_deposit);
-  this->GetTree()->Branch("Z_deposit",&this->Z_deposit);
-  this->GetTree()->Branch("Theta_deposit",&this->Theta_deposit);
+  this->GetTree()->Branch("Photon_timeStep",&this->Photon_timeStep,"Photon_timeStep/F");
+  this->GetTree()->Branch("Photon_time",&this->Photon_time);
+  this->GetTree()->Branch("Photon_z",&this->Photon_z);
+  this->GetTree()->Branch("Photon_theta",&this->Photon_theta);
+  this->GetTree()->Branch("Photon_code",&this->Photon_code);
   this->GetTree()->Branch("opPhoton_time",&this->opPhoton_time);    
   this->GetTree()->Branch("opPhoton_process",&this->opPhoton_process);    
   this->GetTree()->Branch("Eabs",&this->Eabs,"Eabs/F");
   this->GetTree()->Branch("Eact",&this->Eact,"Eact/F");
-  this->GetTree()->Branch("NPhot_Act",&this->NPhot_Act,"NPhot_Act/I");
-  this->GetTree()->Branch("NPhot_Fib",&this->NPhot_Fib,"NPhot_Fib/I");
-  this->GetTree()->Branch("NPhot_Fib2",&this->NPhot_Fib2,"NPhot_Fib2/I");
-  this->GetTree()->Branch("NPhot_Fib3",&this->NPhot_Fib3,"NPhot_Fib3/I");
-  this->GetTree()->Branch("NPhot_Fib4",&this->NPhot_Fib4,"NPhot_Fib4/I");
+  this->GetTree()->Branch("NPhot_Act",&this->NPhot_Act,"NPhot_Act/F");
+  this->GetTree()->Branch("NPhot_Fib",&this->NPhot_Fib,"NPhot_Fib/F");
+  this->GetTree()->Branch("NPhot_Fib2",&this->NPhot_Fib2,"NPhot_Fib2/F");
+  this->GetTree()->Branch("NPhot_Fib3",&this->NPhot_Fib3,"NPhot_Fib3/F");
+  this->GetTree()->Branch("NPhot_Fib4",&this->NPhot_Fib4,"NPhot_Fib4/F");
   this->GetTree()->Branch("EfibrCore",&this->EfibrCore,"EfibrCore/F");
   this->GetTree()->Branch("EfibrClad",&this->EfibrClad,"EfibrClad/F");
   this->GetTree()->Branch("nLayers",&this->nLayers,"nLayers/I");
 
-  this->GetTree()->Branch("Fibre_start_0",&this->Fibre_start_0,"Fibre_start_0/I");
+  this->GetTree()->Branch("Fibre_start_0",&this->Fibre_start_0,"Fibre_start_0/F");
 
-  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/I");
-  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/I");
-  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/I");
-  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/I");
+  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/F");
+  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/F");
+  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/F");
+  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/F");
 
   this->GetTree()->Branch("xPosition",&this->xPosition,"xPosition/F");
   this->GetTree()->Branch("yPosition",&this->yPosition,"yPosition/F");
@@ -79,13 +85,28 @@ bool CreateTree::Write()
 }
 
 
+void CreateTree::AddPhoton(float time, float z, float theta, int code)
+{
+  // rounded to the nearest step, out of range values saturate
+  float t = time/fTimeStep + 0.5;
+  Photon_time.push_back( t < 65535. ? (unsigned short)(t > 0. ? t : 0.) : 65535 );
+  float zq = floor(z/kZStep + 0.5);
+  if( zq > 32767. ) zq = 32767.;
+  if( zq < -32768. ) zq = -32768.;
+  Photon_z.push_back((short)zq);
+  Photon_theta.push_back((unsigned short)(theta/kThetaStep + 0.5));
+  Photon_code.push_back((Char_t)code);
+}
+
+
 void CreateTree::Clear()
 {
   Event = 0;
-  Time_deposit.clear();
-  Process_deposit.clear();
-  Z_deposit.clear();
-  Theta_deposit.clear();
+  Photon_timeStep = fTimeStep;
+  Photon_time.clear();
+  Photon_z.clear();
+  Photon_theta.clear();
+  Photon_code.clear();
   opPhoton_time.clear();
   opPhoton_process.clear();
   Eabs=0;
@@ -29,6 +29,8 @@
 
 #include "EEShashDetectorConstruction.hh"
 #include "EEShashCalorimeterSD.hh"
+#include "EEShashOpticalReadoutSD.hh"
+#include "EEShashMatrixParameterisation.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
@@ -37,6 +39,7 @@
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
@@ -78,7 +81,8 @@ EEShashDetectorConstruction::EEShashDetectorConstruction( G4double rotation, G4d
    fNofLayers(-1),
 //   fNofBGOs(-1),
    fRotation(rotation),
-   fZtraslation(zTras)
+   fZtraslation(zTras),
+   fParameterisedMatrix(true)
 {
 }
 
@@ -96,7 +100,12 @@ G4VPhysicalVolume* EEShashDetectorConstruction::Construct()
   DefineMaterials();
   
   // Define volumes
-  return DefineVolumes();
+  G4VPhysicalVolume* worldPV = DefineVolumes();
+
+  // Classify the volumes once for the stepping action
+  fRoleTable.Build();
+
+  return worldPV;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -541,10 +550,7 @@ void EEShashDetectorConstruction::DefineMaterials()
  // mptCeF->AddProperty ("RINDEX", PhotonEnergy_RI, refractiveIndex_CeF3, nEntries_RI)->SetSpline(true);
  //mptCeF->AddProperty ("ABSLENGTH", PhotonEnergy_ABS, Absorption, nEntries_ABS);
  
- //mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);//this should be 1000./MeV 
- //test
- //mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 6./MeV);//this should be 1000./MeV
- mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 10./MeV);//this should be 1000./MeV 
+ mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);
  mptCeF->AddConstProperty ("RESOLUTIONSCALE", 1);
  // mptCeF->AddConstProperty ("RESOLUTIONSCALE", 2.58);
  //mptCeF->AddConstProperty ("FASTTIMECONSTANT", 32.5 *ns);
@@ -554,7 +560,7 @@ void EEShashDetectorConstruction::DefineMaterials()
  G4MaterialPropertiesTable* mptCeF_center = new G4MaterialPropertiesTable();
  mptCeF_center->AddProperty ("FASTCOMPONENT", PhotonEnergy_CeF, Emission_CeF, nEntries_CeF);
  mptCeF_center->AddProperty ("RINDEX", PhotonEnergy_RI, refractiveIndex_CeF3, nEntries_RI);
- mptCeF_center->AddConstProperty ("SCINTILLATIONYIELD", 10./MeV);//this should be 1000./MeV 
+ mptCeF_center->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);
  mptCeF_center->AddConstProperty ("RESOLUTIONSCALE", 1);
  //mptCeF_center->AddConstProperty ("FASTTIMECONSTANT", 32.5 *ns); //27.5 ns
  mptCeF_center->AddConstProperty ("FASTTIMECONSTANT", 27.5 *ns);
@@ -2194,6 +2200,102 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
 //  }
       
 
+  // The channels around the central ones, with their pompom and tyvek
+  // cover, are cells parameterised in two envelopes: calorLV for ix<=0 and
+  // calorLV3 for ix>0. The left envelope leaves a hole for the shash at
+  // (0,0) and the channel at (-1,0) with the fibres, placed as before.
+  // The envelopes are rotated with the calorimeter as a whole.
+  // With SetParameterisedMatrix(false) (PARAMETERISED_MATRIX=0 in main):
+  // one placement per channel, pompom and cover, as before
+  if( fParameterisedMatrix ) {
+    G4double pitch = calorSizeXY + 1.5*mm;  // miniGap of the placements below
+    G4double cellLength = pompomLength + calorThickness;
+
+    // cell: pompom in front of the channel, tyvek cover around it
+    G4VSolid* cellS
+      = new G4Box("MatrixCell", tyvekSizeXY/2., tyvekSizeXY/2., cellLength/2.);
+    G4LogicalVolume* cellLV
+      = new G4LogicalVolume(cellS, defaultMaterial, "MatrixCellLV");
+    G4LogicalVolume* cellLV3
+      = new G4LogicalVolume(cellS, defaultMaterial, "MatrixCellLV3");
+
+    G4LogicalVolume* cellLVs[2] = { cellLV, cellLV3 };
+    G4LogicalVolume* channelLVs[2] = { calorLV, calorLV3 };
+    const char* channelNames[2] = { "Calorimeter", "Calorimeter3" };
+    for( int i=0; i<2; ++i ) {
+      new G4PVPlacement(0, G4ThreeVector(0., 0., -calorThickness/2.),
+                        PompomLV, "Pompom", cellLVs[i], false, 0, fCheckOverlaps);
+      new G4PVPlacement(0, G4ThreeVector(0., 0., pompomLength/2.),
+                        channelLVs[i], channelNames[i], cellLVs[i], false, 0, fCheckOverlaps);
+      new G4PVPlacement(0, G4ThreeVector(0., 0., pompomLength/2.),
+                        TyvekCoverLV, "TyvekCoverPV", cellLVs[i], false, 0, fCheckOverlaps);
+    }
+
+    G4VSolid* matrixLeftBoxS
+      = new G4Box("MatrixLeftBox", 1.5*pitch, 1.5*pitch, cellLength/2.);
+    G4VSolid* matrixHoleS
+      = new G4Box("MatrixHole", pitch, pitch/2., cellLength/2.+1.*mm);
+    G4VSolid* matrixLeftS
+      = new G4SubtractionSolid("MatrixLeft", matrixLeftBoxS, matrixHoleS, 0,
+                               G4ThreeVector(0.5*pitch, 0., 0.));
+    G4LogicalVolume* matrixLeftLV
+      = new G4LogicalVolume(matrixLeftS, defaultMaterial, "MatrixLeftLV");
+
+    G4VSolid* matrixRightS
+      = new G4Box("MatrixRight", pitch, 1.5*pitch, cellLength/2.);
+    G4LogicalVolume* matrixRightLV
+      = new G4LogicalVolume(matrixRightS, defaultMaterial, "MatrixRightLV");
+
+    EEShashMatrixParameterisation* leftParam
+      = new EEShashMatrixParameterisation(pitch, -1.);
+    EEShashMatrixParameterisation* rightParam
+      = new EEShashMatrixParameterisation(pitch, 1.5);
+    for( int ix=-2; ix<=2; ++ix ) {
+      for( int iy=-1; iy<=1; ++iy ) {
+        if( iy==0 && (ix==0 || ix==-1) ) continue;  // central channels
+        if( ix<=0 ) leftParam->AddCell(ix, iy);
+        else        rightParam->AddCell(ix, iy);
+      }
+    }
+
+    G4double zPos = fZtraslation - pompomLength/2.;
+    new G4PVPlacement(
+                 rotation,                // rotation
+                 G4ThreeVector(-pitch, sin(fRotation*3.14159265359/180.)*zPos, cos(-fRotation*3.14159265359/180.)*zPos),
+                 matrixLeftLV,            // its logical volume
+                 "MatrixLeft",            // its name
+                 labLV,          // its mother  volume
+                 false,            // no boolean operation
+                 0,                // copy number
+                 fCheckOverlaps);  // checking overlaps
+    new G4PVPlacement(
+                 rotation,                // rotation
+                 G4ThreeVector(1.5*pitch, sin(fRotation*3.14159265359/180.)*zPos, cos(-fRotation*3.14159265359/180.)*zPos),
+                 matrixRightLV,           // its logical volume
+                 "MatrixRight",           // its name
+                 labLV,          // its mother  volume
+                 false,            // no boolean operation
+                 0,                // copy number
+                 fCheckOverlaps);  // checking overlaps
+
+    new G4PVParameterised(
+                 "MatrixCell",     // its name
+                 cellLV,           // its logical volume
+                 matrixLeftLV,     // its mother
+                 kUndefined,       // 3D voxelisation
+                 leftParam->GetNumberOfCells(),
+                 leftParam,
+                 fCheckOverlaps);  // checking overlaps
+    new G4PVParameterised(
+                 "MatrixCell3",    // its name
+                 cellLV3,          // its logical volume
+                 matrixRightLV,    // its mother
+                 kUndefined,       // 3D voxelisation
+                 rightParam->GetNumberOfCells(),
+                 rightParam,
+                 fCheckOverlaps);  // checking overlaps
+  }
+
   int copyNumber = 1;
   int totalCopies = 25;
 
@@ -2206,6 +2308,12 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
         std::cout << " Exiting." << std::endl;
         exit(11);  }
 
+      // parameterised above
+      if( fParameterisedMatrix && !(iy==0 && ix==-1) ) {
+        copyNumber += 1;
+        continue;
+      }
+
       G4double miniGap = 1.5*mm;
 
 
@@ -2353,6 +2461,13 @@ void EEShashDetectorConstruction::ConstructSDandField()
   EEShashCalorimeterSD* APDSD
     = new EEShashCalorimeterSD("APDLV", "APDHitsCollection", 4,-1);
   SetSensitiveDetector("APDLV",APDSD);
+  // and the photons reaching the grease at the fibre ends
+  G4double quantumEfficiency = 0.25; //average value of qe //0.75
+  G4double mirroringGain = 0.25; //mirroring a fibre at one end gives 25% light more (theoretical max is 50%)
+  EEShashOpticalReadoutSD* opticalSD
+    = new EEShashOpticalReadoutSD("OpticalSD", "OpticalHitsCollection", 4,
+                                  quantumEfficiency*(1+mirroringGain));
+  SetSensitiveDetector("GreaseLV",opticalSD);
 
   /*
   // and  POMMMELS:
@@ -39,6 +39,7 @@
 #include "G4SDManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
 
 #include "Randomize.hh"
 #include <iomanip>
@@ -53,7 +54,8 @@ EEShashEventAction::EEShashEventAction()
    fActHCID(-1),
    //fBgoHCID(-1),
    fFibrHCIDCore(-1),
-   fFibrHCIDClad(-1)
+   fFibrHCIDClad(-1),
+   fOpticalHCID(-1)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -83,6 +85,26 @@ EEShashEventAction::GetHitsCollection(G4int hcID,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+EEShashOpticalHitsCollection* 
+EEShashEventAction::GetOpticalHitsCollection(G4int hcID,
+                                  const G4Event* event) const
+{
+  EEShashOpticalHitsCollection* hitsCollection 
+    = static_cast<EEShashOpticalHitsCollection*>(
+        event->GetHCofThisEvent()->GetHC(hcID));
+  
+  if ( ! hitsCollection ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot access hitsCollection ID " << hcID; 
+    G4Exception("EEShashEventAction::GetOpticalHitsCollection()",
+      "MyCode0003", FatalException, msg);
+  }         
+
+  return hitsCollection;
+}    
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void EEShashEventAction::PrintEventStatistics(
                               G4double absEdep, G4double absTrackLength,
                               G4double actEdep, G4double actTrackLength,
@@ -164,6 +186,8 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
       = G4SDManager::GetSDMpointer()->GetCollectionID("FibrHitsCollectionCore");
     fFibrHCIDClad 
       = G4SDManager::GetSDMpointer()->GetCollectionID("FibrHitsCollectionClad");
+    fOpticalHCID
+      = G4SDManager::GetSDMpointer()->GetCollectionID("OpticalHitsCollection");
     fAPDHCID
       = G4SDManager::GetSDMpointer()->GetCollectionID("APDHitsCollection");
 
@@ -188,6 +212,7 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   EEShashCalorHitsCollection* fibrHCCore = GetHitsCollection(fFibrHCIDCore, event);
   EEShashCalorHitsCollection* fibrHCClad = GetHitsCollection(fFibrHCIDClad, event);
   EEShashCalorHitsCollection* APDHC = GetHitsCollection(fAPDHCID, event);
+  EEShashOpticalHitsCollection* opticalHC = GetOpticalHitsCollection(fOpticalHCID, event);
   // EEShashCalorHitsCollection* scint1HC = GetHitsCollection(fScint1HCID, event);
   // EEShashCalorHitsCollection* hodo11HC = GetHitsCollection(fHodo11HCID, event);
   //  EEShashCalorHitsCollection* hodo12HC = GetHitsCollection(fHodo12HCID, event);
@@ -208,6 +233,30 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   // EEShashCalorHit* hodo11Hit = (*hodo11HC)[hodo11HC->entries()-1];
   // EEShashCalorHit* hodo12Hit = (*hodo12HC)[hodo11HC->entries()-1];
  
+  // Sum the photons detected at the end of each fibre
+  G4int fibre[nMaxFibres];
+  G4int NPhotFib[nMaxFibres];
+  G4double EOpt[nMaxFibres];
+  for( int i=0; i<nMaxFibres; ++i ) {
+    fibre[i] = 0;
+    NPhotFib[i] = 0;
+    EOpt[i] = 0.;
+  }
+  for( G4int i=0; i<opticalHC->entries(); ++i ) {
+    EEShashOpticalHit* opticalHit = (*opticalHC)[i];
+    G4int iFibre = opticalHit->GetFibre();
+    EOpt[iFibre] += opticalHit->GetEnergy()/eV;
+    if( opticalHit->GetProcess() == EEShashOpticalHit::kWLS ) fibre[iFibre] += 1;
+    if( opticalHit->GetProcess() == EEShashOpticalHit::kScintillation ) NPhotFib[iFibre] += 1;
+    // process code is 3*fibre + 1 (WLS), 2 (scintillation), 3 (cherenkov)
+    G4int code = -1;
+    if( opticalHit->GetProcess() != EEShashOpticalHit::kOther )
+      code = 3*iFibre+opticalHit->GetProcess();
+    CreateTree::Instance() -> AddPhoton(opticalHit->GetTime()/ns,
+                                        opticalHit->GetVertexZ()/mm,
+                                        opticalHit->GetVertexTheta(), code);
+  }
+ 
   // Print per event (modulo n)
   //
   G4int eventID = event->GetEventID();
@@ -291,10 +340,9 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   }
   placeHolder=placeHolder+nFibres;
   
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre0  );
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre1  );
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre2  );
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre3  );
+  for(int i=0;i<nMaxFibres;++i){
+    analysisManager->FillNtupleDColumn(placeHolder++, fibre[i]  );
+  }
    
 
   std::cout << "xPosition = " << xBeamPos << std::endl;
@@ -302,15 +350,13 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   std::cout << "yPosition = " << yBeamPos << std::endl;
   analysisManager->FillNtupleDColumn(placeHolder++, yBeamPos  );
 
-  std::cout << "EOpt_0    = " << EOpt_0 << std::endl;
-  std::cout << "EOpt_1    = " << EOpt_1 << std::endl;
-  std::cout << "EOpt_2    = " << EOpt_2 << std::endl;
-  std::cout << "EOpt_3    = " << EOpt_3 << std::endl;
+  for(int i=0;i<nMaxFibres;++i){
+    std::cout << "EOpt_" << i << "    = " << EOpt[i] << std::endl;
+  }
 
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_0  );
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_1  );
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_2  );
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_3  );
+  for(int i=0;i<nMaxFibres;++i){
+    analysisManager->FillNtupleDColumn(placeHolder++, EOpt[i]  );
+  }
 
   std::cout<<"filling time"<<std::endl;
   for(unsigned i=0;i<nPhotonsForTiming;++i){
@@ -323,10 +369,10 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   
   std::cout << 1+event->GetEventID() << " events done " << std::endl;
   
-  CreateTree::Instance() -> EOpt_0 = EOpt_0;
-  CreateTree::Instance() -> EOpt_1 = EOpt_1;
-  CreateTree::Instance() -> EOpt_2 = EOpt_2;
-  CreateTree::Instance() -> EOpt_3 = EOpt_3;
+  CreateTree::Instance() -> EOpt_0 = EOpt[0];
+  CreateTree::Instance() -> EOpt_1 = EOpt[1];
+  CreateTree::Instance() -> EOpt_2 = EOpt[2];
+  CreateTree::Instance() -> EOpt_3 = EOpt[3];
   CreateTree::Instance() -> nLayers = nLayers;
 
   CreateTree::Instance() -> Eabs = absHit->GetEdep();
@@ -344,15 +390,15 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   CreateTree::Instance() -> EfibrCore =  fibrHitCore->GetEdep();
   CreateTree::Instance() -> EfibrClad =  fibrHitClad->GetEdep();
 
-  CreateTree::Instance() -> Fibre_0 = fibre0;
-  CreateTree::Instance() -> Fibre_1 = fibre1;
-  CreateTree::Instance() -> Fibre_2 = fibre2;
-  CreateTree::Instance() -> Fibre_3 = fibre3;
+  CreateTree::Instance() -> Fibre_0 = fibre[0];
+  CreateTree::Instance() -> Fibre_1 = fibre[1];
+  CreateTree::Instance() -> Fibre_2 = fibre[2];
+  CreateTree::Instance() -> Fibre_3 = fibre[3];
   CreateTree::Instance() -> NPhot_Act = NPhotAct;
-  CreateTree::Instance() -> NPhot_Fib = NPhotFib;
-  CreateTree::Instance() -> NPhot_Fib2 = NPhotFib2;
-  CreateTree::Instance() -> NPhot_Fib3 = NPhotFib3;
-  CreateTree::Instance() -> NPhot_Fib4 = NPhotFib4;
+  CreateTree::Instance() -> NPhot_Fib = NPhotFib[0];
+  CreateTree::Instance() -> NPhot_Fib2 = NPhotFib[1];
+  CreateTree::Instance() -> NPhot_Fib3 = NPhotFib[2];
+  CreateTree::Instance() -> NPhot_Fib4 = NPhotFib[3];
   CreateTree::Instance() -> Fibre_start_0 = fibreStart0;
   CreateTree::Instance() -> xPosition = xBeamPos;
   CreateTree::Instance() -> yPosition = yBeamPos;
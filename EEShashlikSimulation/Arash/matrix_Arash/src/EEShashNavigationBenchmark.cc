@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashNavigationBenchmark.cc
+/// \brief Implementation of the EEShashNavigationBenchmark class
+
+#include "EEShashNavigationBenchmark.hh"
+
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4ThreeVector.hh"
+#include "G4Timer.hh"
+#include "G4ios.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::GeantinoScan(G4int nRays, G4double halfWidth)
+{
+  G4VPhysicalVolume* worldPV = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking()->GetWorldVolume();
+  if ( nRays<=0 || ! worldPV ) return;
+
+  // upstream face of the world, inside it
+  G4double zStart
+    = worldPV->GetLogicalVolume()->GetSolid()->GetExtent().GetZmin() + 1.*CLHEP::mm;
+
+  G4Navigator navigator;
+  navigator.SetWorldVolume(worldPV);
+
+  // a few steps can be limited to zero at the boundaries; a ray stuck on
+  // one gives up rather than looping
+  const G4int maxStepsPerRay = 100000;
+  G4int nGrid = G4int(std::sqrt(G4double(nRays)));
+  if ( nGrid < 1 ) nGrid = 1;
+
+  G4long nSteps = 0;
+  G4long nZeroSteps = 0;
+  G4int nStuck = 0;
+  G4Timer timer;
+  timer.Start();
+  for ( G4int i=0; i<nRays; ++i ) {
+    G4int gx = i%nGrid;
+    G4int gy = (i/nGrid)%nGrid;
+    G4double fx = nGrid>1 ? 2.*gx/(nGrid-1)-1. : 0.;
+    G4double fy = nGrid>1 ? 2.*gy/(nGrid-1)-1. : 0.;
+    G4ThreeVector point(fx*halfWidth, fy*halfWidth, zStart);
+    G4ThreeVector direction = G4ThreeVector(-0.002*fx, -0.002*fy, 1.).unit();
+
+    navigator.LocateGlobalPointAndSetup(point, &direction, false, false);
+    G4int n = 0;
+    for ( ; n<maxStepsPerRay; ++n ) {
+      G4double safety = 0.;
+      G4double step = navigator.ComputeStep(point, direction, kInfinity, safety);
+      if ( step == kInfinity ) break;
+      if ( step <= 0. ) ++nZeroSteps;
+      point += step*direction;
+      navigator.SetGeometricallyLimitedStep();
+      ++nSteps;
+      if ( ! navigator.LocateGlobalPointAndSetup(point, &direction, true) ) break;
+    }
+    if ( n == maxStepsPerRay ) ++nStuck;
+  }
+  timer.Stop();
+
+  G4cout << ">>> Geantino scan, " << nRays << " rays in +-" << halfWidth/CLHEP::mm
+         << " mm <<<" << G4endl;
+  G4cout << "    physical volumes : " << G4PhysicalVolumeStore::GetInstance()->size() << G4endl;
+  G4cout << "    steps            : " << nSteps << " (" << G4double(nSteps)/nRays
+         << " per ray, " << nZeroSteps << " of zero length)" << G4endl;
+  if ( nStuck ) G4cout << "    stuck rays       : " << nStuck << G4endl;
+  if ( nSteps ) G4cout << "    navigation       : "
+                       << timer.GetRealElapsed()/nSteps*1.e9 << " ns/step" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
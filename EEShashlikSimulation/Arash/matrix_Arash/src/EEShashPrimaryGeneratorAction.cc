@@ -46,19 +46,7 @@
 G4double xBeamPos;
 G4double yBeamPos;
 G4int NPhotAct;
-G4int NPhotFib;
-G4int NPhotFib2;
-G4int NPhotFib3;
-G4int NPhotFib4;
 G4int fibreStart0;
-G4int fibre0;
-G4int fibre1;
-G4int fibre2;
-G4int fibre3;
-G4double EOpt_0;
-G4double EOpt_1;
-G4double EOpt_2;
-G4double EOpt_3;
 
 
 
@@ -205,19 +193,7 @@ void EEShashPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
   G4cout<<"xBeam:"<<xBeam<<" yBeam:"<<yBeam<<G4endl;
   NPhotAct=0;
-  NPhotFib=0;
-  NPhotFib2=0;
-  NPhotFib3=0;
-  NPhotFib4=0;
   fibreStart0=0;
-  fibre0=0;
-  fibre1=0;
-  fibre2=0;
-  fibre3=0;
-  EOpt_0=0;
-  EOpt_1=0;
-  EOpt_2=0;
-  EOpt_3=0;
   for(int i=0;i<nPhotonsForTiming;++i)  time_vector.push_back(-1);
 
   // Set gun position
@@ -34,6 +34,7 @@
 
 #include "EEShashRunAction.hh"
 #include "EEShashAnalysis.hh"
+#include "EEShashVolumeRoleTable.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
@@ -231,6 +232,10 @@ void EEShashRunAction::EndOfRunAction(const G4Run* /*run*/)
   analysisManager->Write();
   analysisManager->CloseFile();
 
+  // the workers end their run before the master
+  EEShashVolumeRoleTable::EndOfThreadRun();
+  if ( isMaster ) EEShashVolumeRoleTable::Print();
+
   //hitsFile_->cd();
   //hitsTree_->Write();
   //hitsFile_->Close();
@@ -2,6 +2,8 @@
 #include "common.h"
 #include "G4TransportationManager.hh"
 #include "G4PropagatorInField.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4OpProcessSubType.hh"
 
 #include "TMath.h"
 #include "CreateTree.h"
@@ -14,8 +16,6 @@ using namespace CLHEP;
 //G4double fibre2;
 //G4double fibre3;
 
-TRandom3* randomGen=new TRandom3;
-
 int to_int (string name)
 {
   int Result ; // int which will contain the result
@@ -44,6 +44,10 @@ SteppingAction::~SteppingAction ()
 
 void SteppingAction::UserSteppingAction (const G4Step * theStep)
 {
+  // per-step classification timed on the steps of the run (ROLEBENCH)
+  if( EEShashVolumeRoleTable::IsBenchmarking() )
+    fDetectorConstruction->GetRoleTable().RecordStep(theStep);
+
   G4Track* theTrack = theStep->GetTrack () ;
   G4int trackID = theTrack->GetTrackID();
   TrackInformation* theTrackInfo = (TrackInformation*)(theTrack->GetUserInformation());
@@ -57,14 +61,12 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
   //const G4ThreeVector & thePostPosition = thePostPoint->GetPosition () ;
   G4VPhysicalVolume * thePrePV = thePrePoint->GetPhysicalVolume () ;
     //G4VPhysicalVolume * thePostPV = thePostPoint->GetPhysicalVolume () ;
-  G4String thePrePVName = "" ; 
-  if ( thePrePV ) thePrePVName = thePrePV -> GetName () ;
-    //G4String thePostPVName = "" ; 
-    //if ( thePostPV ) thePostPVName = thePostPV -> GetName () ;
+  // volume roles come from the table built by the detector construction
+  EEShashVolumeRole theVertexRole = fDetectorConstruction->GetRole(theTrack->GetLogicalVolumeAtVertex());
 
   
   G4int nStep = theTrack -> GetCurrentStepNumber();
-  G4TouchableHandle theTouchable = thePrePoint->GetTouchableHandle();
+  //G4TouchableHandle theTouchable = thePrePoint->GetTouchableHandle();
   //G4TouchableHandle theTouchable = thePostPoint->GetTouchableHandle();
     
   //-------------
@@ -89,8 +91,8 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
 
 
  
-      G4int copyNo = theTouchable->GetCopyNumber();
-      G4int motherCopyNo = theTouchable->GetCopyNumber(1);
+      // fibre/grease/APD number of the pre-step volume, -1 elsewhere
+      G4int copyNo = fDetectorConstruction->GetFibreIndex(thePrePV);
 
   // optical photon
   if( particleType == G4OpticalPhoton::OpticalPhotonDefinition() )
@@ -102,19 +104,20 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
       
 
       //Let's just kill them before they bounce that much...
-      if( nStep>600 && theTrack->GetLogicalVolumeAtVertex()->GetName().contains("Act")){
+      if( nStep>600 && theVertexRole == kActVolume ){
 	//	theTrack->SetTrackStatus(fKillTrackAndSecondaries);
 	//	std::cout<<"mortacci Act"<<nStep<<" particle:"<<particleType->GetParticleName()<<" volume:"<<theTrack->GetLogicalVolumeAtVertex()->GetName()<<" id:"<<trackID<<" position:"<<global_x<<" "<<global_y<<" "<<global_z<<" energy:"<<theTrack->GetTotalEnergy()/eV<<std::endl;
 	theTrack->SetTrackStatus(fStopAndKill);
 
       }
 
-      G4String processName = theTrack->GetCreatorProcess()->GetProcessName();
+      // creator process by sub-type, avoids comparing process names
+      G4int processType = theTrack->GetCreatorProcess()->GetProcessSubType();
 
       //don't track cherenkov photons if they are outside quantum efficiency
       float lambdaLowCut=480*1.e-9;
       float lambdaUpCut=620*1.e-9;
-      if(nStep==1 && processName=="Cerenkov"){
+      if(nStep==1 && processType==fCerenkov){
 	float energy=theTrack->GetTotalEnergy()/eV;
 	float h = 6.62607004*pow(10,-34);
 	float c = 3*pow(10,8);
@@ -157,8 +160,8 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
 	}*/
   
   // count photons at production in cef3
-      if( ( theTrack->GetLogicalVolumeAtVertex()->GetName().contains("Act") ) &&
-	  (nStep == 1) && (processName == "Scintillation") )
+      if( ( theVertexRole == kActVolume ) &&
+	  (nStep == 1) && (processType == fScintillation) )
 	{
 	  // CreateTree::Instance()->tot_phot_sci += 1;
 	  // if( !propagateScintillation ) theTrack->SetTrackStatus(fKillTrackAndSecondaries);
@@ -167,8 +170,8 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
 	}
 
       //count photons entering in the fiber
-      if( ( theTrack->GetLogicalVolumeAtVertex()->GetName().contains("Core") ) &&
-	  (nStep == 1) && (processName == "OpWLS") )
+      if( ( theVertexRole == kFibreCoreVolume ) &&
+	  (nStep == 1) && (processType == fOpWLS) )
 	{
 	  // CreateTree::Instance()->tot_phot_sci += 1;
 	  // if( !propagateScintillation ) theTrack->SetTrackStatus(fKillTrackAndSecondaries);
@@ -176,173 +179,8 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
 	  if(copyNo==0) fibreStart0 +=1;
 	}
  
-   if(  theTouchable->GetVolume()->GetName().contains("Grease"))
-  {
-	  	  //EOpt_0+=theTrack->GetTotalEnergy()/eV;;
-	}
-      
       //----------------------------
-      // count photons at fiber exit
-      if(  thePrePVName.contains("Grease")&& copyNo==0 )	{
-
-    	float quantumEfficiency=0.25;//average value of qe //0.75
-	float mirroringGain=0.25;//mirroring a fibre at one end gives 25% light more (theoretical max is 50%)
-	
-	bool keepPhot=false;
-	float rndNum=randomGen->Uniform( 0.,1. );
-	if(rndNum<(quantumEfficiency*(1+mirroringGain)))keepPhot=true;
-	if(!keepPhot){
-	  theTrack->SetTrackStatus(fStopAndKill);
-	  return;
-	}
-
-    /*
-    // Default way of returning is simply MeV's
-    cout << "Doing theTrack->GetTotalEnergy():" << G4endl;
-    cout << "    theTrack->GetTotalEnergy() = " << theTrack->GetTotalEnergy() << G4endl;
-    cout << "    theTrack->GetMomentum() = " << theTrack->GetMomentum() << G4endl;
-    cout << "    1 eV = " << eV << G4endl;
-    cout << "    Added to EOpt = " << theTrack->GetTotalEnergy()/eV << G4endl;
-    */
-
-	EOpt_0+=theTrack->GetTotalEnergy()/eV;
-	CreateTree::Instance() -> Time_deposit.push_back(theTrack->GetGlobalTime()/nanosecond);
-	G4ThreeVector directionStart=theTrack->GetVertexPosition();//position at start point
-	CreateTree::Instance() -> Z_deposit.push_back(directionStart.z()/mm);
-	CreateTree::Instance() -> Theta_deposit.push_back(directionStart.theta());
-	if(processName=="OpWLS"){
-	  CreateTree::Instance() -> Process_deposit.push_back(1);
-     fibre0 += 1;
-	}else if(processName=="Scintillation"){
-	  CreateTree::Instance() -> Process_deposit.push_back(2);
-     NPhotFib +=1;
-	}else if(processName=="Cerenkov"){
-	  CreateTree::Instance() -> Process_deposit.push_back(3);
-	}else{
-	  CreateTree::Instance() -> Process_deposit.push_back(-1);
-	}
-
-
-
-
-
-      //std::cout << "EOpt_0 = " << EOpt_0 << std::endl;
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-      
-      if(  thePrePVName.contains("Grease")&& copyNo==1 )	{
-      
-  float quantumEfficiency=0.25;//average value of qe
-	float mirroringGain=0.25;//mirroring a fibre at one end gives 25% light more (theoretical max is 50%)
-	
-	bool keepPhot=false;
-	float rndNum=randomGen->Uniform( 0.,1. );
-	if(rndNum<(quantumEfficiency*(1+mirroringGain)))keepPhot=true;
-	if(!keepPhot){
-	  theTrack->SetTrackStatus(fStopAndKill);
-	  return;
-	}
-	EOpt_1+=theTrack->GetTotalEnergy()/eV;
-  CreateTree::Instance() -> Time_deposit.push_back(theTrack->GetGlobalTime()/nanosecond);
-	G4ThreeVector directionStart=theTrack->GetVertexPosition();//position at start point
-	CreateTree::Instance() -> Z_deposit.push_back(directionStart.z()/mm);
-	CreateTree::Instance() -> Theta_deposit.push_back(directionStart.theta());
-	if(processName=="OpWLS"){
-	  CreateTree::Instance() -> Process_deposit.push_back(4);
-	fibre1 += 1;
-	}else if(processName=="Scintillation"){
-	  CreateTree::Instance() -> Process_deposit.push_back(5);
-     NPhotFib2 +=1;
-	}else if(processName=="Cerenkov"){
-	  CreateTree::Instance() -> Process_deposit.push_back(6);
-	}else{
-	  CreateTree::Instance() -> Process_deposit.push_back(-1);
-	}
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-      
-      if(  thePrePVName.contains("Grease")&& copyNo==2 )	{
-  float quantumEfficiency=0.25;//average value of qe
-	float mirroringGain=0.25;//mirroring a fibre at one end gives 25% light more (theoretical max is 50%)
-	
-	bool keepPhot=false;
-	float rndNum=randomGen->Uniform( 0.,1. );
-	if(rndNum<(quantumEfficiency*(1+mirroringGain)))keepPhot=true;
-	if(!keepPhot){
-	  theTrack->SetTrackStatus(fStopAndKill);
-	  return;
-	}
-	EOpt_2+=theTrack->GetTotalEnergy()/eV;
-  CreateTree::Instance() -> Time_deposit.push_back(theTrack->GetGlobalTime()/nanosecond);
-	G4ThreeVector directionStart=theTrack->GetVertexPosition();//position at start point
-	CreateTree::Instance() -> Z_deposit.push_back(directionStart.z()/mm);
-	CreateTree::Instance() -> Theta_deposit.push_back(directionStart.theta());
-	if(processName=="OpWLS"){
-	  CreateTree::Instance() -> Process_deposit.push_back(7);
-	fibre2 += 1;
-	}else if(processName=="Scintillation"){
-	  CreateTree::Instance() -> Process_deposit.push_back(8);
-     NPhotFib3 +=1;
-	}else if(processName=="Cerenkov"){
-	  CreateTree::Instance() -> Process_deposit.push_back(9);
-	}else{
-	  CreateTree::Instance() -> Process_deposit.push_back(-1);
-	}
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-
-      if(  thePrePVName.contains("Grease")&& copyNo==3 )	{
-  float quantumEfficiency=0.25;//average value of qe
-	float mirroringGain=0.25;//mirroring a fibre at one end gives 25% light more (theoretical max is 50%)
-	
-	bool keepPhot=false;
-	float rndNum=randomGen->Uniform( 0.,1. );
-	if(rndNum<(quantumEfficiency*(1+mirroringGain)))keepPhot=true;
-	if(!keepPhot){
-	  theTrack->SetTrackStatus(fStopAndKill);
-	  return;
-	}
-	EOpt_3+=theTrack->GetTotalEnergy()/eV;
-  CreateTree::Instance() -> Time_deposit.push_back(theTrack->GetGlobalTime()/nanosecond);
-	G4ThreeVector directionStart=theTrack->GetVertexPosition();//position at start point
-	CreateTree::Instance() -> Z_deposit.push_back(directionStart.z()/mm);
-	CreateTree::Instance() -> Theta_deposit.push_back(directionStart.theta());
-	if(processName=="OpWLS"){
-	  CreateTree::Instance() -> Process_deposit.push_back(10);
-	fibre3 += 1;
-	}else if(processName=="Scintillation"){
-	  CreateTree::Instance() -> Process_deposit.push_back(11);
-     NPhotFib4 +=1;
-	}else if(processName=="Cerenkov"){
-	  CreateTree::Instance() -> Process_deposit.push_back(12);
-	}else{
-	  CreateTree::Instance() -> Process_deposit.push_back(-1);
-	}
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-      
-      
-      
-      if(  thePrePVName.contains("Grease") )
-	{
-	  	  //fibre2 += 1;
-	}
-      //------------------------------
-      // count photons at the detector
-      if(   thePrePVName.contains("Grease")&& motherCopyNo ==3 )  //same as if with the prePV == Fibre
-	{
-	  //	  fibre3 += 1;
-	  // if you do not want to kill a photon once it enters the detector, comment here below
-	  //  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-	}
+      // photons at fiber exit are counted by EEShashOpticalReadoutSD
       
       
       /*
@@ -407,12 +245,10 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
     
     
     //count particle in apd and get timing. done for just one fibre
-  if(theTrack->GetLogicalVolumeAtVertex()->GetName().contains("APD") && (nStep==1) && copyNo == 0){
+  if(theVertexRole == kAPDVolume && (nStep==1) && copyNo == 0){
     CreateTree::Instance() -> Time_deposit_APD.push_back(theTrack->GetGlobalTime()/nanosecond);
     CreateTree::Instance() ->nParticlesAPD++;
   }
     
   return ;
 }
-
-
@@ -38,6 +38,15 @@ class CreateTree
 
   float  xPosition;
   float  yPosition;
+
+  float  Fibre_0;
+  float  Fibre_1;
+  float  Fibre_2;
+  float  Fibre_3;
+  float  EOpt_0;
+  float  EOpt_1;
+  float  EOpt_2;
+  float  EOpt_3;
   
 
     
@@ -34,11 +34,8 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "MyMaterials.hh"
 #include "globals.hh"
+#include "EEShashVolumeRoleTable.hh"
 
-
-
-
-class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
 
 
@@ -68,6 +65,12 @@ public:
   virtual G4VPhysicalVolume* Construct();
   virtual void ConstructSDandField();
 
+  // volume-role table, valid once Construct() has been called
+  const EEShashVolumeRoleTable& GetRoleTable() const { return fRoleTable; }
+  inline EEShashVolumeRole GetRole(const G4LogicalVolume* lv) const;
+  inline EEShashVolumeRole GetRole(const G4VPhysicalVolume* pv) const;
+  inline G4int GetFibreIndex(const G4VPhysicalVolume* pv) const;
+
 private:
   // methods
   //
@@ -85,10 +88,31 @@ private:
     G4double fRotation;      // rotation of the detector compared to the beam
     G4double fZtraslation;   // traslation on the Z axis (done *before*) the rotation
 
+    EEShashVolumeRoleTable fRoleTable;  // role of each volume
 
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+inline EEShashVolumeRole
+EEShashDetectorConstruction::GetRole(const G4LogicalVolume* lv) const
+{
+  return fRoleTable.GetRole(lv);
+}
+
+inline EEShashVolumeRole
+EEShashDetectorConstruction::GetRole(const G4VPhysicalVolume* pv) const
+{
+  return fRoleTable.GetRole(pv);
+}
+
+inline G4int
+EEShashDetectorConstruction::GetFibreIndex(const G4VPhysicalVolume* pv) const
+{
+  return fRoleTable.GetFibreIndex(pv);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 #endif
 
@@ -35,6 +35,7 @@
 #include "G4UserEventAction.hh"
 
 #include "EEShashCalorHit.hh"
+#include "EEShashOpticalHit.hh"
 
 #include "globals.hh"
 
@@ -57,6 +58,8 @@ private:
   // methods
   EEShashCalorHitsCollection* GetHitsCollection(G4int hcID,
                                             const G4Event* event) const;
+  EEShashOpticalHitsCollection* GetOpticalHitsCollection(G4int hcID,
+                                            const G4Event* event) const;
   void PrintEventStatistics(G4double absEdep, G4double absTrackLength,
                             G4double actEdep, G4double actTrackLength,
 			    G4double bgoEdep, G4double bgoTrackLength,
@@ -76,6 +79,7 @@ private:
   G4int  fScint1HCID;
   G4int  fHodo11HCID;
   G4int  fHodo12HCID;
+  G4int  fOpticalHCID;
   
 };
                      
@@ -1,15 +1,8 @@
 #include <vector>
 extern double xBeamPos;
 extern double yBeamPos;
-extern int fibre0;
 extern int fibreStart0;
 extern int  NPhotAct;
-extern int fibre1;
-extern int fibre2;
-extern int fibre3;
-extern double EOpt_0;
-extern double EOpt_1;
-extern double EOpt_2;
-extern double EOpt_3;
+const int nMaxFibres = 4;  // number of read out fibres
 extern int nPhotonsForTiming;
 extern std::vector<float> time_vector;
@@ -233,6 +233,12 @@ int main(int argc,char** argv)
   // Initialize G4 kernel
   //
   runManager->Initialize();
+
+  // Optional timing of the per-step volume classification on the steps of
+  // the run, replayed every <nSteps> steps (ROLEBENCH=<nSteps>)
+  if( std::getenv("ROLEBENCH") ) {
+    EEShashVolumeRoleTable::SetBenchmark(atoi(std::getenv("ROLEBENCH")));
+  }
   
 #ifdef G4VIS_USE
   // Initialize visualization
@@ -34,6 +34,15 @@ CreateTree::CreateTree(TString name)
   this->GetTree()->Branch("xPosition",&this->xPosition,"xPosition/F");
   this->GetTree()->Branch("yPosition",&this->yPosition,"yPosition/F");
 
+  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/F");
+  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/F");
+  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/F");
+  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/F");
+  this->GetTree()->Branch("EOpt_0",&this->EOpt_0,"EOpt_0/F");
+  this->GetTree()->Branch("EOpt_1",&this->EOpt_1,"EOpt_1/F");
+  this->GetTree()->Branch("EOpt_2",&this->EOpt_2,"EOpt_2/F");
+  this->GetTree()->Branch("EOpt_3",&this->EOpt_3,"EOpt_3/F");
+
 
 
 
@@ -70,4 +79,13 @@ void CreateTree::Clear()
   Eact_CentralXtal=0.;
   Eabs_CentralXtal=0.;
 
+  Fibre_0=0;
+  Fibre_1=0;
+  Fibre_2=0;
+  Fibre_3=0;
+  EOpt_0=0;
+  EOpt_1=0;
+  EOpt_2=0;
+  EOpt_3=0;
+
 }
@@ -29,6 +29,7 @@
 
 #include "EEShashDetectorConstruction.hh"
 #include "EEShashCalorimeterSD.hh"
+#include "EEShashOpticalReadoutSD.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
@@ -96,7 +97,12 @@ G4VPhysicalVolume* EEShashDetectorConstruction::Construct()
   DefineMaterials();
   
   // Define volumes
-  return DefineVolumes();
+  G4VPhysicalVolume* worldPV = DefineVolumes();
+
+  // Classify the volumes once for the stepping action
+  fRoleTable.Build();
+
+  return worldPV;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -510,9 +516,7 @@ void EEShashDetectorConstruction::DefineMaterials()
  // mptCeF->AddProperty ("RINDEX", PhotonEnergy_RI, refractiveIndex_CeF3, nEntries_RI)->SetSpline(true);
  //mptCeF->AddProperty ("ABSLENGTH", PhotonEnergy_ABS, Absorption, nEntries_ABS);
  
- // mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);//this should be 1000./MeV 
- //test
- mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 6./MeV);//this should be 1000./MeV 
+ mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);
  mptCeF->AddConstProperty ("RESOLUTIONSCALE", 1);
  // mptCeF->AddConstProperty ("RESOLUTIONSCALE", 2.58);
  mptCeF->AddConstProperty ("FASTTIMECONSTANT", 32.5 *ns);
@@ -2030,6 +2034,10 @@ void EEShashDetectorConstruction::ConstructSDandField()
   EEShashCalorimeterSD* fibrSDClad 
     = new EEShashCalorimeterSD("FibrSDClad", "FibrHitsCollectionClad", 4,-1);
   SetSensitiveDetector("FibreCladLV",fibrSDClad);
+  // and the photons reaching the grease at the fibre ends
+  EEShashOpticalReadoutSD* opticalSD
+    = new EEShashOpticalReadoutSD("OpticalSD", "OpticalHitsCollection", 4);
+  SetSensitiveDetector("GreaseLV",opticalSD);
 
 
   /*
@@ -39,6 +39,7 @@
 #include "G4SDManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
 
 #include "Randomize.hh"
 #include <iomanip>
@@ -53,7 +54,8 @@ EEShashEventAction::EEShashEventAction()
    fActHCID(-1),
    fBgoHCID(-1),
    fFibrHCIDCore(-1),
-   fFibrHCIDClad(-1)
+   fFibrHCIDClad(-1),
+   fOpticalHCID(-1)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -83,6 +85,26 @@ EEShashEventAction::GetHitsCollection(G4int hcID,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+EEShashOpticalHitsCollection* 
+EEShashEventAction::GetOpticalHitsCollection(G4int hcID,
+                                  const G4Event* event) const
+{
+  EEShashOpticalHitsCollection* hitsCollection 
+    = static_cast<EEShashOpticalHitsCollection*>(
+        event->GetHCofThisEvent()->GetHC(hcID));
+  
+  if ( ! hitsCollection ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot access hitsCollection ID " << hcID; 
+    G4Exception("EEShashEventAction::GetOpticalHitsCollection()",
+      "MyCode0003", FatalException, msg);
+  }         
+
+  return hitsCollection;
+}    
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void EEShashEventAction::PrintEventStatistics(
                               G4double absEdep, G4double absTrackLength,
                               G4double actEdep, G4double actTrackLength,
@@ -165,6 +187,8 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
       = G4SDManager::GetSDMpointer()->GetCollectionID("FibrHitsCollectionCore");
     fFibrHCIDClad 
       = G4SDManager::GetSDMpointer()->GetCollectionID("FibrHitsCollectionClad");
+    fOpticalHCID
+      = G4SDManager::GetSDMpointer()->GetCollectionID("OpticalHitsCollection");
 
     /*    fScint1HCID 
       = G4SDManager::GetSDMpointer()->GetCollectionID("Scint1HitsCollection");
@@ -189,6 +213,7 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   EEShashCalorHitsCollection* bgoHC = GetHitsCollection(fBgoHCID, event);
   EEShashCalorHitsCollection* fibrHCCore = GetHitsCollection(fFibrHCIDCore, event);
   EEShashCalorHitsCollection* fibrHCClad = GetHitsCollection(fFibrHCIDClad, event);
+  EEShashOpticalHitsCollection* opticalHC = GetOpticalHitsCollection(fOpticalHCID, event);
   // EEShashCalorHitsCollection* scint1HC = GetHitsCollection(fScint1HCID, event);
   // EEShashCalorHitsCollection* hodo11HC = GetHitsCollection(fHodo11HCID, event);
   //  EEShashCalorHitsCollection* hodo12HC = GetHitsCollection(fHodo12HCID, event);
@@ -210,6 +235,20 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   // EEShashCalorHit* hodo11Hit = (*hodo11HC)[hodo11HC->entries()-1];
   // EEShashCalorHit* hodo12Hit = (*hodo12HC)[hodo11HC->entries()-1];
  
+  // Sum the photons detected at the end of each fibre
+  G4int fibre[nMaxFibres];
+  G4double EOpt[nMaxFibres];
+  for( int i=0; i<nMaxFibres; ++i ) {
+    fibre[i] = 0;
+    EOpt[i] = 0.;
+  }
+  for( G4int i=0; i<opticalHC->entries(); ++i ) {
+    EEShashOpticalHit* opticalHit = (*opticalHC)[i];
+    G4int iFibre = opticalHit->GetFibre();
+    EOpt[iFibre] += opticalHit->GetEnergy()/eV;
+    fibre[iFibre] += 1;
+  }
+ 
   // Print per event (modulo n)
   //
   G4int eventID = event->GetEventID();
@@ -269,6 +308,15 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   CreateTree::Instance() -> xPosition = xBeamPos;
   CreateTree::Instance() -> yPosition = yBeamPos;
 
+  CreateTree::Instance() -> Fibre_0 = fibre[0];
+  CreateTree::Instance() -> Fibre_1 = fibre[1];
+  CreateTree::Instance() -> Fibre_2 = fibre[2];
+  CreateTree::Instance() -> Fibre_3 = fibre[3];
+  CreateTree::Instance() -> EOpt_0 = EOpt[0];
+  CreateTree::Instance() -> EOpt_1 = EOpt[1];
+  CreateTree::Instance() -> EOpt_2 = EOpt[2];
+  CreateTree::Instance() -> EOpt_3 = EOpt[3];
+
   CreateTree::Instance()->Fill(); 
   
 }  
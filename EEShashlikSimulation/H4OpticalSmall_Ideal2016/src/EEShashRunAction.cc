@@ -34,6 +34,7 @@
 
 #include "EEShashRunAction.hh"
 #include "EEShashAnalysis.hh"
+#include "EEShashVolumeRoleTable.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
@@ -149,7 +150,9 @@ void EEShashRunAction::EndOfRunAction(const G4Run* /*run*/)
       << G4BestUnit(analysisManager->GetH1(4)->rms(),  "Length") << G4endl;
   }
 
-
+  // the workers end their run before the master
+  EEShashVolumeRoleTable::EndOfThreadRun();
+  if ( isMaster ) EEShashVolumeRoleTable::Print();
 
 }
 
@@ -2,6 +2,8 @@
 #include "common.h"
 #include "G4TransportationManager.hh"
 #include "G4PropagatorInField.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4OpProcessSubType.hh"
 
 #include "TMath.h"
 #include "CreateTree.h"
@@ -42,6 +44,10 @@ SteppingAction::~SteppingAction ()
 
 void SteppingAction::UserSteppingAction (const G4Step * theStep)
 {
+  // per-step classification timed on the steps of the run (ROLEBENCH)
+  if( EEShashVolumeRoleTable::IsBenchmarking() )
+    fDetectorConstruction->GetRoleTable().RecordStep(theStep);
+
   G4Track* theTrack = theStep->GetTrack () ;
   G4int trackID = theTrack->GetTrackID();
   TrackInformation* theTrackInfo = (TrackInformation*)(theTrack->GetUserInformation());
@@ -54,14 +60,12 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
   const G4ThreeVector & thePrePosition = thePrePoint->GetPosition () ;
   G4VPhysicalVolume * thePrePV = thePrePoint->GetPhysicalVolume () ;
   //  G4VPhysicalVolume * thePostPV = thePostPoint->GetPhysicalVolume () ;
-  G4String thePrePVName = "" ; 
-  if ( thePrePV ) thePrePVName = thePrePV -> GetName () ;
-  //  G4String thePostPVName = "" ; 
-  //  if ( thePostPV ) thePostPVName = thePostPV -> GetName () ;
+  // volume roles come from the table built by the detector construction
+  EEShashVolumeRole theVertexRole = fDetectorConstruction->GetRole(theTrack->GetLogicalVolumeAtVertex());
 
   
   G4int nStep = theTrack -> GetCurrentStepNumber();
-  G4TouchableHandle theTouchable = thePrePoint->GetTouchableHandle();
+  //G4TouchableHandle theTouchable = thePrePoint->GetTouchableHandle();
     
   //-------------
   // get position
@@ -88,26 +92,24 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
   if( particleType == G4OpticalPhoton::OpticalPhotonDefinition() )
     {
       
-      G4int copyNo = theTouchable->GetCopyNumber();
-      G4int motherCopyNo = theTouchable->GetCopyNumber(1);
-
 
 
 
       //FUCK IT Let's just kill them before they bounce that much...
-      if( nStep>6 && theTrack->GetLogicalVolumeAtVertex()->GetName().contains("Act")){
+      if( nStep>6 && theVertexRole == kActVolume ){
 	//	theTrack->SetTrackStatus(fKillTrackAndSecondaries);
 	//	std::cout<<"mortacci Act"<<nStep<<" particle:"<<particleType->GetParticleName()<<" volume:"<<theTrack->GetLogicalVolumeAtVertex()->GetName()<<" id:"<<trackID<<" position:"<<global_x<<" "<<global_y<<" "<<global_z<<" energy:"<<theTrack->GetTotalEnergy()/eV<<std::endl;
 	theTrack->SetTrackStatus(fStopAndKill);
 
       }
 
-      G4String processName = theTrack->GetCreatorProcess()->GetProcessName();
+      // creator process by sub-type, avoids comparing process names
+      G4int processType = theTrack->GetCreatorProcess()->GetProcessSubType();
 
       //don't track cherenkov photons if they are outside quantum efficiency
       float lambdaLowCut=480*1.e-9;
       float lambdaUpCut=620*1.e-9;
-      if(nStep==1 && processName=="Cerenkov"){
+      if(nStep==1 && processType==fCerenkov){
 	float energy=theTrack->GetTotalEnergy()/eV;
 	float h = 6.62607004*pow(10,-34);
 	float c = 3*pow(10,8);
@@ -140,8 +142,8 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
 
       //----------------------------
       // count photons at production in cef3
-      if( ( theTrack->GetLogicalVolumeAtVertex()->GetName().contains("Act") ) &&
-	  (nStep == 1) && (processName == "Scintillation") )
+      if( ( theVertexRole == kActVolume ) &&
+	  (nStep == 1) && (processType == fScintillation) )
 	{
 	  // CreateTree::Instance()->tot_phot_sci += 1;
 	  // if( !propagateScintillation ) theTrack->SetTrackStatus(fKillTrackAndSecondaries);
@@ -150,8 +152,8 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
 	}
 
       //count photons entering in the fiber
-      if( ( theTrack->GetLogicalVolumeAtVertex()->GetName().contains("Core") ) &&
-	  (nStep == 1) && (processName == "OpWLS") )
+      if( ( theVertexRole == kFibreCoreVolume ) &&
+	  (nStep == 1) && (processType == fOpWLS) )
 	{
 	  // CreateTree::Instance()->tot_phot_sci += 1;
 	  // if( !propagateScintillation ) theTrack->SetTrackStatus(fKillTrackAndSecondaries);
@@ -161,73 +163,7 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
       
       
       //----------------------------
-      // count photons at fiber exit
-      if(  thePrePVName.contains("Grease")&& copyNo==0 )	{
-
-    /*
-    // Default way of returning is simply MeV's
-    cout << "Doing theTrack->GetTotalEnergy():" << G4endl;
-    cout << "    theTrack->GetTotalEnergy() = " << theTrack->GetTotalEnergy() << G4endl;
-    cout << "    theTrack->GetMomentum() = " << theTrack->GetMomentum() << G4endl;
-    cout << "    1 eV = " << eV << G4endl;
-    cout << "    Added to EOpt = " << theTrack->GetTotalEnergy()/eV << G4endl;
-    */
-
-	EOpt_0+=theTrack->GetTotalEnergy()/eV;
-	G4ThreeVector directionStart=theTrack->GetVertexPosition();//position at start point
-	if(processName=="OpWLS"){
-	}else if(processName=="Scintillation"){
-	}else if(processName=="Cerenkov"){
-	}else{
-	}
-
-	fibre0 += 1;
-
-
-      //std::cout << "EOpt_0 = " << EOpt_0 << std::endl;
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-      
-      if(  thePrePVName.contains("Grease")&& copyNo==1 )	{
-	EOpt_1+=theTrack->GetTotalEnergy()/eV;
-	fibre1 += 1;
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-      
-      if(  thePrePVName.contains("Grease")&& copyNo==2 )	{
-	EOpt_2+=theTrack->GetTotalEnergy()/eV;
-	fibre2 += 1;
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-
-      if(  thePrePVName.contains("Grease")&& copyNo==3 )	{
-	EOpt_3+=theTrack->GetTotalEnergy()/eV;
-	fibre3 += 1;
-	//	  CreateTree::Instance()->tot_gap_phot_sci += 1;
-	// if you do not want to kill a photon once it exits the fiber, comment here below
-	//  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-      }
-      
-      
-      
-      if(  thePrePVName.contains("Grease") )
-	{
-	  //	  fibre2 += 1;
-	}
-      //------------------------------
-      // count photons at the detector
-      if(   thePrePVName.contains("Grease")&& motherCopyNo ==3 )  //same as if with the prePV == Fibre
-	{
-	  //	  fibre3 += 1;
-	  // if you do not want to kill a photon once it enters the detector, comment here below
-	  //  theTrack->SetTrackStatus(fKillTrackAndSecondaries);
-	}
+      // photons at fiber exit are counted by EEShashOpticalReadoutSD
       
       
       /*
@@ -291,5 +227,3 @@ void SteppingAction::UserSteppingAction (const G4Step * theStep)
     } // non optical photon
   return ;
 }
-
-
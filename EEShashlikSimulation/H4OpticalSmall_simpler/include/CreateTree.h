@@ -32,17 +32,17 @@ class CreateTree
   std::vector<int> opPhoton_process;
   float  Eabs;
   float  Eact;
-  int    NPhot_Act;
+  float  NPhot_Act;
   float  EfibrCore;
   float  EfibrClad;
   int    nLayers;
 
-  int   Fibre_start_0;
+  float Fibre_start_0;
 
-  int   Fibre_0;
-  int   Fibre_1;
-  int   Fibre_2;
-  int   Fibre_3;
+  float Fibre_0;
+  float Fibre_1;
+  float Fibre_2;
+  float Fibre_3;
 
   float  xPosition;
   float  yPosition;
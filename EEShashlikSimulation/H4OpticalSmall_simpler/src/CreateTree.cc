@@ -26,17 +26,17 @@ CreateTree::CreateTree(TString name)
   this->GetTree()->Branch("opPhoton_process",&this->opPhoton_process);    
   this->GetTree()->Branch("Eabs",&this->Eabs,"Eabs/F");
   this->GetTree()->Branch("Eact",&this->Eact,"Eact/F");
-  this->GetTree()->Branch("NPhot_Act",&this->NPhot_Act,"NPhot_Act/I");
+  this->GetTree()->Branch("NPhot_Act",&this->NPhot_Act,"NPhot_Act/F");
   this->GetTree()->Branch("EfibrCore",&this->EfibrCore,"EfibrCore/F");
   this->GetTree()->Branch("EfibrClad",&this->EfibrClad,"EfibrClad/F");
   this->GetTree()->Branch("nLayers",&this->nLayers,"nLayers/I");
 
-  this->GetTree()->Branch("Fibre_start_0",&this->Fibre_start_0,"Fibre_start_0/I");
+  this->GetTree()->Branch("Fibre_start_0",&this->Fibre_start_0,"Fibre_start_0/F");
 
-  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/I");
-  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/I");
-  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/I");
-  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/I");
+  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/F");
+  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/F");
+  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/F");
+  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/F");
 
   this->GetTree()->Branch("xPosition",&this->xPosition,"xPosition/F");
   this->GetTree()->Branch("yPosition",&this->yPosition,"yPosition/F");
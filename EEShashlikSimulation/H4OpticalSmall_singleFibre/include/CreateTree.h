@@ -35,10 +35,10 @@ class CreateTree
   float  EfibrClad;
   int    nLayers;
 
-  int   Fibre_0;
-  int   Fibre_1;
-  int   Fibre_2;
-  int   Fibre_3;
+  float Fibre_0;
+  float Fibre_1;
+  float Fibre_2;
+  float Fibre_3;
 
   float  xPosition;
   float  yPosition;
@@ -29,10 +29,10 @@ CreateTree::CreateTree(TString name)
   this->GetTree()->Branch("EfibrClad",&this->EfibrClad,"EfibrClad/F");
   this->GetTree()->Branch("nLayers",&this->nLayers,"nLayers/I");
 
-  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/I");
-  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/I");
-  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/I");
-  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/I");
+  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/F");
+  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/F");
+  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/F");
+  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/F");
 
   this->GetTree()->Branch("xPosition",&this->xPosition,"xPosition/F");
   this->GetTree()->Branch("yPosition",&this->yPosition,"yPosition/F");
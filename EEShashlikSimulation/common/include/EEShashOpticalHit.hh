@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalHit.hh
+/// \brief Definition of the EEShashOpticalHit class
+
+#ifndef EEShashOpticalHit_h
+#define EEShashOpticalHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4ThreeVector.hh"
+#include "tls.hh"
+
+/// Optical readout hit class
+///
+/// One hit per optical photon detected at the end of a fibre. It stores
+/// the fibre number, the photon energy and arrival time, the position and
+/// polar angle of the photon vertex, the process that created it and the
+/// statistical weight of the photon (1 unless the variant thins photons):
+/// - fFibre, fEnergy, fTime, fVertexZ, fVertexTheta, fProcess, fWeight
+
+class EEShashOpticalHit : public G4VHit
+{
+  public:
+    // creator process codes, as written to the ntuple
+    enum { kOther = -1, kWLS = 1, kScintillation = 2, kCerenkov = 3 };
+
+    EEShashOpticalHit();
+    EEShashOpticalHit(G4int fibre, G4double energy, G4double time,
+                      G4double vertexZ, G4double vertexTheta, G4int process,
+                      G4double weight = 1.);
+    EEShashOpticalHit(const EEShashOpticalHit&);
+    virtual ~EEShashOpticalHit();
+
+    // operators
+    const EEShashOpticalHit& operator=(const EEShashOpticalHit&);
+    G4int operator==(const EEShashOpticalHit&) const;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    // methods from base class
+    virtual void Draw() {}
+    virtual void Print();
+
+    // get methods
+    G4int    GetFibre() const       { return fFibre; }
+    G4double GetEnergy() const      { return fEnergy; }
+    G4double GetTime() const        { return fTime; }
+    G4double GetVertexZ() const     { return fVertexZ; }
+    G4double GetVertexTheta() const { return fVertexTheta; }
+    G4int    GetProcess() const     { return fProcess; }
+    G4double GetWeight() const      { return fWeight; }
+
+  private:
+    G4int    fFibre;       ///< Copy number of the readout (grease) volume
+    G4double fEnergy;      ///< Photon energy
+    G4double fTime;        ///< Global time at the readout
+    G4double fVertexZ;     ///< z of the photon vertex
+    G4double fVertexTheta; ///< theta of the photon vertex position
+    G4int    fProcess;     ///< Creator process code
+    G4double fWeight;      ///< Statistical weight of the photon
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+typedef G4THitsCollection<EEShashOpticalHit> EEShashOpticalHitsCollection;
+
+extern G4ThreadLocal G4Allocator<EEShashOpticalHit>* EEShashOpticalHitAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* EEShashOpticalHit::operator new(size_t)
+{
+  if(!EEShashOpticalHitAllocator)
+    EEShashOpticalHitAllocator = new G4Allocator<EEShashOpticalHit>;
+  void *hit;
+  hit = (void *) EEShashOpticalHitAllocator->MallocSingle();
+  return hit;
+}
+
+inline void EEShashOpticalHit::operator delete(void *hit)
+{
+  if(!EEShashOpticalHitAllocator)
+    EEShashOpticalHitAllocator = new G4Allocator<EEShashOpticalHit>;
+  EEShashOpticalHitAllocator->FreeSingle((EEShashOpticalHit*) hit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,118 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalReadoutSD.hh
+/// \brief Definition of the EEShashOpticalReadoutSD class
+
+#ifndef EEShashOpticalReadoutSD_h
+#define EEShashOpticalReadoutSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+
+#include "EEShashOpticalHit.hh"
+
+class G4Step;
+class G4Track;
+class G4HCofThisEvent;
+class G4PhysicsOrderedFreeVector;
+
+/// Optical readout sensitive detector class
+///
+/// Attached to the grease volumes at the end of the fibres. In ProcessHits()
+/// every optical photon entering a grease volume is accepted with the
+/// probability GetAcceptance(energy): the tabulated photodetector QE, if
+/// any, times fAcceptance (mirroring gain). Accepted photons are stored as
+/// one EEShashOpticalHit, all of them are then killed. Other particles are
+/// ignored. AddPhoton() applies the same acceptance to photons which were
+/// not tracked to the grease, e.g. by EEShashFibreFastModel.
+///
+/// The class is shared by the simulation variants (common/). A variant which
+/// weights its photons, or plays the acceptance elsewhere, overrides
+/// PhotonArrived(); by default every photon has weight 1 and is subject to
+/// the acceptance here.
+///
+/// With SetQEAtBirth(true) the variant keeps each WLS photon at birth with
+/// the constant probability GetMaxAcceptance(), the largest acceptance at
+/// any energy (EEShashStackingAction in single_simple). The survivors, and
+/// their own re-emissions, are flagged as preselected and are accepted here
+/// with GetAcceptance(energy)/GetMaxAcceptance() at the energy they arrive
+/// with. The product is the acceptance at the last emission, and no photon
+/// is lost at birth for being out of the QE window since the birth
+/// probability does not depend on the energy.
+
+class EEShashOpticalReadoutSD : public G4VSensitiveDetector
+{
+  public:
+    EEShashOpticalReadoutSD(const G4String& name, 
+                            const G4String& hitsCollectionName, 
+                            G4int nofFibres,
+                            G4double acceptance = 1.);
+    virtual ~EEShashOpticalReadoutSD();
+  
+    // methods from base class
+    virtual void   Initialize(G4HCofThisEvent* hitCollection);
+    virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
+    virtual void   EndOfEvent(G4HCofThisEvent* hitCollection);
+
+    // record a photon at the end of a fibre, subject to the acceptance
+    // (preselected: kept at birth with GetMaxAcceptance())
+    G4bool AddPhoton(G4int fibre, G4double energy, G4double time,
+                     G4double vertexZ, G4double vertexTheta, G4int process,
+                     G4double weight = 1., G4bool preselected = false);
+
+    void     SetAcceptance(G4double acceptance);
+    G4double GetAcceptance() const { return fAcceptance; }
+    // acceptance of a photon of the given energy, at most 1
+    G4double GetAcceptance(G4double energy) const;
+    // largest acceptance at any energy, at most 1
+    G4double GetMaxAcceptance() const { return fMaxAcceptance; }
+
+    // quantum efficiency vs photon energy, owned by the SD
+    void SetQuantumEfficiency(G4PhysicsOrderedFreeVector* qe);
+
+    void   SetQEAtBirth(G4bool value) { fQEAtBirth = value; }
+    G4bool GetQEAtBirth() const { return fQEAtBirth; }
+
+  protected:
+    // called for every optical photon reaching a fibre end, before the
+    // acceptance: sets its statistical weight and whether it was
+    // preselected at birth
+    virtual void PhotonArrived(const G4Track* track, G4double& weight,
+                               G4bool& preselected);
+
+  private:
+    void UpdateMaxAcceptance();
+
+    EEShashOpticalHitsCollection* fHitsCollection;
+    G4int     fNofFibres;
+    G4double  fAcceptance;
+    G4PhysicsOrderedFreeVector* fQE;
+    G4double  fMaxAcceptance;
+    G4bool    fQEAtBirth;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
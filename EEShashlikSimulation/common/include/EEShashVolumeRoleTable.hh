@@ -0,0 +1,143 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashVolumeRoleTable.hh
+/// \brief Definition of the EEShashVolumeRoleTable class
+
+#ifndef EEShashVolumeRoleTable_h
+#define EEShashVolumeRoleTable_h 1
+
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4String.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Step;
+
+/// Role of a volume for the optical photon bookkeeping in SteppingAction.
+/// Roles are assigned once, from the volume names, when the geometry is
+/// built, so that no string matching is needed while stepping.
+enum EEShashVolumeRole {
+  kOtherVolume = 0,
+  kActVolume,        // CeF3 tiles (ActLV, ActLV2, ActLV3)
+  kFibreCoreVolume,  // WLS fibre core
+  kGreaseVolume,     // optical grease at the fibre end (readout)
+  kAPDVolume         // APD behind the grease
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Role of every logical and physical volume, and fibre index of the
+/// physical volumes, indexed by the instance ID of the volume
+///
+/// Built by the detector construction of each setup at the end of
+/// Construct(), from the volume stores.
+///
+/// With ROLEBENCH=<steps> in main, the stepping action passes each real
+/// step to RecordStep(), which keeps the pre-step volume and the vertex
+/// volume of the track. Every <steps> steps, and at the end of the run of
+/// the thread, the kept steps are classified again, once with the string
+/// matching the stepping action used before the table and once with the
+/// table, each timed as a whole. Print() gives the time per step of both
+/// and whether they agree, summed over the threads.
+
+class EEShashVolumeRoleTable
+{
+  public:
+    EEShashVolumeRoleTable();
+
+    void Build();
+
+    inline EEShashVolumeRole GetRole(const G4LogicalVolume* lv) const;
+    inline EEShashVolumeRole GetRole(const G4VPhysicalVolume* pv) const;
+    inline G4int GetFibreIndex(const G4VPhysicalVolume* pv) const;
+
+    // benchmark of the classification on the steps of the run
+    static void SetBenchmark(G4int nSteps);
+    static G4bool IsBenchmarking() { return fBenchmarkSteps > 0; }
+    void RecordStep(const G4Step* step) const;
+
+    // from EEShashRunAction::EndOfRunAction(): each thread merges its
+    // timing, the master then prints it
+    static void EndOfThreadRun();
+    static void Print();
+
+  private:
+    static EEShashVolumeRole RoleFromName(const G4String& name);
+
+    struct Benchmark {
+      Benchmark() : fTable(0), fSteps(0), fStringTime(0.), fTableTime(0.),
+                    fSameAnswer(true) {}
+      const EEShashVolumeRoleTable* fTable;
+      std::vector<const G4VPhysicalVolume*> fPrePV;
+      std::vector<const G4LogicalVolume*>   fVertexLV;
+      G4long   fSteps;       // steps replayed
+      G4double fStringTime;  // CPU time [s] of the string matching
+      G4double fTableTime;   // CPU time [s] of the table lookups
+      G4bool   fSameAnswer;
+    };
+    static void Replay(Benchmark& benchmark);
+
+    // indexed by G4LogicalVolume/G4VPhysicalVolume::GetInstanceID()
+    std::vector<G4int> fLVRole;    // role of each logical volume
+    std::vector<G4int> fPVRole;    // role of each physical volume
+    std::vector<G4int> fPVFibre;   // fibre index (copy number), -1 if none
+
+    static G4int fBenchmarkSteps;
+    static G4ThreadLocal Benchmark* fBenchmark;
+    static Benchmark fMerged;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline EEShashVolumeRole
+EEShashVolumeRoleTable::GetRole(const G4LogicalVolume* lv) const
+{
+  if ( ! lv ) return kOtherVolume;
+  size_t id = lv->GetInstanceID();
+  return id < fLVRole.size() ? EEShashVolumeRole(fLVRole[id]) : kOtherVolume;
+}
+
+inline EEShashVolumeRole
+EEShashVolumeRoleTable::GetRole(const G4VPhysicalVolume* pv) const
+{
+  if ( ! pv ) return kOtherVolume;
+  size_t id = pv->GetInstanceID();
+  return id < fPVRole.size() ? EEShashVolumeRole(fPVRole[id]) : kOtherVolume;
+}
+
+inline G4int
+EEShashVolumeRoleTable::GetFibreIndex(const G4VPhysicalVolume* pv) const
+{
+  if ( ! pv ) return -1;
+  size_t id = pv->GetInstanceID();
+  return id < fPVFibre.size() ? fPVFibre[id] : -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,120 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalHit.cc
+/// \brief Implementation of the EEShashOpticalHit class
+
+#include "EEShashOpticalHit.hh"
+#include "G4UnitsTable.hh"
+
+#include <iomanip>
+
+G4ThreadLocal G4Allocator<EEShashOpticalHit>* EEShashOpticalHitAllocator = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalHit::EEShashOpticalHit()
+ : G4VHit(),
+   fFibre(-1),
+   fEnergy(0.),
+   fTime(0.),
+   fVertexZ(0.),
+   fVertexTheta(0.),
+   fProcess(kOther),
+   fWeight(1.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalHit::EEShashOpticalHit(G4int fibre, G4double energy,
+                                     G4double time, G4double vertexZ,
+                                     G4double vertexTheta, G4int process,
+                                     G4double weight)
+ : G4VHit(),
+   fFibre(fibre),
+   fEnergy(energy),
+   fTime(time),
+   fVertexZ(vertexZ),
+   fVertexTheta(vertexTheta),
+   fProcess(process),
+   fWeight(weight)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalHit::~EEShashOpticalHit() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalHit::EEShashOpticalHit(const EEShashOpticalHit& right)
+  : G4VHit()
+{
+  fFibre       = right.fFibre;
+  fEnergy      = right.fEnergy;
+  fTime        = right.fTime;
+  fVertexZ     = right.fVertexZ;
+  fVertexTheta = right.fVertexTheta;
+  fProcess     = right.fProcess;
+  fWeight      = right.fWeight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const EEShashOpticalHit& EEShashOpticalHit::operator=(const EEShashOpticalHit& right)
+{
+  fFibre       = right.fFibre;
+  fEnergy      = right.fEnergy;
+  fTime        = right.fTime;
+  fVertexZ     = right.fVertexZ;
+  fVertexTheta = right.fVertexTheta;
+  fProcess     = right.fProcess;
+  fWeight      = right.fWeight;
+
+  return *this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashOpticalHit::operator==(const EEShashOpticalHit& right) const
+{
+  return ( this == &right ) ? 1 : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalHit::Print()
+{
+  G4cout
+     << "Fibre: " << fFibre
+     << " energy: " 
+     << std::setw(7) << G4BestUnit(fEnergy,"Energy")
+     << " time: " 
+     << std::setw(7) << G4BestUnit(fTime,"Time")
+     << " process: " << fProcess
+     << " weight: " << fWeight
+     << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,202 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalReadoutSD.cc
+/// \brief Implementation of the EEShashOpticalReadoutSD class
+
+#include "EEShashOpticalReadoutSD.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4SDManager.hh"
+#include "G4PhysicsOrderedFreeVector.hh"
+#include "Randomize.hh"
+#include "G4ios.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalReadoutSD::EEShashOpticalReadoutSD(
+                            const G4String& name, 
+                            const G4String& hitsCollectionName,
+                            G4int nofFibres,
+                            G4double acceptance)
+ : G4VSensitiveDetector(name),
+   fHitsCollection(0),
+   fNofFibres(nofFibres),
+   fAcceptance(acceptance),
+   fQE(0),
+   fMaxAcceptance(1.),
+   fQEAtBirth(false)
+{
+  collectionName.insert(hitsCollectionName);
+  UpdateMaxAcceptance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalReadoutSD::~EEShashOpticalReadoutSD() 
+{ 
+  delete fQE;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalReadoutSD::SetQuantumEfficiency(
+                                G4PhysicsOrderedFreeVector* qe)
+{
+  delete fQE;
+  fQE = qe;
+  UpdateMaxAcceptance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalReadoutSD::SetAcceptance(G4double acceptance)
+{
+  fAcceptance = acceptance;
+  UpdateMaxAcceptance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalReadoutSD::UpdateMaxAcceptance()
+{
+  // the QE is linear between its points, so its maximum is at one of them
+  G4double qe = 1.;
+  if ( fQE ) {
+    qe = 0.;
+    for ( size_t i = 0; i < fQE->GetVectorLength(); ++i )
+      if ( (*fQE)[i] > qe ) qe = (*fQE)[i];
+  }
+  fMaxAcceptance = fAcceptance*qe < 1. ? fAcceptance*qe : 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashOpticalReadoutSD::GetAcceptance(G4double energy) const
+{
+  G4double acceptance = fAcceptance;
+  if ( fQE ) acceptance *= fQE->Value(energy);
+  return acceptance < 1. ? acceptance : 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalReadoutSD::Initialize(G4HCofThisEvent* hce)
+{
+  // Create hits collection
+  fHitsCollection 
+    = new EEShashOpticalHitsCollection(SensitiveDetectorName, collectionName[0]); 
+
+  // Add this collection in hce
+  G4int hcID 
+    = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+  hce->AddHitsCollection( hcID, fHitsCollection ); 
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashOpticalReadoutSD::ProcessHits(G4Step* step, 
+                                            G4TouchableHistory*)
+{  
+  G4Track* track = step->GetTrack();
+  if ( track->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition() )
+    return false;
+
+  // fibre number is the copy number of the grease volume
+  G4int fibre = step->GetPreStepPoint()->GetTouchable()->GetCopyNumber();
+  if ( fibre < 0 || fibre >= fNofFibres ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot access fibre " << fibre; 
+    G4Exception("EEShashOpticalReadoutSD::ProcessHits()",
+      "MyCode0005", JustWarning, msg);
+    return false;
+  }
+
+  // the photon ends here, whether it is detected or not
+  track->SetTrackStatus(fStopAndKill);
+
+  G4int process = EEShashOpticalHit::kOther;
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if ( creator ) {
+    G4int subType = creator->GetProcessSubType();
+    if      ( subType == fOpWLS )         process = EEShashOpticalHit::kWLS;
+    else if ( subType == fScintillation ) process = EEShashOpticalHit::kScintillation;
+    else if ( subType == fCerenkov )      process = EEShashOpticalHit::kCerenkov;
+  }
+
+  G4double weight = 1.;
+  G4bool preselected = false;
+  PhotonArrived(track, weight, preselected);
+
+  const G4ThreeVector& vertex = track->GetVertexPosition();
+  return AddPhoton(fibre, track->GetTotalEnergy(), track->GetGlobalTime(),
+                   vertex.z(), vertex.theta(), process, weight, preselected);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalReadoutSD::PhotonArrived(const G4Track*, G4double&,
+                                            G4bool&)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashOpticalReadoutSD::AddPhoton(G4int fibre, G4double energy,
+                                          G4double time, G4double vertexZ,
+                                          G4double vertexTheta, G4int process,
+                                          G4double weight, G4bool preselected)
+{
+  G4double acceptance = GetAcceptance(energy);
+  if ( preselected ) {
+    if ( fMaxAcceptance <= 0. ) return false;
+    acceptance /= fMaxAcceptance;
+  }
+  if ( G4UniformRand() >= acceptance ) return false;
+
+  fHitsCollection->insert(
+    new EEShashOpticalHit(fibre, energy, time, vertexZ, vertexTheta, process,
+                          weight));
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalReadoutSD::EndOfEvent(G4HCofThisEvent*)
+{
+  if ( verboseLevel>1 ) { 
+     G4int nofHits = fHitsCollection->entries();
+     G4cout << "\n-------->Hits Collection: in this event there are " << nofHits 
+            << " photons at the fibre ends: " << G4endl;
+     for ( G4int i=0; i<nofHits; i++ ) (*fHitsCollection)[i]->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,217 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashVolumeRoleTable.cc
+/// \brief Implementation of the EEShashVolumeRoleTable class
+
+#include "EEShashVolumeRoleTable.hh"
+
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <ctime>
+
+G4int EEShashVolumeRoleTable::fBenchmarkSteps = 0;
+G4ThreadLocal EEShashVolumeRoleTable::Benchmark* EEShashVolumeRoleTable::fBenchmark = 0;
+EEShashVolumeRoleTable::Benchmark EEShashVolumeRoleTable::fMerged;
+
+namespace {
+  G4Mutex roleTableMutex = G4MUTEX_INITIALIZER;
+
+  const G4int kReadoutFibres = 4;
+
+  G4double CPUTime()
+  {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + 1.e-9*now.tv_nsec;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashVolumeRoleTable::EEShashVolumeRoleTable()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashVolumeRole EEShashVolumeRoleTable::RoleFromName(const G4String& name)
+{
+  // same substrings the stepping action used to test on every step
+  if ( name.contains("Grease") ) return kGreaseVolume;
+  if ( name.contains("APD") )    return kAPDVolume;
+  if ( name.contains("Core") )   return kFibreCoreVolume;
+  if ( name.contains("Act") )    return kActVolume;
+  return kOtherVolume;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashVolumeRoleTable::Build()
+{
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  G4PhysicalVolumeStore* pvStore = G4PhysicalVolumeStore::GetInstance();
+
+  fLVRole.clear();
+  for ( size_t i=0; i<lvStore->size(); ++i ) {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    size_t id = lv->GetInstanceID();
+    if ( id >= fLVRole.size() ) fLVRole.resize(id+1, kOtherVolume);
+    fLVRole[id] = RoleFromName(lv->GetName());
+  }
+
+  fPVRole.clear();
+  fPVFibre.clear();
+  for ( size_t i=0; i<pvStore->size(); ++i ) {
+    G4VPhysicalVolume* pv = (*pvStore)[i];
+    size_t id = pv->GetInstanceID();
+    if ( id >= fPVRole.size() ) {
+      fPVRole.resize(id+1, kOtherVolume);
+      fPVFibre.resize(id+1, -1);
+    }
+    EEShashVolumeRole role = RoleFromName(pv->GetName());
+    fPVRole[id] = role;
+    // fibres, grease and APDs are numbered by their copy number
+    if ( role == kGreaseVolume || role == kFibreCoreVolume || role == kAPDVolume )
+      fPVFibre[id] = pv->GetCopyNo();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashVolumeRoleTable::SetBenchmark(G4int nSteps)
+{
+  fBenchmarkSteps = nSteps > 0 ? nSteps : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashVolumeRoleTable::RecordStep(const G4Step* step) const
+{
+  if ( ! fBenchmark ) {
+    fBenchmark = new Benchmark;
+    fBenchmark->fPrePV.reserve(fBenchmarkSteps);
+    fBenchmark->fVertexLV.reserve(fBenchmarkSteps);
+    fBenchmark->fTable = this;
+  }
+
+  fBenchmark->fPrePV.push_back(step->GetPreStepPoint()->GetPhysicalVolume());
+  fBenchmark->fVertexLV.push_back(step->GetTrack()->GetLogicalVolumeAtVertex());
+  if ( G4int(fBenchmark->fPrePV.size()) >= fBenchmarkSteps ) Replay(*fBenchmark);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashVolumeRoleTable::Replay(Benchmark& benchmark)
+{
+  size_t nSteps = benchmark.fPrePV.size();
+  if ( nSteps == 0 || ! benchmark.fTable ) return;
+  const EEShashVolumeRoleTable& table = *benchmark.fTable;
+
+  // what the stepping action did before the role table
+  G4int stringCounts[4] = {0,0,0,0};
+  G4double start = CPUTime();
+  for ( size_t i=0; i<nSteps; ++i ) {
+    const G4VPhysicalVolume* pv = benchmark.fPrePV[i];
+    const G4LogicalVolume* vertexLV = benchmark.fVertexLV[i];
+    G4String thePrePVName = "";
+    if ( pv ) thePrePVName = pv->GetName();
+    G4int copyNo = pv ? pv->GetCopyNo() : -1;
+    G4String vertexName = vertexLV ? vertexLV->GetName() : "";
+    if ( vertexName.contains("Act") ) stringCounts[0]++;
+    if ( vertexName.contains("Core") ) stringCounts[1]++;
+    if ( vertexName.contains("APD") ) stringCounts[2]++;
+    if ( thePrePVName.contains("Grease") && copyNo==0 ) stringCounts[3]++;
+    if ( thePrePVName.contains("Grease") && copyNo==1 ) stringCounts[3]++;
+    if ( thePrePVName.contains("Grease") && copyNo==2 ) stringCounts[3]++;
+    if ( thePrePVName.contains("Grease") && copyNo==3 ) stringCounts[3]++;
+  }
+  G4double middle = CPUTime();
+
+  G4int tableCounts[4] = {0,0,0,0};
+  for ( size_t i=0; i<nSteps; ++i ) {
+    const G4VPhysicalVolume* pv = benchmark.fPrePV[i];
+    EEShashVolumeRole vertexRole = table.GetRole(benchmark.fVertexLV[i]);
+    if ( vertexRole == kActVolume ) tableCounts[0]++;
+    if ( vertexRole == kFibreCoreVolume ) tableCounts[1]++;
+    if ( vertexRole == kAPDVolume ) tableCounts[2]++;
+    G4int copyNo = table.GetFibreIndex(pv);
+    if ( table.GetRole(pv) == kGreaseVolume && copyNo>=0 && copyNo<kReadoutFibres )
+      tableCounts[3]++;
+  }
+  G4double end = CPUTime();
+
+  benchmark.fSteps += nSteps;
+  benchmark.fStringTime += middle - start;
+  benchmark.fTableTime += end - middle;
+  for ( G4int i=0; i<4; ++i )
+    if ( stringCounts[i] != tableCounts[i] ) benchmark.fSameAnswer = false;
+
+  benchmark.fPrePV.clear();
+  benchmark.fVertexLV.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashVolumeRoleTable::EndOfThreadRun()
+{
+  if ( ! fBenchmark ) return;
+  Replay(*fBenchmark);
+
+  G4AutoLock lock(&roleTableMutex);
+  fMerged.fSteps += fBenchmark->fSteps;
+  fMerged.fStringTime += fBenchmark->fStringTime;
+  fMerged.fTableTime += fBenchmark->fTableTime;
+  fMerged.fSameAnswer = fMerged.fSameAnswer && fBenchmark->fSameAnswer;
+
+  delete fBenchmark;
+  fBenchmark = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashVolumeRoleTable::Print()
+{
+  if ( ! IsBenchmarking() ) return;
+
+  G4AutoLock lock(&roleTableMutex);
+  G4long nSteps = fMerged.fSteps;
+  G4cout << ">>> Volume classification benchmark, " << nSteps
+         << " steps of the run <<<" << G4endl;
+  if ( nSteps > 0 ) {
+    G4cout << "    string matching : " << fMerged.fStringTime/nSteps*1.e9
+           << " ns/step" << G4endl;
+    G4cout << "    role table      : " << fMerged.fTableTime/nSteps*1.e9
+           << " ns/step" << G4endl;
+    G4cout << "    same classification: "
+           << (fMerged.fSameAnswer ? "yes" : "NO") << G4endl;
+  }
+  fMerged = Benchmark();
+}
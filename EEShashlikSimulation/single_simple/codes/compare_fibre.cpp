@@ -0,0 +1,100 @@
+#include <iostream>
+#include <vector>
+#include "TFile.h"
+#include "TTree.h"
+#include "TMath.h"
+#include "string.h"
+using namespace std;
+// Closure of the fibre fast simulation against full optical tracking: a
+// sample simulated with FIBRE_FASTSIM, using the EEShashFibreTable filled by
+// FIBRE_CALIBRATION on an independent sample, must give the same detected
+// WLS light per fibre, the same mean energy of the detected photons and the
+// same mean arrival time as the same sample with full tracking, within the
+// statistical errors. The photon branches are only written without
+// WAVEFORM. Usage, renaming the output in between:
+//   SEED=1 FIBRE_CALIBRATION=fibre.table ./runEEShashlik -m run.mac
+//   SEED=1234 ./runEEShashlik -m run.mac
+//   SEED=1234 FIBRE_FASTSIM=fibre.table ./runEEShashlik -m run.mac
+//   root -l -b -q 'codes/compare_fibre.cpp("full.root","fast.root")'
+// Prints, per fibre, the mean of Fibre_N and EOpt_N/Fibre_N of both files,
+// then the weighted mean time of the detected photons, and their difference
+// in standard deviations.
+
+float Fibre[4];
+float EOpt[4];
+float Photon_timeStep;
+vector<unsigned short>* Photon_time = 0;
+vector<float>* Weight_deposit = 0;
+
+void fibre_means(const char* fileName, double* mean, double* error,
+                 double* energy, double* energyError,
+                 double& time, double& timeError){
+  TFile *file = new TFile(fileName);
+  TTree *tree = (TTree*) file->Get("tree");
+  char name[32];
+  for (int i = 0;i < 4;i++){
+    sprintf(name,"Fibre_%d",i);
+    tree->SetBranchAddress(name, &Fibre[i]);
+    sprintf(name,"EOpt_%d",i);
+    tree->SetBranchAddress(name, &EOpt[i]);
+  }
+  tree->SetBranchAddress("Photon_timeStep", &Photon_timeStep);
+  tree->SetBranchAddress("Photon_time", &Photon_time);
+  tree->SetBranchAddress("Weight_deposit", &Weight_deposit);
+  double sum[4] = {0.}, sum2[4] = {0.}, esum[4] = {0.}, esum2[4] = {0.};
+  double w = 0., w2 = 0., tsum = 0., tsum2 = 0.;
+  int n[4] = {0}, nentries = tree->GetEntries();
+  for (int jentry = 0;jentry < nentries;jentry++){
+    tree->GetEntry(jentry);
+    for (int i = 0;i < 4;i++){
+      sum[i] += Fibre[i];
+      sum2[i] += Fibre[i]*Fibre[i];
+      if (Fibre[i] <= 0) continue;
+      esum[i] += EOpt[i]/Fibre[i];
+      esum2[i] += EOpt[i]/Fibre[i]*EOpt[i]/Fibre[i];
+      n[i]++;
+    }
+    for (size_t j = 0;j < Photon_time->size();j++){
+      double t = Photon_time->at(j)*Photon_timeStep;
+      double weight = j < Weight_deposit->size() ? Weight_deposit->at(j) : 1.;
+      w += weight;
+      w2 += weight*weight;
+      tsum += weight*t;
+      tsum2 += weight*t*t;
+    }
+  }
+  for (int i = 0;i < 4;i++){
+    mean[i] = sum[i]/nentries;
+    error[i] = TMath::Sqrt((sum2[i]/nentries - mean[i]*mean[i])/nentries);
+    energy[i] = n[i] ? esum[i]/n[i] : 0.;
+    energyError[i] = n[i] ? TMath::Sqrt((esum2[i]/n[i] - energy[i]*energy[i])/n[i]) : 0.;
+  }
+  // error of the weighted mean with the effective number of photons
+  time = w > 0 ? tsum/w : 0.;
+  timeError = w > 0 ? TMath::Sqrt((tsum2/w - time*time)*w2/(w*w)) : 0.;
+  file->Close();
+}
+
+void compare_fibre(const char* fullFile = "full.root", const char* fastFile = "fast.root"){
+  double mean[2][4], error[2][4], energy[2][4], energyError[2][4];
+  double time[2], timeError[2];
+  fibre_means(fullFile, mean[0], error[0], energy[0], energyError[0], time[0], timeError[0]);
+  fibre_means(fastFile, mean[1], error[1], energy[1], energyError[1], time[1], timeError[1]);
+  for (int i = 0;i < 4;i++){
+    double pull = (mean[1][i] - mean[0][i])
+                  /TMath::Sqrt(error[0][i]*error[0][i] + error[1][i]*error[1][i]);
+    double energyPull = (energy[1][i] - energy[0][i])
+                  /TMath::Sqrt(energyError[0][i]*energyError[0][i] + energyError[1][i]*energyError[1][i]);
+    cout << "fibre " << i
+         << "  photons " << mean[0][i] << " +- " << error[0][i]
+         << " (full) " << mean[1][i] << " +- " << error[1][i]
+         << " (fast) " << pull << " sigma"
+         << "  energy/photon " << energy[0][i] << " " << energy[1][i]
+         << " eV " << energyPull << " sigma" << endl;
+  }
+  double timePull = (time[1] - time[0])
+                    /TMath::Sqrt(timeError[0]*timeError[0] + timeError[1]*timeError[1]);
+  cout << "time " << time[0] << " +- " << timeError[0]
+       << " (full) " << time[1] << " +- " << timeError[1]
+       << " (fast) ns " << timePull << " sigma" << endl;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include "TFile.h"
+#include "TTree.h"
+#include "TMath.h"
+#include "string.h"
+using namespace std;
+// Closure of the QE at birth against the QE at the fibre end: the same
+// sample (same SEED and run macro) simulated with /EEShash/optical/qeAtBirth
+// false and true must give the same detected WLS light per fibre, and the
+// same mean energy of the detected photons, within the statistical errors
+// (the random sequences part at the first WLS photon, so the comparison is
+// statistical, not event by event). Usage, renaming the output in between:
+//   SEED=1234 ./runEEShashlik -m run.mac     (with qeAtBirth false)
+//   SEED=1234 ./runEEShashlik -m run.mac     (with qeAtBirth true)
+//   root -l -b -q 'codes/compare_qe.cpp("grease.root","birth.root")'
+// Prints, per fibre, the mean of Fibre_N and EOpt_N/Fibre_N of both files
+// and their difference in standard deviations.
+
+float Fibre[4];
+float EOpt[4];
+
+void fibre_means(const char* fileName, double* mean, double* error,
+                 double* energy, double* energyError){
+  TFile *file = new TFile(fileName);
+  TTree *tree = (TTree*) file->Get("tree");
+  char name[32];
+  for (int i = 0;i < 4;i++){
+    sprintf(name,"Fibre_%d",i);
+    tree->SetBranchAddress(name, &Fibre[i]);
+    sprintf(name,"EOpt_%d",i);
+    tree->SetBranchAddress(name, &EOpt[i]);
+  }
+  double sum[4] = {0.}, sum2[4] = {0.}, esum[4] = {0.}, esum2[4] = {0.};
+  int n[4] = {0}, nentries = tree->GetEntries();
+  for (int jentry = 0;jentry < nentries;jentry++){
+    tree->GetEntry(jentry);
+    for (int i = 0;i < 4;i++){
+      sum[i] += Fibre[i];
+      sum2[i] += Fibre[i]*Fibre[i];
+      if (Fibre[i] <= 0) continue;
+      esum[i] += EOpt[i]/Fibre[i];
+      esum2[i] += EOpt[i]/Fibre[i]*EOpt[i]/Fibre[i];
+      n[i]++;
+    }
+  }
+  for (int i = 0;i < 4;i++){
+    mean[i] = sum[i]/nentries;
+    error[i] = TMath::Sqrt((sum2[i]/nentries - mean[i]*mean[i])/nentries);
+    energy[i] = n[i] ? esum[i]/n[i] : 0.;
+    energyError[i] = n[i] ? TMath::Sqrt((esum2[i]/n[i] - energy[i]*energy[i])/n[i]) : 0.;
+  }
+  file->Close();
+}
+
+void compare_qe(const char* greaseFile = "grease.root", const char* birthFile = "birth.root"){
+  double mean[2][4], error[2][4], energy[2][4], energyError[2][4];
+  fibre_means(greaseFile, mean[0], error[0], energy[0], energyError[0]);
+  fibre_means(birthFile, mean[1], error[1], energy[1], energyError[1]);
+  for (int i = 0;i < 4;i++){
+    double pull = (mean[1][i] - mean[0][i])
+                  /TMath::Sqrt(error[0][i]*error[0][i] + error[1][i]*error[1][i]);
+    double energyPull = (energy[1][i] - energy[0][i])
+                  /TMath::Sqrt(energyError[0][i]*energyError[0][i] + energyError[1][i]*energyError[1][i]);
+    cout << "fibre " << i
+         << "  photons " << mean[0][i] << " +- " << error[0][i]
+         << " (grease) " << mean[1][i] << " +- " << error[1][i]
+         << " (birth) " << pull << " sigma"
+         << "  energy/photon " << energy[0][i] << " " << energy[1][i]
+         << " eV " << energyPull << " sigma" << endl;
+  }
+}
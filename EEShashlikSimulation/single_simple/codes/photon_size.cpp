@@ -0,0 +1,120 @@
+#include <iostream>
+#include <vector>
+#include "TFile.h"
+#include "TTree.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TMath.h"
+using namespace std;
+// Size and fill time of the detected photon branches: the former float
+// vectors (Time/Z/Theta/Process_deposit) against the packed Photon_*
+// vectors of CreateTree, on the same photons. The packing is the one of
+// CreateTree::AddPhoton(). Usage:
+//   root -l -b -q 'codes/photon_size.cpp(1000,20000)'
+// nPhotons is the number of detected photons per event.
+
+const float timeStep = 0.01;                  // [ns], CreateTree::fTimeStep
+const float zStep = 0.02;                     // [mm], CreateTree::kZStep
+const float thetaStep = TMath::Pi()/65535.;   // [rad], CreateTree::kThetaStep
+
+vector<float> Time_deposit;
+vector<float> Z_deposit;
+vector<float> Theta_deposit;
+vector<float> Process_deposit;
+vector<unsigned short> Photon_time;
+vector<short> Photon_z;
+vector<unsigned short> Photon_theta;
+vector<Char_t> Photon_code;
+float Photon_timeStep = timeStep;
+vector<float> Weight_deposit;
+
+void fill_photons(TRandom3& random, int nPhotons){
+  Time_deposit.clear();
+  Z_deposit.clear();
+  Theta_deposit.clear();
+  Process_deposit.clear();
+  Weight_deposit.clear();
+  for (int i = 0;i < nPhotons;i++){
+    // WLS arrivals: a few ns of shower and fibre transit, then the decay
+    int fibre = random.Integer(4);
+    int process = random.Rndm() < 0.9 ? 1 : 2;
+    Time_deposit.push_back(5. + random.Gaus(2.,0.5) + random.Exp(12.));
+    Z_deposit.push_back(random.Uniform(-60.,60.));
+    Theta_deposit.push_back(TMath::ACos(random.Uniform(-1.,1.)));
+    Process_deposit.push_back(3*fibre + process);
+    Weight_deposit.push_back(1.);
+  }
+}
+
+void pack_photons(){
+  Photon_time.clear();
+  Photon_z.clear();
+  Photon_theta.clear();
+  Photon_code.clear();
+  for (size_t i = 0;i < Time_deposit.size();i++){
+    float t = Time_deposit[i]/timeStep + 0.5;
+    Photon_time.push_back( t < 65535. ? (unsigned short)(t > 0. ? t : 0.) : 65535 );
+    float zq = floor(Z_deposit[i]/zStep + 0.5);
+    if( zq > 32767. ) zq = 32767.;
+    if( zq < -32768. ) zq = -32768.;
+    Photon_z.push_back((short)zq);
+    Photon_theta.push_back((unsigned short)(Theta_deposit[i]/thetaStep + 0.5));
+    Photon_code.push_back((Char_t)Process_deposit[i]);
+  }
+}
+
+void photon_size(int nEvents = 1000, int nPhotons = 20000){
+  TFile *oldFile = new TFile("photon_size_float.root","RECREATE");
+  TTree *oldTree = new TTree("tree","float photon vectors");
+  oldTree->Branch("Time_deposit", &Time_deposit);
+  oldTree->Branch("Z_deposit", &Z_deposit);
+  oldTree->Branch("Theta_deposit", &Theta_deposit);
+  oldTree->Branch("Process_deposit", &Process_deposit);
+  oldTree->Branch("Weight_deposit", &Weight_deposit);
+
+  TFile *newFile = new TFile("photon_size_packed.root","RECREATE");
+  TTree *newTree = new TTree("tree","packed photon vectors");
+  newTree->Branch("Photon_timeStep", &Photon_timeStep, "Photon_timeStep/F");
+  newTree->Branch("Photon_time", &Photon_time);
+  newTree->Branch("Photon_z", &Photon_z);
+  newTree->Branch("Photon_theta", &Photon_theta);
+  newTree->Branch("Photon_code", &Photon_code);
+  newTree->Branch("Weight_deposit", &Weight_deposit);
+
+  // the fill time of the packed layout includes the packing
+  TRandom3 random(12345);
+  TStopwatch oldWatch, newWatch;
+  oldWatch.Stop(); oldWatch.Reset();
+  newWatch.Stop(); newWatch.Reset();
+  for (int jentry = 0;jentry < nEvents;jentry++){
+    fill_photons(random, nPhotons);
+    oldWatch.Start(kFALSE);
+    oldTree->Fill();
+    oldWatch.Stop();
+    newWatch.Start(kFALSE);
+    pack_photons();
+    newTree->Fill();
+    newWatch.Stop();
+  }
+  oldFile->cd();
+  oldTree->Write();
+  newFile->cd();
+  newTree->Write();
+
+  double oldSize = oldTree->GetZipBytes();
+  double newSize = newTree->GetZipBytes();
+  cout << nEvents << " events of " << nPhotons << " photons" << endl;
+  cout << "float:  " << oldTree->GetTotBytes()/1.e6 << " MB raw, " << oldSize/1.e6
+       << " MB compressed, fill " << oldWatch.CpuTime() << " s" << endl;
+  cout << "packed: " << newTree->GetTotBytes()/1.e6 << " MB raw, " << newSize/1.e6
+       << " MB compressed, fill " << newWatch.CpuTime() << " s" << endl;
+  cout << "size ratio " << oldSize/newSize << ", fill time ratio "
+       << oldWatch.CpuTime()/newWatch.CpuTime() << endl;
+  // both with and without the Weight_deposit branch common to the two layouts
+  double weightSize = newTree->GetBranch("Weight_deposit")->GetZipBytes();
+  cout << "size ratio without Weight_deposit "
+       << (oldSize - weightSize)/(newSize - weightSize) << endl;
+
+  oldFile->Close();
+  newFile->Close();
+}
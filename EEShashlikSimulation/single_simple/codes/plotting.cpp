@@ -12,16 +12,17 @@ float Eact_CentralXtal;
 float Eabs_CentralXtal;
 float xPosition;
 float yPosition;
-int  Fibre_0;
-int  Fibre_1;
-int  Fibre_2;
-int  Fibre_3;
-int  NPhot_Fib;
-int  NPhot_Fib2;
-int  NPhot_Fib3;
-int  NPhot_Fib4;
-vector<float> *Time_deposit;
-vector<float> *Process_deposit;
+float Fibre_0;
+float Fibre_1;
+float Fibre_2;
+float Fibre_3;
+float NPhot_Fib;
+float NPhot_Fib2;
+float NPhot_Fib3;
+float NPhot_Fib4;
+vector<unsigned short> *Photon_time;
+vector<Char_t> *Photon_code;
+float Photon_timeStep;
 vector<float> *Time_deposit_APD;
 vector<float> *EAPD;
 int nParticlesAPD;
@@ -81,8 +82,9 @@ void plotting(){
   tree->SetBranchAddress("NPhot_Fib2", &NPhot_Fib2);
   tree->SetBranchAddress("NPhot_Fib3", &NPhot_Fib3);
   tree->SetBranchAddress("NPhot_Fib4", &NPhot_Fib4);
-  tree->SetBranchAddress("Time_deposit", &Time_deposit);
-  tree->SetBranchAddress("Process_deposit", &Process_deposit);
+  tree->SetBranchAddress("Photon_time", &Photon_time);
+  tree->SetBranchAddress("Photon_code", &Photon_code);
+  tree->SetBranchAddress("Photon_timeStep", &Photon_timeStep);
   tree->SetBranchAddress("Time_deposit_APD", &Time_deposit_APD);
   tree->SetBranchAddress("EAPD", &EAPD);
   tree->SetBranchAddress("nParticlesAPD", &nParticlesAPD);
@@ -166,9 +168,10 @@ void plotting(){
       WLS_waveform->Reset();
       fscint_waveform->Reset();
       overall_waveform->Reset();
-      for (int i = 0;i < Time_deposit->size();i++){
-        if (Process_deposit->at(i) == (3*(APD-1)+1)) time_arrival_WLS->Fill(Time_deposit->at(i));
-        if (Process_deposit->at(i) == (3*(APD-1)+2)) time_arrival_fscint->Fill(Time_deposit->at(i));
+      for (int i = 0;i < Photon_time->size();i++){
+        float time = Photon_time->at(i)*Photon_timeStep;
+        if ((signed char)Photon_code->at(i) == (3*(APD-1)+1)) time_arrival_WLS->Fill(time);
+        if ((signed char)Photon_code->at(i) == (3*(APD-1)+2)) time_arrival_fscint->Fill(time);
       }
       //WLS_waveform->Add(convolution(time_arrival_WLS,apd_plus_electronics));
       //fscint_waveform->Add(convolution(time_arrival_fscint,apd_plus_electronics));
@@ -1,33 +1,107 @@
 #include <iostream>
 #include <vector>
+#include <map>
+#include <string>
 
 #include "TFile.h"
 #include "TTree.h"
 #include "TString.h"
 
+#include "G4Types.hh"
+
+class EEShashColumnExporter;
+
 class CreateTree
 {
  private:
   
   TTree*  ftree;
   TString fname;
+  EEShashColumnExporter* fExporter;
+
+  void BookBranches();
+
+  // event buffer without a tree, see NewBuffer()
+  CreateTree() : ftree(0), fExporter(0) {};
+
+  // output settings, see ApplyOutputSettings()
+  static std::map<std::string,int> fCompression;
+  static int      fBasketSize;
+  static Long64_t fAutoFlush;
+
+  // columnar export, see OpenColumnExport()
+  static std::string fColumnFile;
+  static bool        fColumnOnly;
   
  public:
   
   
   CreateTree(TString name);
+  // new tree with the same branches in the current directory, e.g. the
+  // next chunk of a worker (EEShashTreeMerger)
+  TTree*             Rebook();
   TTree*             GetTree() const { return ftree; };
   TString            GetName() const { return fname; };
-  int                Fill() { return this->GetTree()->Fill(); };
+  int                Fill();
   bool               Write();
   void               Clear();
+
+  // event buffers of the background writer (EEShashTreeWriter): the event
+  // data only, which CopyEvent() copies to the tree of another instance
+  static CreateTree* NewBuffer() { return new CreateTree(); };
+  void               CopyEvent(CreateTree& to) const;
+
+  // compression (100*algorithm + level, algorithm 1 zlib, 2 lzma, 4 lz4,
+  // 5 zstd as in ROOT) of a branch, "*" for all; basket size [bytes] and
+  // AutoFlush, 0 keeps the ROOT defaults; shared by the threads, they
+  // apply to the trees at their next ApplyOutputSettings()
+  static void        SetCompression(int settings, const std::string& branch = "*")
+                       { fCompression[branch] = settings; };
+  static void        SetBasketSize(int size) { fBasketSize = size; };
+  static void        SetAutoFlush(Long64_t entries) { fAutoFlush = entries; };
+  void               ApplyOutputSettings();
+
+  // columnar copy of the output tree (EEShashColumnExporter), filled with
+  // the tree or, if only is set, instead of it; opened and closed by the
+  // owner of the output tree
+  static void        SetColumnExport(const std::string& fileName, bool only)
+                       { fColumnFile = fileName; fColumnOnly = only; };
+  void               OpenColumnExport();
+  void               CloseColumnExport();
+  // one tree per thread: the master's in sequential mode, one per worker
+  // (filled in chunks, see EEShashTreeMerger) in multi-threaded mode
   static CreateTree* Instance() { return fInstance; };
-  static CreateTree* fInstance;
+  static G4ThreadLocal CreateTree* fInstance;
   int Event;
-  std::vector<float> Time_deposit;
-  std::vector<float> Z_deposit;
-  std::vector<float> Process_deposit;//1 is WLS, 2 Scintillation, 3 Cerenkov
-  std::vector<float> Theta_deposit;
+  // detected photons, one element per photon in each vector, filled with
+  // AddPhoton(); the vectors keep their capacity from one event to the next
+  void AddPhoton(float time, float z, float theta, int code, float weight);
+  // time quantum [ns], 0.01 ns (655 ns range) unless set otherwise
+  static void  SetTimeStep(float step) { fTimeStep = step; };
+  static float GetTimeStep() { return fTimeStep; };
+  static float fTimeStep;
+  static const float kZStep;      // [mm] per count of Photon_z
+  static const float kThetaStep;  // [rad] per count of Photon_theta
+  std::vector<unsigned short> Photon_time;  // [Photon_timeStep], 65535 = later
+  std::vector<short> Photon_z;              // vertex z
+  std::vector<unsigned short> Photon_theta; // vertex polar angle
+  std::vector<Char_t> Photon_code;  // 3*fibre + 1 WLS, 2 Scintillation, 3 Cerenkov; -1 other,
+                                    // read back through signed char: plain char is unsigned on ARM
+  std::vector<float> Weight_deposit;//statistical weight of the photon
+  float Photon_timeStep;
+
+  // waveform mode: the photons are accumulated in the Waveform_* arrays
+  // (EEShashWaveform) and the per-photon branches are not booked; to be
+  // set before the trees are created
+  static void SetWaveformMode(bool mode) { fWaveformMode = mode; };
+  static bool GetWaveformMode() { return fWaveformMode; };
+  static bool fWaveformMode;
+  static const int nWaveformBins = 1024;
+  float Waveform_0[nWaveformBins];
+  float Waveform_1[nWaveformBins];
+  float Waveform_2[nWaveformBins];
+  float Waveform_3[nWaveformBins];
+  float Waveform_APD[nWaveformBins];
   std::vector<float> opPhoton_time;
   std::vector<int> opPhoton_process;
   float  Eabs;
@@ -39,21 +113,31 @@ class CreateTree
   float  Eact_1x3;
   float Eact_CentralXtal;
   float Eabs_CentralXtal;
-  int    NPhot_Act;
-  int    NPhot_Fib;
-  int    NPhot_Fib2;
-  int    NPhot_Fib3;
-  int    NPhot_Fib4;
+  // photon counters are sums of statistical weights
+  float  NPhot_Act;
+  float  NPhot_Fib;
+  float  NPhot_Fib2;
+  float  NPhot_Fib3;
+  float  NPhot_Fib4;
+  // optical photons seen and tracked under the photon budget
+  int    NOpt_generated;
+  int    NOpt_tracked;
   float  EfibrCore;
   float  EfibrClad;
   int    nLayers;
 
-  int   Fibre_start_0;
+  float Fibre_start_0;
+
+  float Fibre_0;
+  float Fibre_1;
+  float Fibre_2;
+  float Fibre_3;
 
-  int   Fibre_0;
-  int   Fibre_1;
-  int   Fibre_2;
-  int   Fibre_3;
+  // variance of Fibre_N, sum of the squared weights
+  float FibreVar_0;
+  float FibreVar_1;
+  float FibreVar_2;
+  float FibreVar_3;
 
   float  xPosition;
   float  yPosition;
@@ -62,6 +146,14 @@ class CreateTree
   float  EOpt_1;
   float  EOpt_2;
   float  EOpt_3;  
+
+  // expected and sampled fibre captures of the tile fast simulation
+  float  Capture_0;
+  float  Capture_1;
+  float  Capture_2;
+  float  Capture_3;
+  std::vector<int>   Fibre_capture;
+  std::vector<float> Time_capture;
   std::vector<float> EAPD;
   std::vector<float> Time_deposit_APD;
   std::vector<float> E_deposit_APD;
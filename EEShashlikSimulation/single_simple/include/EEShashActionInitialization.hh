@@ -32,18 +32,30 @@
 #define EEShashActionInitialization_h 1
 
 #include "G4VUserActionInitialization.hh"
+#include "globals.hh"
+
+class EEShashDetectorConstruction;
 
 /// Action initialization class.
 ///
+/// All the per-event actions, tracking and stepping included, are built
+/// here so that each worker thread gets its own instances.
 
 class EEShashActionInitialization : public G4VUserActionInitialization
 {
   public:
-    EEShashActionInitialization();
+    EEShashActionInitialization(EEShashDetectorConstruction* detConstruction,
+                                G4int propagateScintillation,
+                                G4int propagateCerenkov);
     virtual ~EEShashActionInitialization();
 
     virtual void BuildForMaster() const;
     virtual void Build() const;
+
+  private:
+    EEShashDetectorConstruction* fDetConstruction;
+    G4int fPropagateScintillation;
+    G4int fPropagateCerenkov;
 };
 
 #endif
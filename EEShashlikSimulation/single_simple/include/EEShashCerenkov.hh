@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashCerenkov.hh
+/// \brief Definition of the EEShashCerenkov class
+
+#ifndef EEShashCerenkov_h
+#define EEShashCerenkov_h 1
+
+#include "G4Cerenkov.hh"
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+
+/// Cerenkov process limited to a photon energy window
+///
+/// Same physics as G4Cerenkov, but PostStepDoIt() only creates the photons
+/// whose energy falls in [fEnergyMin, fEnergyMax]: the mean number of
+/// photons is the Frank-Tamm integral restricted to the window, and the
+/// photon energies are sampled inside it. The number and spectrum of the
+/// photons in the window are therefore unchanged, while the photons outside
+/// of it are never created. The step limitation of G4Cerenkov is kept.
+
+class EEShashCerenkov : public G4Cerenkov
+{
+  public:
+    EEShashCerenkov(const G4String& processName = "Cerenkov",
+                    G4double energyMin = 0., G4double energyMax = DBL_MAX);
+    virtual ~EEShashCerenkov();
+
+    virtual G4VParticleChange* PostStepDoIt(const G4Track& aTrack,
+                                            const G4Step& aStep);
+
+    void SetEnergyWindow(G4double energyMin, G4double energyMax);
+    G4double GetEnergyMin() const { return fEnergyMin; }
+    G4double GetEnergyMax() const { return fEnergyMax; }
+
+  private:
+    // refractive index sampled on a fixed grid over the window
+    struct BandRindex {
+      G4double eMin;
+      G4double eMax;
+      std::vector<G4double> rindex;
+    };
+
+    const BandRindex& GetBandRindex(const G4MaterialPropertyVector* rindex);
+
+    // mean number of photons in the window per unit length
+    G4double GetBandNumberOfPhotons(G4double charge, G4double beta,
+                                    const BandRindex& band) const;
+
+    G4double fEnergyMin;
+    G4double fEnergyMax;
+    std::map<const G4MaterialPropertyVector*, BandRindex> fBandRindex;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
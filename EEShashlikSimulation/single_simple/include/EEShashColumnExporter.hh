@@ -0,0 +1,83 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashColumnExporter.hh
+/// \brief Definition of the EEShashColumnExporter class
+
+#ifndef EEShashColumnExporter_h
+#define EEShashColumnExporter_h 1
+
+#include "globals.hh"
+#include "EEShashColumnReader.hh"
+
+#include <cstdio>
+#include <vector>
+
+class TTree;
+
+/// Columnar export of an output CreateTree, for readers without ROOT
+///
+/// The columns are taken from the branches of the tree: one per scalar or
+/// fixed-size array leaf and one per std::vector branch, with the offsets
+/// of each event. Fill(), called with every fill of the tree, appends the
+/// current values of each column to a temporary file of its own; Close()
+/// writes them one after the other into the export file, in the format of
+/// EEShashColumnReader.hh.
+///
+/// Switched on with COLUMN_EXPORT=<file> (COLUMN_ONLY=1 skips the ROOT
+/// tree), see CreateTree::OpenColumnExport().
+
+class EEShashColumnExporter
+{
+  public:
+    EEShashColumnExporter(const G4String& fileName, TTree* tree);
+    ~EEShashColumnExporter();
+
+    void Fill();
+    void Close();
+
+  private:
+    struct Column {
+      EEShashColumnIndex index;
+      size_t   valueSize;
+      void*    address;   // leaf values, or the std::vector of the branch
+      FILE*    data;      // temporary
+      std::vector<uint64_t> offsets;
+    };
+
+    void AddColumn(const char* name, const char* typeName, G4int kind,
+                   G4int count, void* address);
+    void Copy(FILE* from, FILE* to, uint64_t bytes);
+    void Align(FILE* out);
+
+    G4String fFileName;
+    std::vector<Column> fColumns;
+    uint64_t fNofEntries;
+    G4bool   fClosed;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
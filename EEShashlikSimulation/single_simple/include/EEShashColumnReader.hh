@@ -0,0 +1,189 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashColumnReader.hh
+/// \brief Definition of the columnar output format and its reader
+
+#ifndef EEShashColumnReader_h
+#define EEShashColumnReader_h 1
+
+// Self-contained: no Geant4 or ROOT, to be copied into downstream tools.
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Columnar export of the CreateTree output (EEShashColumnExporter)
+///
+/// File layout, native byte order:
+/// - EEShashColumnHeader at offset 0
+/// - the columns, each starting on a 64-byte boundary: the values of all
+///   events one after the other, then for a vector branch the nEntries+1
+///   offsets (uint64) of each event's first value
+/// - nColumns EEShashColumnIndex entries at indexOffset
+///
+/// EEShashColumnReader maps the file and returns columns as plain arrays
+/// into the mapping, so iterating a column reads nothing but its pages.
+
+struct EEShashColumnHeader
+{
+  char     magic[8];      // "EESHCOL"
+  uint32_t version;       // 1
+  uint32_t nColumns;
+  uint64_t nEntries;      // events
+  uint64_t indexOffset;
+};
+
+struct EEShashColumnIndex
+{
+  enum { kScalar = 0, kArray = 1, kVector = 2 };
+
+  char     name[48];
+  char     type;           // f d i I s S c C l L b, see EEShashColumnType
+  uint8_t  kind;
+  uint16_t reserved;
+  uint32_t count;          // values per event of a scalar or array
+  uint64_t dataOffset;
+  uint64_t nValues;        // in the whole column
+  uint64_t offsetsOffset;  // kVector only
+};
+
+// type code of a C++ type
+template <class T> struct EEShashColumnType;
+template <> struct EEShashColumnType<float>          { enum { code = 'f' }; };
+template <> struct EEShashColumnType<double>         { enum { code = 'd' }; };
+template <> struct EEShashColumnType<int32_t>        { enum { code = 'i' }; };
+template <> struct EEShashColumnType<uint32_t>       { enum { code = 'I' }; };
+template <> struct EEShashColumnType<int16_t>        { enum { code = 's' }; };
+template <> struct EEShashColumnType<uint16_t>       { enum { code = 'S' }; };
+template <> struct EEShashColumnType<char>           { enum { code = 'c' }; };
+template <> struct EEShashColumnType<unsigned char>  { enum { code = 'C' }; };
+template <> struct EEShashColumnType<int64_t>        { enum { code = 'l' }; };
+template <> struct EEShashColumnType<uint64_t>       { enum { code = 'L' }; };
+template <> struct EEShashColumnType<bool>           { enum { code = 'b' }; };
+
+/// One column, a view into the mapped file
+template <class T>
+struct EEShashColumn
+{
+  const T*        values;
+  uint64_t        nValues;
+  const uint64_t* offsets;  // 0 unless the branch is a vector
+  uint64_t        nEntries;
+  uint32_t        count;    // values per event if offsets is 0
+
+  const T* begin() const { return values; }
+  const T* end() const { return values + nValues; }
+
+  // values of one event
+  const T* Entry(uint64_t entry, uint64_t& n) const
+  {
+    if ( offsets ) {
+      n = offsets[entry+1] - offsets[entry];
+      return values + offsets[entry];
+    }
+    n = count;
+    return values + entry*count;
+  }
+};
+
+class EEShashColumnReader
+{
+  public:
+    explicit EEShashColumnReader(const char* fileName)
+     : fBase(0), fSize(0)
+    {
+      int fd = open(fileName, O_RDONLY);
+      struct stat st;
+      if ( fd < 0 || fstat(fd, &st) != 0 ) {
+        if ( fd >= 0 ) close(fd);
+        throw std::runtime_error(std::string("cannot open ") + fileName);
+      }
+      fSize = st.st_size;
+      void* base = fSize ? mmap(0, fSize, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+      close(fd);
+      if ( base == MAP_FAILED )
+        throw std::runtime_error(std::string("cannot map ") + fileName);
+      fBase = static_cast<const char*>(base);
+
+      if ( fSize < sizeof(EEShashColumnHeader)
+           || strncmp(Header().magic, "EESHCOL", 8) != 0
+           || Header().indexOffset
+              + Header().nColumns*sizeof(EEShashColumnIndex) > fSize ) {
+        munmap(const_cast<char*>(fBase), fSize);
+        throw std::runtime_error(std::string("not a column file: ") + fileName);
+      }
+    }
+
+    ~EEShashColumnReader() { munmap(const_cast<char*>(fBase), fSize); }
+
+    uint64_t GetEntries() const { return Header().nEntries; }
+    uint32_t GetNColumns() const { return Header().nColumns; }
+    const EEShashColumnIndex& GetIndex(uint32_t i) const
+    {
+      return reinterpret_cast<const EEShashColumnIndex*>(
+        fBase + Header().indexOffset)[i];
+    }
+
+    template <class T>
+    EEShashColumn<T> GetColumn(const char* name) const
+    {
+      for ( uint32_t i = 0; i < GetNColumns(); ++i ) {
+        const EEShashColumnIndex& index = GetIndex(i);
+        if ( strncmp(index.name, name, sizeof(index.name)) != 0 ) continue;
+        if ( index.type != EEShashColumnType<T>::code )
+          throw std::runtime_error(std::string("wrong type for column ") + name);
+        EEShashColumn<T> column;
+        column.values   = reinterpret_cast<const T*>(fBase + index.dataOffset);
+        column.nValues  = index.nValues;
+        column.offsets  = index.kind == EEShashColumnIndex::kVector
+          ? reinterpret_cast<const uint64_t*>(fBase + index.offsetsOffset) : 0;
+        column.nEntries = GetEntries();
+        column.count    = index.count;
+        return column;
+      }
+      throw std::runtime_error(std::string("no column ") + name);
+    }
+
+  private:
+    const EEShashColumnHeader& Header() const
+    {
+      return *reinterpret_cast<const EEShashColumnHeader*>(fBase);
+    }
+
+    EEShashColumnReader(const EEShashColumnReader&);
+    EEShashColumnReader& operator=(const EEShashColumnReader&);
+
+    const char* fBase;
+    size_t      fSize;
+};
+
+#endif
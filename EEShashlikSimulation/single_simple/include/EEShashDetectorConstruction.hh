@@ -34,12 +34,11 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "MyMaterials.hh"
 #include "globals.hh"
+#include "EEShashVolumeRoleTable.hh"
 
-
-
-
-class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
+class G4Region;
+class EEShashDetectorMessenger;
 
 
 /// Detector construction class to define materials and geometry.
@@ -68,11 +67,62 @@ public:
   virtual G4VPhysicalVolume* Construct();
   virtual void ConstructSDandField();
 
+  // volume-role table, valid once Construct() has been called
+  const EEShashVolumeRoleTable& GetRoleTable() const { return fRoleTable; }
+  inline EEShashVolumeRole GetRole(const G4LogicalVolume* lv) const;
+  inline EEShashVolumeRole GetRole(const G4VPhysicalVolume* pv) const;
+  inline G4int GetFibreIndex(const G4VPhysicalVolume* pv) const;
+
+  // WLS fibre light transport, see EEShashFibreFastModel; to be set before
+  // the run manager is initialised. The table file is read in fast
+  // simulation mode and written by the caller at the end of a calibration.
+  void SetFibreMode(G4int mode, const G4String& tableFile);
+  G4int GetFibreMode() const { return fFibreMode; }
+
+  // CeF3 tile light collection, see EEShashTileFastModel; same conventions
+  void SetTileMode(G4int mode, const G4String& tableFile);
+  G4int GetTileMode() const { return fTileMode; }
+
+  // GDML cache of the built geometry, keyed by the construction parameters:
+  // the first job builds the volumes (with overlap checks) and writes them
+  // to the directory, later jobs read them back without checks unless
+  // checkOverlaps is set. To be set before the run manager is initialised.
+  void SetGeometryCache(const G4String& directory, G4bool checkOverlaps);
+
+  // construction parameters, also set with /EEShash/geometry/ (see
+  // EEShashDetectorMessenger); once the run manager is initialised they
+  // take effect after ReinitializeGeometry(), at the next run
+  void SetRotation(G4double degrees)       { fRotation = degrees; }
+  void SetZtraslation(G4double z)          { fZtraslationInput = z; }
+  void SetAbsThickness(G4double thickness) { fAbsThickness = thickness; }
+  void SetActThickness(G4double thickness) { fActThickness = thickness; }
+  void SetTileSize(G4double sizeXY)        { fCalorSizeXY = sizeXY; }
+  void SetTyvekThickness(G4double thickness) { fTyvekThickness = thickness; }
+  void SetAPDs(G4bool place)               { fPlaceAPDs = place; }
+  void SetHodoscope(G4bool place)          { fPlaceHodoscope = place; }
+  void SetMatrix(G4bool place)             { fPlaceMatrix = place; }
+  void SetParameterisedMatrix(G4bool parameterised)
+                                           { fParameterisedMatrix = parameterised; }
+
+  // rebuilds the geometry at the next run, in the same process: the
+  // volumes are deleted, the materials, regions, fast simulation models
+  // and sensitive detectors are kept and attached to the new volumes
+  void ReinitializeGeometry();
+
 private:
   // methods
   //
   void DefineMaterials();
   G4VPhysicalVolume* DefineVolumes();
+  void DefineRegions();
+  void AddRegionRoot(G4Region* region, const G4String& lvName);
+  void CheckLightTable(const G4String& table, G4double tableValue,
+                       G4double value) const;
+  void SetTileModelFibres() const;
+  G4String GetGeometryCacheFile() const;
+  G4VPhysicalVolume* ReadGeometryCache(const G4String& fileName);
+  void WriteGeometryCache(const G4String& fileName,
+                          G4VPhysicalVolume* worldPV) const;
   
   // data members
   //
@@ -83,12 +133,58 @@ private:
     G4int    fNofLayers;     // number of layers
     G4int    fNofBGOs;       // number of BGO
     G4double fRotation;      // rotation of the detector compared to the beam
-    G4double fZtraslation;   // traslation on the Z axis (done *before*) the rotation
+    G4double fZtraslationInput; // traslation on the Z axis (done *before*) the rotation
+    G4double fZtraslation;   // the same, to the middle of the calorimeter
+
+    G4int    fFibreMode;      // EEShashFibreMode of the WLS fibres
+    G4String fFibreTableFile; // light transport table of the fibres
+    G4Region* fFibreRegion;   // envelope of the fibre fast simulation
+
+    G4int    fTileMode;       // EEShashTileMode of the CeF3 tiles
+    G4String fTileTableFile;  // light collection table of the tiles
+    G4Region* fTileRegion;    // envelope of the tile fast simulation
+
+    G4double fAbsThickness;   // thickness of the absorber plates
+    G4double fActThickness;   // thickness of the tiles
+    G4double fCalorSizeXY;    // transverse size of the tiles
+    G4double fTyvekThickness; // tyvek between the layers
+    G4bool   fPlaceAPDs;      // APDs behind the grease at the fibre ends
+    G4bool   fPlaceHodoscope; // hodoscope in front of the calorimeter
+    G4bool   fPlaceMatrix;    // channels around the central one
+    G4bool   fParameterisedMatrix; // as G4PVParameterised, or one placement each
+    G4double fFibreLength;    // length of the fibre cores
+
+    G4bool   fGeometryReleased; // volumes deleted, waiting for Construct()
+    EEShashDetectorMessenger* fMessenger;
+
+    G4String fGeometryCacheDir;  // GDML cache directory, empty if none
+    G4bool   fCacheOverlaps;     // check overlaps of a cached geometry too
 
+    EEShashVolumeRoleTable fRoleTable;  // role of each volume
 
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+inline EEShashVolumeRole
+EEShashDetectorConstruction::GetRole(const G4LogicalVolume* lv) const
+{
+  return fRoleTable.GetRole(lv);
+}
+
+inline EEShashVolumeRole
+EEShashDetectorConstruction::GetRole(const G4VPhysicalVolume* pv) const
+{
+  return fRoleTable.GetRole(pv);
+}
+
+inline G4int
+EEShashDetectorConstruction::GetFibreIndex(const G4VPhysicalVolume* pv) const
+{
+  return fRoleTable.GetFibreIndex(pv);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 #endif
 
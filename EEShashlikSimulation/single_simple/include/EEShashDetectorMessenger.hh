@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashDetectorMessenger.hh
+/// \brief Definition of the EEShashDetectorMessenger class
+
+#ifndef EEShashDetectorMessenger_h
+#define EEShashDetectorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EEShashDetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+/// Messenger of the construction parameters of EEShashDetectorConstruction
+///
+/// Commands in /EEShash/geometry/, read from the GEOMETRY_CONFIG=<macro>
+/// file before the initialisation or given between runs, in which case the
+/// geometry is rebuilt at the next run in the same process:
+/// - nLayers <n>            : number of layers (before the initialisation,
+///                            the output columns are booked from it)
+/// - nFibres <n>            : number of read out fibres, 0 to 4 (idem)
+/// - rotation <angle> <unit> : rotation of the calorimeter to the beam
+/// - zTraslation <z> <unit> : translation along the beam, before the rotation
+/// - absThickness <t> <unit> : absorber plates
+/// - actThickness <t> <unit> : CeF3 tiles
+/// - tileSize <size> <unit> : transverse size of the tiles
+/// - tyvekThickness <t> <unit> : tyvek between the layers
+/// - apd <bool>             : APDs behind the grease at the fibre ends
+/// - hodoscope <bool>       : hodoscope in front of the calorimeter
+/// - matrix <bool>          : channels around the central one
+/// - parameterisedMatrix <bool> : those channels as parameterised volumes,
+///                            or one placement each (for comparisons)
+
+class EEShashDetectorMessenger : public G4UImessenger
+{
+  public:
+    EEShashDetectorMessenger(EEShashDetectorConstruction* detector);
+    virtual ~EEShashDetectorMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    EEShashDetectorConstruction* fDetector;
+    G4UIdirectory*             fGeometryDir;
+    G4UIcmdWithAnInteger*      fNLayersCmd;
+    G4UIcmdWithAnInteger*      fNFibresCmd;
+    G4UIcmdWithADoubleAndUnit* fRotationCmd;
+    G4UIcmdWithADoubleAndUnit* fZtraslationCmd;
+    G4UIcmdWithADoubleAndUnit* fAbsThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fActThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fTileSizeCmd;
+    G4UIcmdWithADoubleAndUnit* fTyvekThicknessCmd;
+    G4UIcmdWithABool*          fAPDCmd;
+    G4UIcmdWithABool*          fHodoscopeCmd;
+    G4UIcmdWithABool*          fMatrixCmd;
+    G4UIcmdWithABool*          fParameterisedMatrixCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
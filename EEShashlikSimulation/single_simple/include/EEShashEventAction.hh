@@ -35,6 +35,8 @@
 #include "G4UserEventAction.hh"
 
 #include "EEShashCalorHit.hh"
+#include "EEShashOpticalHit.hh"
+#include "EEShashWaveform.hh"
 
 #include "globals.hh"
 
@@ -43,6 +45,10 @@
 /// In EndOfEventAction(), it prints the accumulated quantities of the energy 
 /// deposit and track lengths of charged particles in Absober and Act layers 
 /// stored in the hits collections.
+///
+/// In waveform mode (CreateTree::GetWaveformMode()) the detected photons
+/// are accumulated per fibre, and the particles reaching the APD, in
+/// EEShashWaveform's which replace the per-photon branches of the tree.
 
 class EEShashEventAction : public G4UserEventAction
 {
@@ -57,6 +63,8 @@ private:
   // methods
   EEShashCalorHitsCollection* GetHitsCollection(G4int hcID,
                                             const G4Event* event) const;
+  EEShashOpticalHitsCollection* GetOpticalHitsCollection(G4int hcID,
+                                            const G4Event* event) const;
   void PrintEventStatistics(G4double absEdep, G4double absTrackLength,
                             G4double actEdep, G4double actTrackLength,
 //			    G4double bgoEdep, G4double bgoTrackLength,
@@ -76,7 +84,11 @@ private:
   G4int  fScint1HCID;
   G4int  fHodo11HCID;
   G4int  fHodo12HCID;
+  G4int  fOpticalHCID;
   G4int  fAPDHCID;
+
+  EEShashWaveform fWaveform[nMaxFibres];
+  EEShashWaveform fWaveformAPD;
   
 };
                      
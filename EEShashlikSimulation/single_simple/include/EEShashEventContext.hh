@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashEventContext.hh
+/// \brief Definition of the EEShashEventContext class
+
+#ifndef EEShashEventContext_h
+#define EEShashEventContext_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Per-event accumulators shared by the user actions of one thread
+///
+/// The beam position, the photon counters filled in SteppingAction and the
+/// timing vector used to be process-wide globals (common.h), which races
+/// as soon as several workers run events. Each thread now has its own
+/// context, reset by EEShashPrimaryGeneratorAction at the start of the
+/// event and read back by EEShashEventAction at its end.
+
+class EEShashEventContext
+{
+  public:
+    // context of the calling thread, created on first use
+    static EEShashEventContext* Instance();
+
+    void Reset();
+
+    void SetBeamPosition(G4double x, G4double y) { fXBeamPos = x; fYBeamPos = y; }
+    G4double GetXBeamPos() const { return fXBeamPos; }
+    G4double GetYBeamPos() const { return fYBeamPos; }
+
+    // photon counters are sums of statistical weights, see TrackInformation
+    void AddNPhotAct(G4double weight) { fNPhotAct += weight; }
+    void AddFibreStart0(G4double weight) { fFibreStart0 += weight; }
+    G4double GetNPhotAct() const { return fNPhotAct; }
+    G4double GetFibreStart0() const { return fFibreStart0; }
+
+    std::vector<float>& GetTimeVector() { return fTimeVector; }
+
+  private:
+    EEShashEventContext();
+
+    static G4ThreadLocal EEShashEventContext* fInstance;
+
+    G4double fXBeamPos;
+    G4double fYBeamPos;
+    G4double fNPhotAct;     // scintillation photons created in the CeF3
+    G4double fFibreStart0;  // WLS photons created in fibre 0
+    std::vector<float> fTimeVector;  // nPhotonsForTiming arrival times
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,83 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashFibreFastModel.hh
+/// \brief Definition of the EEShashFibreFastModel class
+
+#ifndef EEShashFibreFastModel_h
+#define EEShashFibreFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+class EEShashFibreTable;
+class EEShashOpticalReadoutSD;
+
+/// Treatment of the WLS photons in the fibre cores
+enum EEShashFibreMode {
+  kFibreFullTracking = 0,  // full optical tracking, no fast simulation
+  kFibreCalibration,       // full tracking, fill the EEShashFibreTable
+  kFibreFastSimulation     // parameterised transport from the table
+};
+
+/// Fast simulation model of the light transport along the WLS fibres
+///
+/// Attached to the "FibreRegion" envelope around the fibre cores. Each
+/// optical photon emitted by WLS in a core is, at its first step, looked up
+/// in the EEShashFibreTable by distance to the readout end, direction and
+/// wavelength: with the tabulated probability it is handed directly to the
+/// EEShashOpticalReadoutSD with a sampled delay, and in any case it is
+/// killed, so that the thousands of boundary reflections along the fibre
+/// are never tracked.
+///
+/// In calibration mode the model never triggers; it only records the birth
+/// of each WLS photon in the table while the photon is tracked in full.
+
+class EEShashFibreFastModel : public G4VFastSimulationModel
+{
+  public:
+    EEShashFibreFastModel(const G4String& name, G4Region* envelope,
+                          EEShashFibreTable* table, G4int mode,
+                          EEShashOpticalReadoutSD* readout);
+    virtual ~EEShashFibreFastModel();
+
+    // methods from base class
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  private:
+    // distance to the readout (+z) end, local cos(theta) and wavelength [nm]
+    void GetLocalCoordinates(const G4FastTrack& fastTrack, G4double& distance,
+                             G4double& cosTheta, G4double& lambda) const;
+
+    EEShashFibreTable*       fTable;
+    G4int                    fMode;
+    EEShashOpticalReadoutSD* fReadout;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
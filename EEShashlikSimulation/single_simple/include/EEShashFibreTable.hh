@@ -0,0 +1,127 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashFibreTable.hh
+/// \brief Definition of the EEShashFibreTable class
+
+#ifndef EEShashFibreTable_h
+#define EEShashFibreTable_h 1
+
+#include "globals.hh"
+
+#include <vector>
+#include <map>
+
+/// Light transport table of the WLS fibres
+///
+/// For a photon emitted in the fibre core, binned in distance to the
+/// readout (grease) end, direction cosine along the fibre axis and
+/// wavelength, the table holds the probability to arrive at the readout
+/// (trapping, reaching the end and attenuation together) and the mean and
+/// RMS of the delay between emission and arrival.
+///
+/// The table is filled in calibration mode with full optical tracking:
+/// RecordBirth() is called when a WLS photon is emitted in the core and
+/// RecordArrival() when it reaches the readout. A photon absorbed and
+/// re-emitted by the WLS dye of the core stays the same entry of the table:
+/// its re-emissions take over its bin and emission time, and the chain
+/// counts as arrived, with the delay of its last photon, if that photon
+/// reaches the readout, as the fast simulation kills the first photon of
+/// the chain. Write() saves it to a text
+/// file which Load() reads back for EEShashFibreFastModel, and for the
+/// captures of EEShashTileFastModel, which are re-emitted in the fibre.
+
+class EEShashFibreTable
+{
+  public:
+    EEShashFibreTable(G4double fibreLength, G4int nZ = 42, G4int nCos = 20,
+                      G4int nLambda = 15, G4double lambdaMin = 400.,
+                      G4double lambdaMax = 700.);
+    ~EEShashFibreTable();
+
+    static EEShashFibreTable* Instance() { return fInstance; }
+
+    // bin index, -1 if the photon is outside the table
+    G4int GetBin(G4double distance, G4double cosTheta, G4double lambda) const;
+
+    // calibration
+    void ClearPending() { GetPending().clear(); GetChains().clear(); }
+    void RecordBirth(G4int trackID, G4int parentID, G4int bin,
+                     G4double time);
+    void RecordArrival(G4int trackID, G4double time);
+
+    // fast simulation: true if the photon arrives, with its delay
+    G4bool SampleArrival(G4double distance, G4double cosTheta, G4double lambda,
+                         G4double& delay) const;
+    // fast simulation of a WLS emission at a distance from the readout with
+    // the direction and wavelength of the calibration photons emitted there
+    // (Load() only): true if the photon arrives, with its wavelength [nm]
+    // and delay
+    G4bool SampleEmission(G4double distance, G4double& lambda,
+                          G4double& delay) const;
+
+    G4double GetEfficiency(G4int bin) const;
+    G4double GetFibreLength() const { return fFibreLength; }
+
+    void Write(const G4String& fileName) const;
+    void Load(const G4String& fileName);
+
+  private:
+    G4double SampleDelay(G4int bin) const;
+
+    static EEShashFibreTable* fInstance;
+
+    G4double fFibreLength;  // length of the fibre core, distance range
+    G4int    fNZ;           // bins in distance to the readout end
+    G4int    fNCos;         // bins in direction cosine, -1 to 1
+    G4int    fNLambda;      // bins in wavelength [nm]
+    G4double fLambdaMin;
+    G4double fLambdaMax;
+
+    std::vector<G4double> fGenerated;  // photons emitted per bin
+    std::vector<G4double> fArrived;    // photons arrived per bin
+    std::vector<G4double> fSumDelay;   // sum of delays [ns]
+    std::vector<G4double> fSumDelay2;  // sum of squared delays [ns^2]
+
+    // per distance bin, photons emitted and, bin by bin, running sum of the
+    // photons arrived, for SampleEmission(); made by Load()
+    std::vector<G4double> fSliceGenerated;
+    std::vector<G4double> fSliceArrived;
+
+    // calibration: track ID of the first photon of a chain -> (bin,
+    // emission time) while none of the chain arrived, and track ID of each
+    // photon of a chain -> first photon; one map per thread since track IDs
+    // are per event; the bin contents are shared and updated under a mutex
+    typedef std::map<G4int, std::pair<G4int,G4double> > PendingMap;
+    typedef std::map<G4int, G4int> ChainMap;
+    static PendingMap& GetPending();
+    static ChainMap& GetChains();
+    static G4ThreadLocal PendingMap* fPending;
+    static G4ThreadLocal ChainMap* fChains;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
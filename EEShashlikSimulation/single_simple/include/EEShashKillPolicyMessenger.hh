@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashKillPolicyMessenger.hh
+/// \brief Definition of the EEShashKillPolicyMessenger class
+
+#ifndef EEShashKillPolicyMessenger_h
+#define EEShashKillPolicyMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+/// Messenger of the optical photon kill policies (EEShashOpticalKillPolicy)
+///
+/// Commands in /EEShash/killPolicy/, 0 switches a policy off:
+/// - timeWindow <t> <unit>   : end of the readout window, photons later than
+///                             it are killed or not tracked at all
+/// - maxSteps <n>            : steps of any photon
+/// - maxVertexSteps <role> <n> : steps of the photons born in a volume role
+///                             (other, act, fibre, grease, apd)
+/// - maxPathLength <l> <unit> : path length of any photon
+/// - maxBounces <role> <n>   : boundary hits while travelling in a volume
+///                             role
+/// - timing <bool>           : CPU time of the killed photons
+///
+/// The limits are shared by the threads and set by the master only.
+
+class EEShashKillPolicyMessenger : public G4UImessenger
+{
+  public:
+    EEShashKillPolicyMessenger();
+    virtual ~EEShashKillPolicyMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    G4UIcommand* MakeRoleCommand(const char* name, const char* guidance);
+
+    G4UIdirectory*             fKillPolicyDir;
+    G4UIcmdWithADoubleAndUnit* fTimeWindowCmd;
+    G4UIcmdWithAnInteger*      fMaxStepsCmd;
+    G4UIcommand*               fMaxVertexStepsCmd;
+    G4UIcmdWithADoubleAndUnit* fMaxPathLengthCmd;
+    G4UIcommand*               fMaxBouncesCmd;
+    G4UIcmdWithABool*          fTimingCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
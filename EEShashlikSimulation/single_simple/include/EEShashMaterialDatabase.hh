@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashMaterialDatabase.hh
+/// \brief Definition of the EEShashMaterialDatabase class
+
+#ifndef EEShashMaterialDatabase_h
+#define EEShashMaterialDatabase_h 1
+
+#include "globals.hh"
+
+#include <vector>
+#include <map>
+
+class G4Element;
+class G4Material;
+class G4MaterialPropertiesTable;
+
+/// Elements and optical properties of the materials
+///
+/// The elements are taken from the NIST database, so that each one is
+/// built once whichever material asks for it. The optical properties are
+/// read once from a versioned text file (opticalProperties.dat, or the file
+/// given by OPTICAL_PROPERTIES) into vectors already in Geant4 units and in
+/// increasing energy, from which the property tables of the materials are
+/// filled. The database is loaded on the master by the first call to
+/// Instance() and only read afterwards.
+
+class EEShashMaterialDatabase
+{
+  public:
+    static EEShashMaterialDatabase* Instance();
+    static void Delete();
+
+    // to be called before the first Instance()
+    static void SetFileName(const G4String& fileName) { fFileName = fileName; }
+    static const G4String& GetFileName() { return fFileName; }
+
+    G4Element* GetElement(const G4String& symbol) const;
+
+    // properties of the material section of the file: a new table is made
+    // for each call, since Geant4 materials own their tables
+    G4bool HasProperties(const G4String& section) const;
+    G4MaterialPropertiesTable* CreatePropertiesTable(const G4String& section) const;
+    void SetProperties(G4Material* material, const G4String& section) const;
+    void SetProperties(G4Material* material) const;
+
+  private:
+    explicit EEShashMaterialDatabase(const G4String& fileName);
+    ~EEShashMaterialDatabase() {}
+
+    void Load(const G4String& fileName);
+    static G4double GetUnit(const G4String& unit, const G4String& fileName);
+
+    struct Property {
+      G4String key;
+      std::vector<G4double> energy;  // increasing, Geant4 units
+      std::vector<G4double> value;   // Geant4 units
+    };
+    struct Section {
+      std::vector<Property> properties;
+      std::vector<std::pair<G4String,G4double> > constants;
+    };
+
+    std::map<G4String, Section> fSections;
+
+    static EEShashMaterialDatabase* fInstance;
+    static G4String fFileName;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashNavigationBenchmark.hh
+/// \brief Definition of the EEShashNavigationBenchmark class
+
+#ifndef EEShashNavigationBenchmark_h
+#define EEShashNavigationBenchmark_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4LogicalVolume;
+class EEShashNavigationMessenger;
+
+enum EEShashRayPattern {
+  kBeamRays,       // parallel to the beam on a square grid, slightly tilted
+  kIsotropicRays   // from one point in all directions
+};
+
+/// Timing of the Geant4 navigation in the constructed geometry
+///
+/// Scan() follows straight rays through the world with a private
+/// G4Navigator, as the transportation does but without the tracking and
+/// physics, and reports the time per step, the steps in each logical
+/// volume and the smart voxels of the volumes crossed. The rays are
+/// - geantinos: followed from boundary to boundary until they leave,
+/// - optical photons: reflected back at each boundary, as on a polished
+///   surface, for a given number of bounces, then followed as geantinos;
+///   with the isotropic pattern from inside a tile this is the navigation
+///   of the scintillation light.
+/// The smartless and optimisation of the logical volumes can be changed
+/// before a scan to tune the voxels of a detector variant; the geometry
+/// is optimised again at once. Commands in /EEShash/navigation/, see
+/// EEShashNavigationMessenger. To be used on the master, in Idle state.
+
+class EEShashNavigationBenchmark
+{
+  public:
+    EEShashNavigationBenchmark();
+    ~EEShashNavigationBenchmark();
+
+    void SetPattern(G4int pattern)             { fPattern = pattern; }
+    void SetOptical(G4bool optical)            { fOptical = optical; }
+    void SetHalfWidth(G4double halfWidth)      { fHalfWidth = halfWidth; }
+    void SetOrigin(const G4ThreeVector& origin) { fOrigin = origin; }
+    void SetMaxBounces(G4int bounces)          { fMaxBounces = bounces; }
+
+    void Scan(G4int nRays) const;
+
+    // voxel tuning; volume is a logical volume name or "all"
+    void SetSmartless(const G4String& volume, G4double smartless);
+    void SetOptimisation(const G4String& volume, G4bool optimise);
+    // volumes with fewer daughters are not voxelised
+    void SetVoxelLimit(G4int minDaughters);
+    void PrintVoxelStatistics(const std::vector<G4long>* steps = 0) const;
+
+  private:
+    void MakeRay(G4int ray, G4int nRays, G4double zStart,
+                 G4ThreeVector& point, G4ThreeVector& direction) const;
+    std::vector<G4LogicalVolume*> FindVolumes(const G4String& volume) const;
+    void Reoptimise() const;
+
+    G4int         fPattern;     // EEShashRayPattern
+    G4bool        fOptical;     // optical photons instead of geantinos
+    G4double      fHalfWidth;   // of the grid of the beam pattern
+    G4ThreeVector fOrigin;      // of the isotropic pattern
+    G4int         fMaxBounces;  // reflections of an optical photon
+    EEShashNavigationMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashNavigationMessenger.hh
+/// \brief Definition of the EEShashNavigationMessenger class
+
+#ifndef EEShashNavigationMessenger_h
+#define EEShashNavigationMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EEShashNavigationBenchmark;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWith3VectorAndUnit;
+class G4UIcmdWithoutParameter;
+
+/// Messenger of EEShashNavigationBenchmark, in /EEShash/navigation/:
+/// - scan <nRays>              : runs the benchmark
+/// - pattern beam|isotropic    : rays along the beam or from one point
+/// - particle geantino|opticalphoton
+/// - halfWidth <w> <unit>      : of the grid of the beam pattern
+/// - origin <x> <y> <z> <unit> : of the isotropic pattern
+/// - bounces <n>               : reflections of an optical photon
+/// - smartless <volume> <s>    : G4LogicalVolume::SetSmartless
+/// - optimise <volume> <bool>  : G4LogicalVolume::SetOptimisation
+/// - voxelLimit <n>            : no voxels for fewer daughters
+/// - voxelStats                : voxels of the volumes
+/// <volume> is a logical volume name or "all".
+
+class EEShashNavigationMessenger : public G4UImessenger
+{
+  public:
+    EEShashNavigationMessenger(EEShashNavigationBenchmark* benchmark);
+    virtual ~EEShashNavigationMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    EEShashNavigationBenchmark* fBenchmark;
+    G4UIdirectory*             fNavigationDir;
+    G4UIcmdWithAnInteger*      fScanCmd;
+    G4UIcmdWithAString*        fPatternCmd;
+    G4UIcmdWithAString*        fParticleCmd;
+    G4UIcmdWithADoubleAndUnit* fHalfWidthCmd;
+    G4UIcmdWith3VectorAndUnit* fOriginCmd;
+    G4UIcmdWithAnInteger*      fBouncesCmd;
+    G4UIcommand*               fSmartlessCmd;
+    G4UIcommand*               fOptimiseCmd;
+    G4UIcmdWithAnInteger*      fVoxelLimitCmd;
+    G4UIcmdWithoutParameter*   fVoxelStatsCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalKillPolicy.hh
+/// \brief Definition of the EEShashOpticalKillPolicy class
+
+#ifndef EEShashOpticalKillPolicy_h
+#define EEShashOpticalKillPolicy_h 1
+
+#include "globals.hh"
+#include "EEShashDetectorConstruction.hh"
+
+class G4Step;
+class G4Track;
+
+const G4int kNofVolumeRoles = kAPDVolume+1;
+
+/// Policies which stop the tracking of optical photons
+enum EEShashKillPolicy {
+  kNoKill = -1,
+  kKillTimeWindow = 0, // global time beyond the end of the readout window
+  kKillMaxSteps,       // steps of the photon
+  kKillVertexSteps,    // steps of a photon born in a given volume role
+  kKillPathLength,     // path length of the photon
+  kKillBounces,        // boundary hits while travelling in a volume role
+  kNofKillPolicies
+};
+
+/// Stops optical photons which cannot or should not contribute to the
+/// readout
+///
+/// SteppingAction asks Apply() at each step of an optical photon whether
+/// it is to be killed, EEShashStackingAction asks ApplyAtBirth() for the
+/// new ones, so that photons born after the readout window are not tracked
+/// at all. A limit of 0 switches its policy off. The defaults are those of
+/// the former hard-coded cuts: 70000 steps for every photon and 600 steps
+/// for the photons born in the CeF3, no time window. In waveform mode main
+/// sets the time window to the end of the waveform (EEShashWaveform::
+/// GetTMax()). While a light table is calibrated only the step limit is
+/// applied.
+///
+/// For each policy the photons it killed are counted, with their weight,
+/// the steps they were tracked and the CPU time of the thread spent on
+/// them from the start of their tracking (BeginOfTrack()) to the kill.
+/// This is what the photons cost before the policy stopped them, not the
+/// time the policy saved, which depends on the steps they would still
+/// have made. The counters
+/// are per thread, merged at the end of the run of each thread; the
+/// master prints them.
+///
+/// The limits are shared by the threads and set by the master, see
+/// EEShashKillPolicyMessenger.
+
+class EEShashOpticalKillPolicy
+{
+  public:
+    static void SetTimeWindow(G4double tMax) { fTimeWindow = tMax; }
+    static void SetMaxSteps(G4int n) { fMaxSteps = n; }
+    static void SetMaxVertexSteps(G4int role, G4int n) { fMaxVertexSteps[role] = n; }
+    static void SetMaxPathLength(G4double length) { fMaxPathLength = length; }
+    static void SetMaxBounces(G4int role, G4int n) { fMaxBounces[role] = n; }
+    static void SetCalibration(G4bool calibration) { fCalibration = calibration; }
+    static void SetTiming(G4bool timing) { fTiming = timing; }
+
+    static G4double GetTimeWindow() { return fTimeWindow; }
+    static const char* GetPolicyName(G4int policy);
+    static const char* GetRoleName(G4int role);
+    static G4int GetRole(const G4String& name);  // -1 if unknown
+
+    // from the user actions
+    static void BeginOfTrack();
+    static G4int ApplyAtBirth(const G4Track* track);
+    static G4int Apply(const G4Step* step, EEShashVolumeRole vertexRole,
+                       EEShashVolumeRole preRole);
+
+    // from EEShashRunAction::EndOfRunAction()
+    static void EndOfThreadRun();
+    static void Print();
+
+  private:
+    struct Counters {
+      Counters() : fPhotons(0), fWeight(0.), fSteps(0), fCPUBeforeKill(0.) {}
+      G4long   fPhotons;
+      G4double fWeight;
+      G4long   fSteps;
+      G4double fCPUBeforeKill;  // tracking time up to the kill [s]
+    };
+
+    struct ThreadState {
+      ThreadState() : fStart(0.) {
+        for ( G4int i = 0; i < kNofVolumeRoles; ++i ) fBounces[i] = 0;
+      }
+      G4int    fBounces[kNofVolumeRoles];  // of the current track
+      G4double fStart;                     // CPU time at its start [s]
+      Counters fCounters[kNofKillPolicies];
+    };
+
+    static ThreadState& GetState();
+    static G4double CPUTime();
+    static void Record(ThreadState& state, G4int policy, const G4Track* track);
+
+    static G4double fTimeWindow;
+    static G4int    fMaxSteps;
+    static G4int    fMaxVertexSteps[kNofVolumeRoles];
+    static G4double fMaxPathLength;
+    static G4int    fMaxBounces[kNofVolumeRoles];
+    static G4bool   fCalibration;
+    static G4bool   fTiming;
+
+    static G4ThreadLocal ThreadState* fState;
+    static Counters fMerged[kNofKillPolicies];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalMessenger.hh
+/// \brief Definition of the EEShashOpticalMessenger class
+
+#ifndef EEShashOpticalMessenger_h
+#define EEShashOpticalMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4EmUserPhysics;
+class G4UIdirectory;
+class G4UIcmdWithADouble;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+/// Messenger of the optical photon options of G4EmUserPhysics
+///
+/// Commands in /EEShash/optical/:
+/// - thinning <factor> : generate 1/factor of the scintillation photons,
+///                       each with a statistical weight of factor
+/// - qeAtBirth <bool>    : play the photodetector QE when a WLS photon is
+///                       created (EEShashStackingAction) rather than at
+///                       the fibre end; can be changed between runs
+/// - cerenkovWindow <min> <max> : wavelength range [nm] in which Cerenkov
+///                       photons are generated
+/// - photonBudget <n>    : target number of tracked optical photons per
+///                       event, see EEShashStackingAction; 0 disables it
+/// - timeStep <t> <unit> : time quantum of the Photon_time branch of
+///                       CreateTree, 65535 steps cover its range
+
+class EEShashOpticalMessenger : public G4UImessenger
+{
+  public:
+    EEShashOpticalMessenger(G4EmUserPhysics* physics);
+    virtual ~EEShashOpticalMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    G4EmUserPhysics*    fPhysics;
+    G4UIdirectory*      fOpticalDir;
+    G4UIcmdWithADouble* fThinningCmd;
+    G4UIcmdWithABool*   fQEAtBirthCmd;
+    G4UIcommand*        fCerenkovWindowCmd;
+    G4UIcmdWithAnInteger* fPhotonBudgetCmd;
+    G4UIcmdWithADoubleAndUnit* fTimeStepCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOutputMessenger.hh
+/// \brief Definition of the EEShashOutputMessenger class
+
+#ifndef EEShashOutputMessenger_h
+#define EEShashOutputMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+
+/// Messenger of the CreateTree output options
+///
+/// Commands in /EEShash/output/, for the next run:
+/// - compression <algorithm> <level> [branch] : zlib, lzma, lz4 or zstd
+///                       (as far as the ROOT version has them) and level
+///                       1-9, of one branch or of all ("*", the default)
+/// - basketSize <bytes>  : basket size of all branches, 0 for ROOT's
+/// - autoFlush <n>       : TTree::SetAutoFlush(), entries if positive,
+///                       bytes if negative, 0 for ROOT's
+/// - writerDepth <n>     : events that can wait for the background writer
+///                       (EEShashTreeWriter, sequential mode), 0 writes on
+///                       the simulation thread
+///
+/// The settings are shared by the threads and set by the master only.
+
+class EEShashOutputMessenger : public G4UImessenger
+{
+  public:
+    EEShashOutputMessenger();
+    virtual ~EEShashOutputMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    G4UIdirectory*        fOutputDir;
+    G4UIcommand*          fCompressionCmd;
+    G4UIcmdWithAnInteger* fBasketSizeCmd;
+    G4UIcmdWithAnInteger* fAutoFlushCmd;
+    G4UIcmdWithAnInteger* fWriterDepthCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
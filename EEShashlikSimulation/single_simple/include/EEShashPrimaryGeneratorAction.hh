@@ -33,11 +33,11 @@
 
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "globals.hh"
-#include "TRandom3.h"
 #include <CLHEP/Random/RandGeneral.h>
 
 class G4ParticleGun;
 class G4Event;
+class EEShashShowerSource;
 
 /// The primary generator action class with particle gum.
 ///
@@ -45,6 +45,11 @@ class G4Event;
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class 
 /// (see the macros provided with this example).
+///
+/// When an EEShashShowerLibrary is replayed, the particle is not shot:
+/// a stored shower of the same particle and energy, from the impact bin
+/// nearest to the beam position, is moved to the beam position and its
+/// optical photons are generated by an EEShashShowerSource.
 
 class EEShashPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -62,7 +67,7 @@ public:
 
 private:
   G4ParticleGun*  fParticleGun; // G4 particle gun
-  TRandom3* rand_;
+  EEShashShowerSource* fShowerSource; // library showers, when replayed
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,116 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashProfiler.hh
+/// \brief Definition of the EEShashProfiler class
+
+#ifndef EEShashProfiler_h
+#define EEShashProfiler_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <string>
+
+class G4Step;
+class G4Track;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+
+/// Steps, tracks and CPU time per logical volume, particle and creator
+/// process
+///
+/// Filled by EEShashProfilingSteppingAction and
+/// EEShashProfilingTrackingAction, which are put in front of the stepping
+/// and tracking actions when a report file is set (PROFILE=<file> in
+/// main). Every step is counted; the CPU time of the thread is read at
+/// one step in fSampling only, and the time until the next step goes to
+/// that next step, or, at the end of a track, from the start of the next
+/// track to its first step. The sampled time of each key is scaled by its
+/// steps over its sampled steps. The counters are per thread, keyed by
+/// pointers, and merged by name at the end of the run of each thread; the
+/// master writes the report at the end of the run, as JSON if the file
+/// name ends in .json and as CSV otherwise, and prints the largest entries.
+
+class EEShashProfiler
+{
+  public:
+    static void SetReportFile(const G4String& fileName, G4int sampling = 64);
+    static G4bool IsEnabled() { return ! fReportFile.empty(); }
+
+    static void RecordStep(const G4Step* step);
+    static void RecordTrack(const G4Track* track);
+
+    // from EEShashRunAction::EndOfRunAction(): each thread merges its
+    // counters, the master then writes the report
+    static void EndOfThreadRun();
+    static void WriteReport();
+
+  private:
+    struct Counters {
+      Counters() : fTracks(0), fSteps(0), fSamples(0), fCPUTime(0.) {}
+      G4long   fTracks;
+      G4long   fSteps;
+      G4long   fSamples;  // steps with a CPU time measurement
+      G4double fCPUTime;  // CPU time [s] of the sampled steps, scaled to
+                          // all the steps when merged
+    };
+
+    struct Key {
+      Key(const G4LogicalVolume* volume, const G4ParticleDefinition* particle,
+          const G4VProcess* creator)
+        : fVolume(volume), fParticle(particle), fCreator(creator) {}
+      bool operator<(const Key& other) const;
+      bool operator==(const Key& other) const;
+      const G4LogicalVolume*      fVolume;
+      const G4ParticleDefinition* fParticle;
+      const G4VProcess*           fCreator;   // 0 for the primaries
+    };
+
+    struct ThreadTable {
+      ThreadTable() : fLastKey(0,0,0), fLast(0), fCounter(0), fStart(-1.) {}
+      std::map<Key,Counters> fCounters;
+      Key       fLastKey;   // most steps follow one in the same volume
+      Counters* fLast;
+      G4long    fCounter;   // steps since the start of the run
+      G4double  fStart;     // CPU time of the sampled step, -1 if none
+    };
+
+    static ThreadTable& GetTable();
+    static Counters& Find(ThreadTable& table, const Key& key);
+    static G4double CPUTime();
+
+    static G4String fReportFile;
+    static G4int    fSampling;
+    static G4ThreadLocal ThreadTable* fTable;
+
+    // "volume particle creator" -> counters of all threads
+    static std::map<std::string,Counters> fMerged;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -55,6 +55,17 @@ class G4Run;
 /// In EndOfRunAction(), the accumulated statistic and computed 
 /// dispersion is printed.
 ///
+/// In multi-threaded mode each worker fills its own CreateTree in memory
+/// chunks which EEShashTreeMerger writes to the output file of main(); the
+/// master waits in EndOfRunAction() until the run is written. In
+/// sequential mode the tree is written by EEShashTreeWriter.
+///
+/// With profiling on, EndOfRunAction() also merges the counters of the
+/// thread into EEShashProfiler, and the master writes its report. The
+/// same goes for the throughput and memory of EEShashRunTelemetry, whose
+/// JSON report is written next to the ROOT file, and for the optical
+/// photons killed by EEShashOpticalKillPolicy.
+///
 
 class EEShashRunAction : public G4UserRunAction
 {
@@ -66,7 +77,6 @@ class EEShashRunAction : public G4UserRunAction
     virtual void   EndOfRunAction(const G4Run*);
 
   private:
-    
     //TFile* hitsFile_;    
     //TTree* hitsTree_;
     //unsigned int nLayers_;
@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashRunTelemetry.hh
+/// \brief Definition of the EEShashRunTelemetry class
+
+#ifndef EEShashRunTelemetry_h
+#define EEShashRunTelemetry_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+
+class G4Event;
+class G4Run;
+
+/// Throughput and memory of a run
+///
+/// The event, primary and optical photon counters are per thread and are
+/// added to the totals of the run at the end of each event, together with
+/// the wall time of the event. The photons are counted when they are
+/// created (EEShashStackingAction, before any of them is killed), when
+/// they start to be tracked (TrackingAction) and when they are detected
+/// (EEShashEventAction, sum of the weights of the optical hits).
+///
+/// At the end of the run each thread adds the pool sizes of its
+/// G4Allocators, and the master writes <output>.run<N>.telemetry.json next
+/// to the ROOT file (SetOutput() in main): the rates, the p50/p95/max of
+/// the event wall times, the peak RSS of the process, the pool sizes and
+/// the bytes the output files grew by during the run. With an interval
+/// set, the totals are also appended every interval seconds of wall time
+/// to <output>.run<N>.samples.jsonl, one JSON object per line.
+
+class EEShashRunTelemetry
+{
+  public:
+    // output is the ROOT file; interval [s] of the samples, 0 for none
+    static void SetOutput(const G4String& outputFile, G4double interval = 0.);
+    // other files whose growth counts as output, e.g. the column export
+    static void AddOutputFile(const G4String& fileName);
+    static G4bool IsEnabled() { return ! fStem.empty(); }
+
+    // from the user actions
+    static void BeginOfRun(G4int runID);
+    static void BeginOfEvent();
+    static void EndOfEvent(const G4Event* event);
+    static void PhotonCreated() { if ( IsEnabled() ) ++GetCounters().fCreated; }
+    static void PhotonTracked() { if ( IsEnabled() ) ++GetCounters().fTracked; }
+    static void PhotonsDetected(G4double weight)
+      { if ( IsEnabled() ) GetCounters().fDetected += weight; }
+
+    // from EEShashRunAction::EndOfRunAction(): each thread adds its pool
+    // sizes, the master then writes the report
+    static void EndOfThreadRun();
+    static void WriteReport(const G4Run* run);
+
+  private:
+    struct Counters {
+      Counters() : fStart(0.), fCreated(0), fTracked(0), fDetected(0.) {}
+      G4double fStart;     // wall time at the start of the event [s]
+      G4long   fCreated;
+      G4long   fTracked;
+      G4double fDetected;
+    };
+
+    static Counters& GetCounters();
+    static G4double WallTime();
+    static G4double PeakRSS();      // [MB]
+    static G4long OutputBytes();
+    static void WriteSample(G4double now);
+
+    static G4String fStem;         // ROOT file name without .root
+    static G4double fInterval;
+    static std::vector<G4String> fOutputFiles;
+    static G4ThreadLocal Counters* fCounters;
+
+    // totals of the run, updated under a mutex
+    static G4double fRunStart;
+    static G4double fNextSample;
+    static G4long   fStartBytes;
+    static G4long   fEvents;
+    static G4long   fPrimaries;
+    static G4long   fCreated;
+    static G4long   fTracked;
+    static G4double fDetected;
+    static G4int    fThreads;
+    static std::vector<G4float> fEventTimes;      // [s]
+    static std::map<std::string,G4double> fPools;  // allocator -> bytes
+    static std::ofstream* fSamples;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,173 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashShowerLibrary.hh
+/// \brief Definition of the EEShashShowerLibrary class and its file format
+
+#ifndef EEShashShowerLibrary_h
+#define EEShashShowerLibrary_h 1
+
+#include "globals.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <stdint.h>
+#include <cstdio>
+#include <vector>
+
+class G4Step;
+class G4Event;
+
+/// Frozen-shower library file, native byte order:
+/// - EEShashShowerLibraryHeader at offset 0
+/// - the deposits of each shower, one EEShashShowerDeposit per step
+/// - at indexOffset, nBins EEShashShowerBin entries followed by the
+///   nShowers EEShashShowerEntry entries, sorted by bin so that the showers
+///   of a bin are contiguous
+
+struct EEShashShowerLibraryHeader
+{
+  char     magic[8];      // "EESHLIB"
+  uint32_t version;       // 1
+  uint32_t nBins;
+  uint64_t nShowers;
+  uint64_t indexOffset;
+  float    impactStep;    // size of the impact bins [mm]
+  uint32_t reserved;
+};
+
+/// One step of a charged or depositing particle in a CeF3 tile
+struct EEShashShowerDeposit
+{
+  float x, y, z, t;       // pre-step point [mm, ns]
+  float dx, dy, dz, dt;   // post - pre step point [mm, ns]
+  float edep;             // visible energy after Birks [MeV]
+  float beta;             // mean of pre and post step, 0 if neutral
+  float charge;           // [eplus]
+};
+
+/// Particle, energy and impact bin of the primaries
+struct EEShashShowerBin
+{
+  int32_t  pdg;
+  float    energy;        // primary kinetic energy [MeV]
+  int32_t  ix, iy;        // impact position / impactStep, floored
+  uint64_t firstShower;
+  uint64_t nShowers;
+};
+
+struct EEShashShowerEntry
+{
+  uint64_t offset;        // of the first deposit
+  uint32_t nDeposits;
+  int32_t  pdg;
+  float    energy;        // [MeV]
+  float    impactX;       // primary vertex [mm]
+  float    impactY;
+  float    edep;          // sum of the deposits [MeV]
+};
+
+/// Library of frozen showers for optical parameter scans
+///
+/// Recording (SHOWER_LIBRARY_RECORD=<file>): SteppingAction passes every
+/// step of a charged or depositing particle in a CeF3 tile to RecordStep(),
+/// which keeps it in a buffer of the calling thread; EndOfEvent() appends
+/// the shower to the file under a mutex, keyed by the PDG code, kinetic
+/// energy and impact position of the primary. Close(), called by the
+/// destructor, sorts the showers into bins and writes the index.
+///
+/// Replay (SHOWER_LIBRARY=<file>): the file is mapped read-only and shared
+/// by all threads. FindBin() looks up the bin of a primary, SampleShower()
+/// picks one of its showers at random and GetDeposits() returns them as an
+/// array into the mapping, so only the pages of the showers replayed are
+/// read. EEShashShowerSource turns them into optical photons.
+
+class EEShashShowerLibrary
+{
+  public:
+    enum { kRecord = 0, kReplay };
+
+    EEShashShowerLibrary(const G4String& fileName, G4int mode,
+                         G4double impactStep = 2.*mm);
+    ~EEShashShowerLibrary();
+
+    static EEShashShowerLibrary* Instance() { return fInstance; }
+
+    G4bool IsRecording() const { return fMode == kRecord; }
+    G4bool IsReplaying() const { return fMode == kReplay; }
+
+    // recording
+    void BeginOfEvent() { GetBuffer().clear(); }
+    void RecordStep(const G4Step* step);
+    void EndOfEvent(const G4Event* event);
+    void Close();
+
+    // replay: bin of the same particle and energy with the nearest impact
+    // position, at most one bin away, -1 if there is none
+    G4int FindBin(G4int pdg, G4double energy, G4double x, G4double y) const;
+    const EEShashShowerEntry* SampleShower(G4int bin) const;
+    const EEShashShowerDeposit* GetDeposits(const EEShashShowerEntry& shower) const
+    {
+      return reinterpret_cast<const EEShashShowerDeposit*>(fBase + shower.offset);
+    }
+    G4int GetNofBins() const { return Header().nBins; }
+    uint64_t GetNofShowers() const { return Header().nShowers; }
+
+  private:
+    const EEShashShowerLibraryHeader& Header() const
+    {
+      return *reinterpret_cast<const EEShashShowerLibraryHeader*>(fBase);
+    }
+    const EEShashShowerBin* Bins() const
+    {
+      return reinterpret_cast<const EEShashShowerBin*>(fBase + Header().indexOffset);
+    }
+    const EEShashShowerEntry* Showers() const
+    {
+      return reinterpret_cast<const EEShashShowerEntry*>(Bins() + Header().nBins);
+    }
+    void Map();
+
+    static EEShashShowerLibrary* fInstance;
+
+    G4String fFileName;
+    G4int    fMode;
+    G4double fImpactStep;
+
+    // recording: the deposits of the current event, one buffer per thread
+    typedef std::vector<EEShashShowerDeposit> Buffer;
+    static Buffer& GetBuffer();
+    static G4ThreadLocal Buffer* fBuffer;
+    FILE*    fFile;
+    uint64_t fOffset;
+    std::vector<EEShashShowerEntry> fShowers;
+
+    // replay
+    const char* fBase;
+    size_t      fSize;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
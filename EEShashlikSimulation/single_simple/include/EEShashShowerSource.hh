@@ -0,0 +1,182 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashShowerSource.hh
+/// \brief Definition of the EEShashShowerSource class
+
+#ifndef EEShashShowerSource_h
+#define EEShashShowerSource_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4VUserPrimaryParticleInformation.hh"
+#include "G4MaterialPropertyVector.hh"
+#include "G4TrackVector.hh"
+
+#include <stdint.h>
+#include <vector>
+
+class G4Event;
+class G4Track;
+class G4Navigator;
+class G4VProcess;
+struct EEShashShowerEntry;
+struct EEShashShowerDeposit;
+
+/// Creator process and weight of an optical photon of a library shower
+class EEShashShowerPhotonInformation : public G4VUserPrimaryParticleInformation
+{
+  public:
+    EEShashShowerPhotonInformation(const G4VProcess* process, G4double weight)
+     : fProcess(process), fWeight(weight) {}
+
+    virtual void Print() const;
+
+    const G4VProcess* GetProcess() const { return fProcess; }
+    G4double GetWeight() const { return fWeight; }
+
+  private:
+    const G4VProcess* fProcess;
+    G4double fWeight;
+};
+
+/// Optical photons of a frozen shower from EEShashShowerLibrary
+///
+/// GeneratePhotons() plays the scintillation and Cerenkov processes of the
+/// physics list on the deposits of a library shower, with the CeF3
+/// properties of the tiles: the scintillation photons follow G4Scintillation
+/// (yield on the visible energy divided by the thinning factor, Gaussian or
+/// Poisson fluctuations, FASTCOMPONENT/SLOWCOMPONENT spectra and decay
+/// times, isotropic) and the Cerenkov photons EEShashCerenkov (Frank-Tamm
+/// in the energy window of the process, cone around the step), along the
+/// step each photon comes from.
+///
+/// A shower easily makes millions of photons, so they are not all made at
+/// once: GeneratePhotons() makes the photons of the first deposits, about
+/// 10000 of them, each a primary of its own vertex, and
+/// GenerateNextPhotons() the next chunk of deposits as tracks without a
+/// parent, stacked when the stacking action starts a new stage, i.e. once
+/// the previous chunk is tracked. The memory of an event stays bounded
+/// whatever the thinning factor.
+///
+/// PrepareTrack(), called by the stacking action for the primary photons,
+/// gives them the creator process, TrackInformation (with the weight of a
+/// thinned scintillation photon) and touchable a photon made by the
+/// process itself would have, so that the stacking, readout and kill
+/// policies treat both alike. The photons of the later chunks get them
+/// when they are made.
+///
+/// One source per thread, owned by the primary generator action.
+
+class EEShashShowerSource
+{
+  public:
+    EEShashShowerSource();
+    ~EEShashShowerSource();
+
+    // the optical processes switched on in the physics list
+    static void SetProcesses(G4bool scintillation, G4bool cerenkov)
+    {
+      fScintillationOn = scintillation;
+      fCerenkovOn = cerenkov;
+    }
+
+    // primary photons of the first chunk of the shower with its deposits
+    // moved by shift, returns their number
+    G4int GeneratePhotons(G4Event* event, const EEShashShowerEntry& shower,
+                          const EEShashShowerDeposit* deposits,
+                          const G4ThreeVector& shift);
+    // stacks the photons of the next chunk, false once the shower is done
+    G4bool GenerateNextPhotons();
+
+    // the source of the shower of the current event of this thread, if any
+    static EEShashShowerSource* GetCurrent() { return fCurrent; }
+
+    static void PrepareTrack(G4Track* track);
+
+  private:
+    void Initialise();
+    void BuildSpectrum(const G4MaterialPropertyVector* component,
+                       std::vector<G4double>& energy,
+                       std::vector<G4double>& cdf);
+    G4double SampleSpectrum(const std::vector<G4double>& energy,
+                            const std::vector<G4double>& cdf) const;
+    G4double GetCerenkovPhotonsPerLength(G4double beta) const;
+
+    G4int GenerateChunk();
+    void GenerateScintillation(const EEShashShowerDeposit& deposit,
+                               const G4ThreeVector& position,
+                               const G4ThreeVector& delta);
+    void GenerateCerenkov(const EEShashShowerDeposit& deposit,
+                          const G4ThreeVector& position,
+                          const G4ThreeVector& delta);
+    void AddPhoton(const G4ThreeVector& position,
+                   G4double time, G4double energy,
+                   const G4ThreeVector& direction,
+                   const G4ThreeVector& polarisation,
+                   const G4VProcess* process, G4double weight);
+    static void SetUpTrack(G4Track* track, const G4VProcess* process,
+                           G4double weight);
+
+    static G4bool fScintillationOn;
+    static G4bool fCerenkovOn;
+    static G4ThreadLocal G4Navigator* fNavigator;
+    static G4ThreadLocal EEShashShowerSource* fCurrent;
+
+    G4bool fInitialised;
+
+    // the shower being generated: the primaries go to fEvent, the photons
+    // of the later chunks to fTracks
+    const EEShashShowerDeposit* fDeposits;
+    uint32_t      fNofDeposits;
+    uint32_t      fNextDeposit;
+    G4ThreeVector fShift;
+    G4Event*      fEvent;
+    G4TrackVector fTracks;
+    G4int         fNofPhotons;
+    const G4VProcess* fScintillationProcess;
+    const G4VProcess* fCerenkovProcess;
+
+    // scintillation of the CeF3
+    G4double fYield;             // per energy, with the thinning
+    G4double fResolutionScale;
+    G4double fYieldRatio;        // fast component
+    G4double fFastTime;
+    G4double fSlowTime;
+    std::vector<G4double> fFastEnergy, fFastCDF;
+    std::vector<G4double> fSlowEnergy, fSlowCDF;
+
+    // Cerenkov: photons per length of a unit charge, tabulated in beta
+    G4MaterialPropertyVector* fRindex;
+    G4double fCerenkovEnergyMin;
+    G4double fCerenkovEnergyMax;
+    G4double fMaxRindex;
+    G4double fBetaMin;
+    std::vector<G4double> fCerenkovPerLength;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashStackingAction.hh
+/// \brief Definition of the EEShashStackingAction class
+
+#ifndef EEShashStackingAction_h
+#define EEShashStackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+#include "EEShashDetectorConstruction.hh"
+
+class EEShashOpticalReadoutSD;
+
+/// Stacking action class
+///
+/// When the readout SD has SetQEAtBirth(true), every optical photon created
+/// by WLS is kept with the largest acceptance at the fibre end
+/// (EEShashOpticalReadoutSD::GetMaxAcceptance(), the same at any energy)
+/// and killed otherwise, before any of its propagation is paid for. The
+/// kept photons and their re-emissions are flagged in their
+/// TrackInformation; the readout accepts them with the ratio of the
+/// acceptance at their final energy to the largest one. Photons from the
+/// tiles are not affected.
+///
+/// With a photon budget (SetPhotonBudget(), /EEShash/optical/photonBudget)
+/// the optical photons of an event are split in strata by creation volume
+/// (CeF3 tile, fibre core, grease) and process (scintillation, WLS,
+/// Cerenkov), each stratum getting an equal share B of the budget. The
+/// first B photons of a stratum are tracked as usual; the n-th one after
+/// that is kept with probability B/n and its weight is multiplied by n/B,
+/// so the sums of weights stay unbiased while the number of tracked photons
+/// only grows as B(1 + ln(N/B)) with the N generated ones. Not applied
+/// while the fibre or tile tables are calibrated.
+///
+/// Photons born in a tile in fast simulation mode are handed to
+/// EEShashTileFastModel::CollectAtBirth() and killed before they are stacked,
+/// and before the photon budget applies.
+///
+/// NewStage() also stacks the next chunk of photons of a replayed library
+/// shower (EEShashShowerSource::GenerateNextPhotons()) whenever the urgent
+/// stack runs empty.
+
+class EEShashStackingAction : public G4UserStackingAction
+{
+  public:
+    EEShashStackingAction();
+    virtual ~EEShashStackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+    virtual void NewStage();
+    virtual void PrepareNewEvent();
+
+    // target number of tracked optical photons per event, 0 for no budget
+    static void SetPhotonBudget(G4int budget) { fPhotonBudget = budget; }
+    static G4int GetPhotonBudget() { return fPhotonBudget; }
+
+  private:
+    enum { kNofVolumeStrata = 3, kNofProcessStrata = 3 };
+
+    EEShashOpticalReadoutSD* GetReadout();
+    const EEShashDetectorConstruction* GetDetector();
+    G4bool ApplyQEAtBirth(const G4Track* track);
+    G4bool ApplyPhotonBudget(const G4Track* track);
+    G4int GetStratum(const G4Track* track);
+
+    static G4int fPhotonBudget;
+
+    const EEShashDetectorConstruction* fDetector;
+    EEShashOpticalReadoutSD* fReadout;
+    // photons generated in each stratum during the current event
+    G4int fNofGenerated[kNofVolumeStrata*kNofProcessStrata];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
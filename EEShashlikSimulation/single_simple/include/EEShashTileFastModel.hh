@@ -0,0 +1,118 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTileFastModel.hh
+/// \brief Definition of the EEShashTileFastModel class
+
+#ifndef EEShashTileFastModel_h
+#define EEShashTileFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4AffineTransform.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class EEShashTileTable;
+class EEShashFibreTable;
+class EEShashOpticalReadoutSD;
+class G4Track;
+
+/// Treatment of the optical photons in the CeF3 tiles
+enum EEShashTileMode {
+  kTileFullTracking = 0,  // full optical tracking, no fast simulation
+  kTileCalibration,       // full tracking, fill the EEShashTileTable
+  kTileFastSimulation     // fibre captures from the table, needs the
+                          // fibres in fast simulation mode
+};
+
+/// Fast simulation model of the light collection in the CeF3 tiles
+///
+/// Attached to the "TileRegion" envelope of the active tiles. Each optical
+/// photon emitted in a tile is looked up in the EEShashTileTable by
+/// position in the tile and wavelength. Its capture probabilities are added
+/// to the expected number of captures of each fibre (Capture_N in
+/// CreateTree), one capture is sampled with its delay (Fibre_capture,
+/// Time_capture) and the photon is killed, so that the bouncing inside the
+/// Tyvek-wrapped tile is never tracked.
+///
+/// A captured photon is re-emitted in its fibre at the depth it was born
+/// at: EEShashFibreTable::SampleEmission() decides whether the WLS photon
+/// reaches the readout, which counts it like any other (Fibre_N, EOpt_N,
+/// the photon times). The fibres are therefore in fast simulation mode too.
+///
+/// EEShashStackingAction hands the photons to CollectAtBirth() as they are
+/// created, so they are never stacked; the model itself only triggers, at
+/// their first step, on photons which bypassed the stacking action.
+///
+/// In calibration mode the model never triggers; it only records the birth
+/// of each photon in the table while the photon is tracked in full.
+
+class EEShashTileFastModel : public G4VFastSimulationModel
+{
+  public:
+    EEShashTileFastModel(const G4String& name, G4Region* envelope,
+                         EEShashTileTable* table, G4int mode,
+                         EEShashFibreTable* fibreTable,
+                         EEShashOpticalReadoutSD* readout);
+    virtual ~EEShashTileFastModel();
+
+    // methods from base class
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+    // model of this thread, 0 unless the tiles are in fast simulation mode
+    static EEShashTileFastModel* GetInstance() { return fInstance; }
+
+    // photon born in a tile, before it is stacked: true if the model took
+    // it, the photon is then to be killed
+    G4bool CollectAtBirth(const G4Track* track);
+
+    // frame of each fibre core, by copy number (global to local transform
+    // and half length), where the captured photons are re-emitted
+    void ClearFibres() { fFibreFrames.clear(); fFibreHalfLengths.clear(); }
+    void AddFibre(G4int fibre, const G4AffineTransform& frame,
+                  G4double halfLength);
+
+  private:
+    G4int GetBin(const G4Track* track,
+                 const G4ThreeVector& localPosition) const;
+    void  Collect(const G4Track* track, const G4ThreeVector& localPosition);
+
+    static G4ThreadLocal EEShashTileFastModel* fInstance;
+
+    G4Region*                fEnvelope;
+    EEShashTileTable*        fTable;
+    G4int                    fMode;
+    EEShashFibreTable*       fFibreTable;
+    EEShashOpticalReadoutSD* fReadout;
+    std::vector<G4AffineTransform> fFibreFrames;
+    std::vector<G4double>          fFibreHalfLengths;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTileTable.hh
+/// \brief Definition of the EEShashTileTable class
+
+#ifndef EEShashTileTable_h
+#define EEShashTileTable_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+#include <map>
+
+/// Light collection table of the CeF3 tiles
+///
+/// For an optical photon emitted in a tile, binned in the position inside
+/// the tile (x, y and z in the tile frame) and in wavelength, the table
+/// holds the probability that the photon is absorbed by the WLS dye of
+/// each of the fibres, and the mean and RMS of the delay between emission
+/// and absorption.
+///
+/// The table is filled in calibration mode with full optical tracking:
+/// RecordBirth() is called when a photon is emitted in a tile and
+/// RecordCapture() when its WLS re-emission appears in a fibre core.
+/// Write() saves it to a text file which Load() reads back for
+/// EEShashTileFastModel.
+
+class EEShashTileTable
+{
+  public:
+    EEShashTileTable(G4double sizeXY, G4double thickness, G4int nFibres = 4,
+                     G4int nXY = 17, G4int nZ = 6, G4int nLambda = 15,
+                     G4double lambdaMin = 400., G4double lambdaMax = 700.);
+    ~EEShashTileTable();
+
+    static EEShashTileTable* Instance() { return fInstance; }
+
+    // bin index, -1 if the photon is outside the table
+    G4int GetBin(const G4ThreeVector& localPosition, G4double lambda) const;
+
+    // calibration
+    void ClearPending() { GetPending().clear(); }
+    void RecordBirth(G4int trackID, G4int bin, G4double time);
+    void RecordCapture(G4int trackID, G4int fibre, G4double time);
+
+    // fast simulation: true if the photon is captured, with fibre and delay
+    G4bool SampleCapture(G4int bin, G4int& fibre, G4double& delay) const;
+
+    G4double GetCaptureProbability(G4int bin, G4int fibre) const;
+    G4int    GetNofFibres() const { return fNFibres; }
+    G4double GetSizeXY() const { return fSizeXY; }
+    G4double GetThickness() const { return fThickness; }
+
+    void Write(const G4String& fileName) const;
+    void Load(const G4String& fileName);
+
+  private:
+    void Reset();
+
+    static EEShashTileTable* fInstance;
+
+    G4double fSizeXY;     // transverse size of the tile
+    G4double fThickness;  // thickness of the tile
+    G4int    fNFibres;    // fibres the photons can be captured by
+    G4int    fNXY;        // bins in x and in y
+    G4int    fNZ;         // bins in z
+    G4int    fNLambda;    // bins in wavelength [nm]
+    G4double fLambdaMin;
+    G4double fLambdaMax;
+
+    std::vector<G4double> fGenerated;  // photons emitted per bin
+    std::vector<G4double> fCaptured;   // photons captured per bin and fibre
+    std::vector<G4double> fSumDelay;   // sum of delays [ns]
+    std::vector<G4double> fSumDelay2;  // sum of squared delays [ns^2]
+
+    // calibration: track ID -> (bin, emission time) of photons in flight,
+    // one map per thread since track IDs are per event; the bin contents
+    // are shared and updated under a mutex
+    typedef std::map<G4int, std::pair<G4int,G4double> > PendingMap;
+    static PendingMap& GetPending();
+    static G4ThreadLocal PendingMap* fPending;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTreeMerger.hh
+/// \brief Definition of the EEShashTreeMerger class
+
+#ifndef EEShashTreeMerger_h
+#define EEShashTreeMerger_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include "Rtypes.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+class TFile;
+class TMemFile;
+class TTree;
+class CreateTree;
+
+/// Single writer of the CreateTree output in multi-threaded mode
+///
+/// Each worker fills its CreateTree into an in-memory file (TMemFile).
+/// Every fChunkSize events, and at the end of its run, the worker writes
+/// the tree (compressing the baskets in the worker thread) and Ship()s the
+/// memory file to the merger, which only queues it: the simulation threads
+/// never wait for the output.
+///
+/// A writer thread owns the output file. It reads the chunks as they come
+/// and copies their entries to the output tree in increasing event number,
+/// holding back the events that arrive ahead of their turn. Flush(), called
+/// by the master at the end of a run, writes whatever is still held back
+/// and fills one entry per worker in the "threadStats" tree (events, chunks
+/// and compressed bytes). The result is one file, in deterministic order,
+/// with no hadd step.
+
+class EEShashTreeMerger
+{
+  public:
+    EEShashTreeMerger(const G4String& fileName, G4int chunkSize = 100);
+    ~EEShashTreeMerger();
+
+    static EEShashTreeMerger* Instance() { return fInstance; }
+
+    // worker side, called from the user actions of the worker threads
+    static void BeginOfWorkerRun();
+    static void EventFilled();
+    static void EndOfWorkerRun();
+
+    // master side: wait until the chunks of the run are written
+    void Flush();
+
+  private:
+    struct Chunk {
+      G4int     thread;
+      TMemFile* file;
+      TTree*    tree;
+      G4int     nofPending;  // entries not written yet
+    };
+    struct Message {
+      G4int     thread;
+      TMemFile* file;        // 0 for a flush request
+      G4int     nofEvents;
+      Long64_t  bytes;
+    };
+    struct ThreadStats {
+      ThreadStats() : events(0), chunks(0), bytes(0) {}
+      G4int    events;
+      G4int    chunks;
+      Long64_t bytes;
+    };
+
+    static void OpenChunk();
+    static void ShipChunk();
+    void Ship(const Message& message);
+
+    static G4ThreadFunReturnType WriterLoop(G4ThreadFunArgType arg);
+    void ReadChunk(const Message& message);
+    void WriteEntry(Chunk* chunk, Long64_t entry);
+    void WriteReady(G4bool all);
+    void WriteStats();
+
+    static EEShashTreeMerger* fInstance;
+    static G4ThreadLocal TMemFile* fChunkFile;  // chunk being filled
+    static G4ThreadLocal G4int fChunkEvents;
+
+    G4String fFileName;
+    G4int    fChunkSize;
+
+    // shared with the writer thread, under the merger mutex
+    std::deque<Message> fQueue;
+    G4bool fStop;
+    G4int  fNofFlushes;     // requested by Flush()
+    G4int  fNofFlushed;     // done by the writer
+    G4Thread* fWriter;
+
+    // writer thread only
+    TFile*      fOutputFile;
+    CreateTree* fOutputTree;
+    TTree*      fStatsTree;
+    G4int       fNextEvent;  // next event number to write
+    std::map<G4int, std::pair<Chunk*,Long64_t> > fHeldBack;  // by event
+    std::map<G4int, ThreadStats> fStats;  // by thread, for the current run
+    G4int fStatsRun, fStatsThread, fStatsEvents, fStatsChunks;
+    Long64_t fStatsBytes;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
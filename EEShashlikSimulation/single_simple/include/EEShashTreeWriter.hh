@@ -0,0 +1,106 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTreeWriter.hh
+/// \brief Definition of the EEShashTreeWriter class
+
+#ifndef EEShashTreeWriter_h
+#define EEShashTreeWriter_h 1
+
+#include "globals.hh"
+
+#include <deque>
+#include <vector>
+
+class TThread;
+class TMutex;
+class TCondition;
+class CreateTree;
+
+/// Background writer of the CreateTree output in sequential mode
+///
+/// The simulation fills CreateTree::Instance() as usual. Fill() hands that
+/// event buffer to a writer thread and makes the next free buffer the
+/// instance, so the simulation goes on with the next event while the
+/// writer copies the event to the output tree, which compresses and writes
+/// its baskets. With a depth of 1 this is a double buffer; the simulation
+/// only waits (stalls) when all the buffers are queued. A depth of 0 fills
+/// the output tree directly, as before.
+///
+/// BeginOfRun() sets up the buffers and applies the output settings of
+/// CreateTree; EndOfRun() waits for the queue to empty and prints the
+/// queue depth and the stall and write times of the run.
+///
+/// The thread is a ROOT TThread, so that the writer also runs in builds of
+/// Geant4 without multi-threading; in multi-threaded mode the workers'
+/// trees are written by EEShashTreeMerger instead.
+
+class EEShashTreeWriter
+{
+  public:
+    EEShashTreeWriter(CreateTree* output);
+    ~EEShashTreeWriter();
+
+    static EEShashTreeWriter* Instance() { return fInstance; }
+
+    // number of events that can wait for the writer, from the next run on
+    static void  SetDepth(G4int depth) { fDepth = depth; }
+    static G4int GetDepth() { return fDepth; }
+
+    void BeginOfRun();
+    void Fill();
+    void EndOfRun();
+
+  private:
+    static void* WriterLoop(void* arg);
+    void Drain();
+
+    static EEShashTreeWriter* fInstance;
+    static G4int fDepth;
+
+    CreateTree* fOutput;               // booked in the output file
+    std::vector<CreateTree*> fBuffers;
+    std::deque<CreateTree*>  fQueue;   // filled, to be written
+    std::deque<CreateTree*>  fFree;    // written, to be filled again
+
+    TThread*    fThread;
+    TMutex*     fMutex;
+    TCondition* fFilled;
+    TCondition* fWritten;
+    G4bool      fStop;
+    G4bool      fBusy;
+
+    // run statistics
+    G4int    fNofEvents;
+    G4int    fMaxQueued;
+    G4double fSumQueued;
+    G4int    fNofStalls;
+    G4double fStallTime;  // [s] simulation waiting for a buffer
+    G4double fWriteTime;  // [s] writer copying and filling
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashWaveform.hh
+/// \brief Definition of the EEShashWaveform class
+
+#ifndef EEShashWaveform_h
+#define EEShashWaveform_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Photon arrival waveform of one readout channel
+///
+/// In waveform mode (WAVEFORM=1, see CreateTree) the photons detected in
+/// an event are not stored one by one: EEShashEventAction fills them in a
+/// fixed binning, by default the 1024 bins over 0-200 ns of the Analyzer,
+/// and only the samples are written. If an electronics response was loaded
+/// with LoadKernel() (WAVEFORM_KERNEL=<file>), the waveform is convolved
+/// with it at the end of the event.
+///
+/// The kernel file holds one sample per line, the response to a single
+/// photon in the same bin width as the waveform, starting at t = 0.
+
+class EEShashWaveform
+{
+  public:
+    EEShashWaveform(G4int nBins = 1024, G4double tMin = 0.,
+                    G4double tMax = 200.);  // [ns]
+    ~EEShashWaveform();
+
+    void Reset();
+    void Fill(G4double time, G4double weight = 1.);  // time in ns
+    void Convolve();  // with the kernel, if any
+    void CopyTo(float* samples) const;
+
+    G4int GetNbins() const { return fSamples.size(); }
+    G4double GetTMin() const { return fTMin; }                            // [ns]
+    G4double GetTMax() const { return fTMin + fBinWidth*fSamples.size(); } // [ns]
+
+    // shared by the threads, loaded before the run
+    static void LoadKernel(const G4String& fileName);
+    static const std::vector<G4double>& GetKernel() { return fKernel; }
+
+  private:
+    G4double fTMin;
+    G4double fBinWidth;
+    std::vector<G4double> fSamples;
+    std::vector<G4double> fBuffer;  // convolution output
+
+    static std::vector<G4double> fKernel;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,59 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashWeightedReadoutSD.hh
+/// \brief Definition of the EEShashWeightedReadoutSD class
+
+#ifndef EEShashWeightedReadoutSD_h
+#define EEShashWeightedReadoutSD_h 1
+
+#include "EEShashOpticalReadoutSD.hh"
+
+/// Optical readout of this variant
+///
+/// The shared EEShashOpticalReadoutSD (common/), with the photon weight and
+/// the QE-at-birth flag taken from the TrackInformation of the photon, and
+/// the arrivals recorded in the fibre calibration (EEShashFibreTable) when
+/// one is running.
+
+class EEShashWeightedReadoutSD : public EEShashOpticalReadoutSD
+{
+  public:
+    EEShashWeightedReadoutSD(const G4String& name, 
+                             const G4String& hitsCollectionName, 
+                             G4int nofFibres,
+                             G4double acceptance = 1.);
+    virtual ~EEShashWeightedReadoutSD();
+
+    virtual void Initialize(G4HCofThisEvent* hitCollection);
+
+  protected:
+    virtual void PhotonArrived(const G4Track* track, G4double& weight,
+                               G4bool& preselected);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
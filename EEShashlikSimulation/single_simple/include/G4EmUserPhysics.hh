@@ -49,38 +49,60 @@
 #include "G4OpWLS.hh"
 
 
-class G4Cerenkov;
+class EEShashCerenkov;
 class G4Scintillation;
 class G4OpAbsorption;
 class G4OpRayleigh;
 class G4OpMieHG;
 class G4OpBoundaryProcess;
 class G4OpWLS;
+class EEShashOpticalMessenger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class G4EmUserPhysics : public G4VPhysicsConstructor
 {
 public:
-  G4EmUserPhysics(const G4int& scint, const G4int& cher);
+  G4EmUserPhysics(const G4int& scint, const G4int& cher, const G4int& fastSim = 0);
   
   virtual ~G4EmUserPhysics();
   
   virtual void ConstructParticle();
   virtual void ConstructProcess();
+
+  // Optical photon thinning: scintillation photons are generated with
+  // 1/factor of the material yield and each carries a weight of factor
+  void SetThinningFactor(G4double factor);
+  static G4double GetThinningFactor() { return thinningFactor; }
+
+  // Cerenkov photons are generated only between these wavelengths [nm],
+  // the sensitive window of the photodetector
+  void SetCerenkovWindow(G4double lambdaMin, G4double lambdaMax);
   
   
 private:
   G4int switchOnScintillation;
   G4int switchOnCerenkov;
+  G4int switchOnFastSimulation; // fast simulation of optical photons in the fibres and tiles
   
-  G4Cerenkov * theCerenkovProcess;
-  G4OpWLS * theWLSProcess;
-  G4Scintillation * theScintillationProcess;
-  G4OpAbsorption * theAbsorptionProcess;
-  G4OpRayleigh * theRayleighScatteringProcess;
-  G4OpMieHG * theMieHGScatteringProcess;
-  G4OpBoundaryProcess * theBoundaryProcess;
+  // processes of the calling thread, every worker constructs its own
+  static G4ThreadLocal EEShashCerenkov * theCerenkovProcess;
+  static G4ThreadLocal G4OpWLS * theWLSProcess;
+  static G4ThreadLocal G4Scintillation * theScintillationProcess;
+  static G4ThreadLocal G4OpAbsorption * theAbsorptionProcess;
+  static G4ThreadLocal G4OpRayleigh * theRayleighScatteringProcess;
+  static G4ThreadLocal G4OpMieHG * theMieHGScatteringProcess;
+  static G4ThreadLocal G4OpBoundaryProcess * theBoundaryProcess;
+
+  // options shared by all threads, only changed by the master
+  static G4double thinningFactor;
+  static G4double cerenkovLambdaMin;
+  static G4double cerenkovLambdaMax;
+
+  // the master's messenger; each worker has one for its own processes and
+  // readout, which receives the broadcast commands
+  EEShashOpticalMessenger * theMessenger;
+  static G4ThreadLocal EEShashOpticalMessenger * theWorkerMessenger;
   
 };
 
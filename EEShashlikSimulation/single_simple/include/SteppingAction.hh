@@ -30,7 +30,6 @@
 #include "TFile.h"
 #include "TTree.h"
 #include "TString.h"
-#include "TRandom3.h"
 
 class SteppingAction : public G4UserSteppingAction
 {
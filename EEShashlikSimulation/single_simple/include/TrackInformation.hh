@@ -38,6 +38,8 @@ private:
   G4ThreeVector parentMomentum;
   G4double parentEnergy;
   G4double parentTime;
+  G4double particleWeight; // statistical weight, > 1 for thinned optical photons
+  G4bool qeApplied;        // kept at birth with the largest QE (EEShashStackingAction)
 
 
 public:
@@ -56,22 +58,28 @@ public:
   inline G4ThreeVector GetParentMomentum() const { return parentMomentum; };
   inline G4double GetParentEnergy() const { return parentEnergy; };
   inline G4double GetParentTime() const { return parentTime; };
+  inline G4double GetParticleWeight() const { return particleWeight; };
   inline void SetParticleProdTimeInformation(const G4double& prodTime) { particleProdTime = prodTime; };
+  inline void SetParticleWeight(const G4double& weight) { particleWeight = weight; };
+  inline G4bool GetQEApplied() const { return qeApplied; };
+  inline void SetQEApplied(const G4bool& applied) { qeApplied = applied; };
   void SetParticleInformation(const TrackInformation* aTrackInfo);
   void SetParentInformation(const TrackInformation* aTrackInfo);
 };
 
 
-extern G4Allocator<TrackInformation> aTrackInformationAllocator;
+extern G4ThreadLocal G4Allocator<TrackInformation>* aTrackInformationAllocator;
 inline void* TrackInformation::operator new(size_t)
 {
+  if(!aTrackInformationAllocator)
+    aTrackInformationAllocator = new G4Allocator<TrackInformation>;
   void* aTrackInfo;
-  aTrackInfo = (void*)aTrackInformationAllocator.MallocSingle();
+  aTrackInfo = (void*)aTrackInformationAllocator->MallocSingle();
   return aTrackInfo;
 }
 inline void TrackInformation::operator delete(void *aTrackInfo)
 {
-  aTrackInformationAllocator.FreeSingle((TrackInformation*)aTrackInfo);
+  aTrackInformationAllocator->FreeSingle((TrackInformation*)aTrackInfo);
 }
 
 
@@ -38,10 +38,26 @@ int nFibres = 4;
 //int nFibres = 1;
 
 int nPhotonsForTiming=100;
-std::vector<float> time_vector;
 
 #include "EEShashDetectorConstruction.hh"
+#include "EEShashMaterialDatabase.hh"
 #include "EEShashActionInitialization.hh"
+#include "EEShashRunAction.hh"
+#include "EEShashFibreFastModel.hh"
+#include "EEShashFibreTable.hh"
+#include "EEShashTileFastModel.hh"
+#include "EEShashTileTable.hh"
+#include "EEShashTreeMerger.hh"
+#include "EEShashTreeWriter.hh"
+#include "EEShashOutputMessenger.hh"
+#include "EEShashWaveform.hh"
+#include "EEShashNavigationBenchmark.hh"
+#include "EEShashProfiler.hh"
+#include "EEShashRunTelemetry.hh"
+#include "EEShashOpticalKillPolicy.hh"
+#include "EEShashKillPolicyMessenger.hh"
+#include "EEShashShowerLibrary.hh"
+#include "EEShashShowerSource.hh"
 #include "SteppingAction.hh"
 #include "TrackingAction.hh"
 
@@ -74,6 +90,11 @@ std::vector<float> time_vector;
 #endif
 
 #include "TROOT.h"
+#include "G4Timer.hh"
+#include "G4SystemOfUnits.hh"
+#include <sys/resource.h>
+#include "RVersion.h"
+#include "TThread.h"
 
 using namespace CLHEP;
 
@@ -81,6 +102,16 @@ using namespace CLHEP;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 namespace {
+  // wall time since the start and peak resident memory, at each stage of
+  // the startup
+  void PrintResourceUsage(const char* stage, G4Timer& timer) {
+    timer.Stop();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    G4cout << ">>> " << stage << ": " << timer.GetRealElapsed() << " s, max RSS "
+           << usage.ru_maxrss/1024. << " MB" << G4endl;
+  }
+
   void PrintUsage() {
     G4cerr << " Usage: " << G4endl;
     G4cerr << " exampleEEShash [-m macro ] [-u UIsession] [-t nThreads]" << G4endl;
@@ -95,6 +126,9 @@ long int CreateSeed();
 
 int main(int argc,char** argv)
 {
+  G4Timer startupTimer;
+  startupTimer.Start();
+
   // Evaluate arguments
   //
   if ( argc > 7 ) {
@@ -130,6 +164,9 @@ int main(int argc,char** argv)
   // Choose the Random engine
   //
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
+  // SEED=<n> repeats a sample, e.g. to compare two settings on the same events
+  long seed = std::getenv("SEED") ? atol(std::getenv("SEED")) : time(NULL);
+  G4Random::setTheSeed(seed); // in MT mode the workers are seeded from it
   
   // Construct the default run manager
   //
@@ -146,7 +183,10 @@ int main(int argc,char** argv)
 
   // Set mandatory initialization classes                                                                                                                                                                                              
   //                                                                                                                                                                                                                                   
-  gROOT->ProcessLine("#include <vector>");//otherwise branch with vector does not work                                   
+  // the vector branches use the dictionaries ROOT ships for the vectors of
+  // basic types; CLING_VECTOR=1 parses <vector> in the interpreter as
+  // before, to compare the startup time and memory
+  if( std::getenv("CLING_VECTOR") ) gROOT->ProcessLine("#include <vector>");
   std::string filename;
 
   // If this run is part of a job, store it in a separate ROOT file
@@ -164,18 +204,133 @@ int main(int argc,char** argv)
 
   std::cout << "Using fileName: " << filename << G4endl;
                                                                                        
+  // COLUMN_EXPORT=<file> also writes the tree in columns readable without
+  // ROOT (EEShashColumnReader.hh), COLUMN_ONLY=1 writes only these
+  if( std::getenv("COLUMN_EXPORT") ) {
+    G4bool only = std::getenv("COLUMN_ONLY") && atoi(std::getenv("COLUMN_ONLY"));
+    CreateTree::SetColumnExport(std::getenv("COLUMN_EXPORT"), only);
+  }
+
+  // the throughput and memory of each run go to <output>.run<N>.telemetry.json
+  // unless TELEMETRY=0, and with TELEMETRY_INTERVAL=<s> the totals are also
+  // sampled to <output>.run<N>.samples.jsonl during the run
+  if( ! std::getenv("TELEMETRY") || atoi(std::getenv("TELEMETRY")) ) {
+    G4double interval = 0.;
+    if( std::getenv("TELEMETRY_INTERVAL") ) interval = atof(std::getenv("TELEMETRY_INTERVAL"));
+    EEShashRunTelemetry::SetOutput(filename, interval);
+    if( std::getenv("COLUMN_EXPORT") ) EEShashRunTelemetry::AddOutputFile(std::getenv("COLUMN_EXPORT"));
+  }
+
+  // WAVEFORM=1 stores per-channel waveforms instead of the photons,
+  // convolved with the single photon response in WAVEFORM_KERNEL=<file>
+  if( std::getenv("WAVEFORM") && atoi(std::getenv("WAVEFORM")) ) {
+    CreateTree::SetWaveformMode(true);
+    if( std::getenv("WAVEFORM_KERNEL") )
+      EEShashWaveform::LoadKernel(std::getenv("WAVEFORM_KERNEL"));
+  }
+
+  // the output trees are written on a thread of their own in both builds:
+  // ROOT must be made thread-safe before they are booked
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+  ROOT::EnableThreadSafety();
+#else
+  TThread::Initialize();
+#endif
+
+  // in MT mode the workers fill trees of their own which are merged into
+  // the output file on a writer thread, see EEShashTreeMerger
+#ifdef G4MULTITHREADED
+  TFile* outfile = 0;
+  CreateTree* mytree = 0;
+  EEShashTreeMerger* treeMerger = new EEShashTreeMerger(filename);
+#else
   TFile* outfile=new TFile(filename.c_str(),"recreate");
   CreateTree* mytree = new CreateTree("tree");
+  mytree->OpenColumnExport();
+  // events are compressed and written on a background thread
+  EEShashTreeWriter* treeWriter = new EEShashTreeWriter(mytree);
+#endif
+  PrintResourceUsage("output tree booked", startupTimer);
 
 
   // Set mandatory initialization classes
   //
 
 
+  // Optical properties of the materials, opticalProperties.dat unless
+  // OPTICAL_PROPERTIES=<file> is given (e.g. in a scan of the parameters)
+  if( std::getenv("OPTICAL_PROPERTIES") )
+    EEShashMaterialDatabase::SetFileName(std::getenv("OPTICAL_PROPERTIES"));
+
   // Initialize DetectorConstruction
   EEShashDetectorConstruction* detConstruction = new EEShashDetectorConstruction(rotation, zTras);
   runManager->SetUserInitialization(detConstruction);
 
+  // Light transport in the WLS fibres: FIBRE_CALIBRATION=<table> tracks the
+  // photons in full and fills the table, FIBRE_FASTSIM=<table> uses it
+  G4String fibreTableFile = "";
+  G4int fibreMode = kFibreFullTracking;
+  if( std::getenv("FIBRE_CALIBRATION") ) {
+    fibreTableFile = std::getenv("FIBRE_CALIBRATION");
+    fibreMode = kFibreCalibration;
+  }
+  else if( std::getenv("FIBRE_FASTSIM") ) {
+    fibreTableFile = std::getenv("FIBRE_FASTSIM");
+    fibreMode = kFibreFastSimulation;
+  }
+  detConstruction->SetFibreMode(fibreMode, fibreTableFile);
+
+  // Light collection in the CeF3 tiles: TILE_CALIBRATION=<table> tracks the
+  // photons in full and fills the table, TILE_FASTSIM=<table> uses it and
+  // needs FIBRE_FASTSIM
+  G4String tileTableFile = "";
+  G4int tileMode = kTileFullTracking;
+  if( std::getenv("TILE_CALIBRATION") ) {
+    tileTableFile = std::getenv("TILE_CALIBRATION");
+    tileMode = kTileCalibration;
+  }
+  else if( std::getenv("TILE_FASTSIM") ) {
+    tileTableFile = std::getenv("TILE_FASTSIM");
+    tileMode = kTileFastSimulation;
+  }
+  detConstruction->SetTileMode(tileMode, tileTableFile);
+
+  // the light tables are calibrated with the photons tracked in full, only
+  // the step limit of EEShashOpticalKillPolicy applies; in waveform mode
+  // the photons later than the waveform EEShashEventAction fills are not
+  // tracked
+  EEShashOpticalKillPolicy::SetCalibration(fibreMode == kFibreCalibration || tileMode == kTileCalibration);
+  if( CreateTree::GetWaveformMode() ) {
+    EEShashWaveform waveform;
+    EEShashOpticalKillPolicy::SetTimeWindow(waveform.GetTMax()*ns);
+  }
+
+  // PROFILE=<file> reports the steps, tracks and CPU time per logical
+  // volume, particle and creator process of each run (.json or CSV), the
+  // CPU time being read every PROFILE_SAMPLING=<n> steps (64)
+  if( std::getenv("PROFILE") ) {
+    G4int sampling = 64;
+    if( std::getenv("PROFILE_SAMPLING") ) sampling = atoi(std::getenv("PROFILE_SAMPLING"));
+    EEShashProfiler::SetReportFile(std::getenv("PROFILE"), sampling);
+  }
+
+  // GEOMETRY_CACHE=<dir> reads the geometry from a GDML file of a previous
+  // job with the same parameters, or writes it there; the overlaps are only
+  // checked when it is built, or always with CHECK_OVERLAPS=1
+  if( std::getenv("GEOMETRY_CACHE") ) {
+    G4bool checkOverlaps = std::getenv("CHECK_OVERLAPS") && atoi(std::getenv("CHECK_OVERLAPS"));
+    detConstruction->SetGeometryCache(std::getenv("GEOMETRY_CACHE"), checkOverlaps);
+  }
+
+  // GEOMETRY_CONFIG=<macro> sets the construction parameters with the
+  // /EEShash/geometry/ commands (see geometry.mac for the variants of the
+  // test beam setups); it overrides -r and -z and is read before the
+  // output is booked from nLayers and nFibres
+  if( std::getenv("GEOMETRY_CONFIG") ) {
+    G4String command = "/control/execute ";
+    G4UImanager::GetUIpointer()->ApplyCommand(command+std::getenv("GEOMETRY_CONFIG"));
+  }
+
   // Switch on relevant physics
   G4int switchOnScintillation = 1;
   G4int switchOnCerenkov = 0;
@@ -183,6 +338,25 @@ int main(int argc,char** argv)
   G4int propagateScintillation = 1;
   G4int propagateCerenkov = 0;
 
+  // SHOWER_LIBRARY_RECORD=<file> stores the steps in the CeF3 tiles of each
+  // shower, in impact bins of SHOWER_LIBRARY_BIN=<mm> (2), without making
+  // any light; SHOWER_LIBRARY=<file> replays them as the optical photons of
+  // the gun particle, for optical parameter scans without the shower
+  EEShashShowerLibrary* showerLibrary = 0;
+  if( std::getenv("SHOWER_LIBRARY_RECORD") ) {
+    G4double impactStep = 2.*mm;
+    if( std::getenv("SHOWER_LIBRARY_BIN") ) impactStep = atof(std::getenv("SHOWER_LIBRARY_BIN"))*mm;
+    showerLibrary = new EEShashShowerLibrary(std::getenv("SHOWER_LIBRARY_RECORD"),
+                                             EEShashShowerLibrary::kRecord, impactStep);
+    switchOnScintillation = 0;
+    switchOnCerenkov = 0;
+  }
+  else if( std::getenv("SHOWER_LIBRARY") ) {
+    showerLibrary = new EEShashShowerLibrary(std::getenv("SHOWER_LIBRARY"),
+                                             EEShashShowerLibrary::kReplay);
+    EEShashShowerSource::SetProcesses(switchOnScintillation, switchOnCerenkov);
+  }
+
 
   
 
@@ -207,7 +381,7 @@ int main(int argc,char** argv)
   G4cout << ">>> Define physics list::begin <<<" << G4endl;
   G4VModularPhysicsList* physics = factory.GetReferencePhysList(physName);
 
-  physics->RegisterPhysics(new G4EmUserPhysics(switchOnScintillation,switchOnCerenkov));
+  physics->RegisterPhysics(new G4EmUserPhysics(switchOnScintillation,switchOnCerenkov,fibreMode!=kFibreFullTracking || tileMode!=kTileFullTracking));
 
   runManager-> SetUserInitialization(physics);
   G4cout << ">>> Define physics list::end <<<" << G4endl; 
@@ -215,25 +389,35 @@ int main(int argc,char** argv)
 
 
 
+  // tracking and stepping actions are built per thread with the others
   EEShashActionInitialization* actionInitialization
-     = new EEShashActionInitialization();
+     = new EEShashActionInitialization(detConstruction,propagateScintillation,propagateCerenkov);
   runManager->SetUserInitialization(actionInitialization);
 
-  
-  G4cout << ">>> Define TrackingAction::begin <<<" << G4endl;
-  TrackingAction* tracking_action = new TrackingAction;
-  runManager->SetUserAction(tracking_action);
-  G4cout << ">>> Define TrackingAction::end <<<" << G4endl;
-
-  G4cout << ">>> Define SteppingAction::begin <<<" << G4endl;
-  SteppingAction* stepping_action = new SteppingAction(detConstruction,propagateScintillation,propagateCerenkov);
-  runManager->SetUserAction(stepping_action);
-  G4cout << ">>> Define SteppingAction::end <<<" << G4endl;
-
 
   // Initialize G4 kernel
   //
   runManager->Initialize();
+  PrintResourceUsage("Geant4 initialized", startupTimer);
+
+  // Output settings, /EEShash/output/
+  EEShashOutputMessenger* outputMessenger = new EEShashOutputMessenger();
+
+  // Limits of the optical photon tracking, /EEShash/killPolicy/
+  EEShashKillPolicyMessenger* killPolicyMessenger = new EEShashKillPolicyMessenger();
+
+  // Optional timing of the per-step volume classification on the steps of
+  // the run, replayed every <nSteps> steps (ROLEBENCH=<nSteps>)
+  if( std::getenv("ROLEBENCH") ) {
+    EEShashVolumeRoleTable::SetBenchmark(atoi(std::getenv("ROLEBENCH")));
+  }
+
+  // Navigation benchmark and voxel tuning, /EEShash/navigation/; a scan
+  // of geantinos along the beam at startup with GEANTINOSCAN=<nRays>
+  EEShashNavigationBenchmark* navigationBenchmark = new EEShashNavigationBenchmark();
+  if( std::getenv("GEANTINOSCAN") ) {
+    navigationBenchmark->Scan(atoi(std::getenv("GEANTINOSCAN")));
+  }
   
 #ifdef G4VIS_USE
   // Initialize visualization
@@ -272,13 +456,32 @@ int main(int argc,char** argv)
   // owned and deleted by the run manager, so they should not be deleted 
   // in the main() program !
 
+  if( fibreMode == kFibreCalibration && EEShashFibreTable::Instance() ) {
+    EEShashFibreTable::Instance()->Write(fibreTableFile);
+  }
+  if( tileMode == kTileCalibration && EEShashTileTable::Instance() ) {
+    EEShashTileTable::Instance()->Write(tileTableFile);
+  }
+
 #ifdef G4VIS_USE
   delete visManager;
 #endif
   delete runManager;
-
-  mytree -> GetTree() -> Write();
-  outfile -> Close();
+#ifdef G4MULTITHREADED
+  delete treeMerger;
+#else
+  delete treeWriter;
+#endif
+  delete outputMessenger;
+  delete killPolicyMessenger;
+  delete navigationBenchmark;
+  delete showerLibrary;
+
+  if( mytree ) {
+    mytree -> CloseColumnExport();
+    mytree -> GetTree() -> Write();
+    outfile -> Close();
+  }
 
 
   return 0;
@@ -1,8 +1,25 @@
 #include "CreateTree.h"
+#include "EEShashColumnExporter.hh"
 
+#include <cmath>
 
+#include "TBranch.h"
 
-CreateTree* CreateTree::fInstance = NULL;
+
+
+G4ThreadLocal CreateTree* CreateTree::fInstance = NULL;
+
+float CreateTree::fTimeStep = 0.01;
+bool CreateTree::fWaveformMode = false;
+const float CreateTree::kZStep = 0.02;
+const float CreateTree::kThetaStep = 3.14159265359/65535.;
+
+std::map<std::string,int> CreateTree::fCompression;
+int      CreateTree::fBasketSize = 0;
+Long64_t CreateTree::fAutoFlush = 0;
+
+std::string CreateTree::fColumnFile = "";
+bool CreateTree::fColumnOnly = false;
 
 
 
@@ -16,7 +33,71 @@ CreateTree::CreateTree(TString name)
   this -> fInstance = this;
   this -> fname     = name;
   this -> ftree     = new TTree(name,name);
+  this -> fExporter = 0;
+
+  this->BookBranches();
+}
+
+TTree* CreateTree::Rebook()
+{
+  // the previous tree is left to its directory
+  this -> ftree = new TTree(fname,fname);
+  this->BookBranches();
+  return this->ftree;
+}
 
+void CreateTree::CopyEvent(CreateTree& to) const
+{
+  // everything but the tree of the target
+  TTree*  tree = to.ftree;
+  TString name = to.fname;
+  EEShashColumnExporter* exporter = to.fExporter;
+  to = *this;
+  to.ftree = tree;
+  to.fname = name;
+  to.fExporter = exporter;
+}
+
+int CreateTree::Fill()
+{
+  if( fExporter ) {
+    fExporter->Fill();
+    if( fColumnOnly ) return 0;
+  }
+  return this->GetTree()->Fill();
+}
+
+void CreateTree::OpenColumnExport()
+{
+  if( fColumnFile.empty() || fExporter ) return;
+  fExporter = new EEShashColumnExporter(fColumnFile, this->GetTree());
+}
+
+void CreateTree::CloseColumnExport()
+{
+  delete fExporter;
+  fExporter = 0;
+}
+
+void CreateTree::ApplyOutputSettings()
+{
+  TTree* tree = this->GetTree();
+  if( fBasketSize > 0 ) tree->SetBasketSize("*",fBasketSize);
+  if( fAutoFlush != 0 ) tree->SetAutoFlush(fAutoFlush);
+
+  std::map<std::string,int>::const_iterator all = fCompression.find("*");
+  if( all != fCompression.end() && tree->GetCurrentFile() )
+    tree->GetCurrentFile()->SetCompressionSettings(all->second);
+  TIter next(tree->GetListOfBranches());
+  while( TBranch* branch = (TBranch*)next() ) {
+    std::map<std::string,int>::const_iterator it = fCompression.find(branch->GetName());
+    if( it == fCompression.end() ) it = all;
+    if( it != fCompression.end() ) branch->SetCompressionSettings(it->second);
+  }
+}
+
+void CreateTree::BookBranches()
+{
   this->GetTree()->Branch("Event",&this->Event,"Event/I");
   
   this->GetTree()->Branch("Eabs_3x3",&this->Eabs_3x3,"Eabs_3x3/F");
@@ -28,29 +109,47 @@ CreateTree::CreateTree(TString name)
   this->GetTree()->Branch("Eabs_CentralXtal",&this->Eabs_CentralXtal,"Eabs_CentralXtal");
   this->GetTree()->Branch("Eact_CentralXtal",&this->Eact_CentralXtal,"Eact_CentralXtal");
   
-  this->GetTree()->Branch("Time_deposit",&this->Time_deposit);
-  this->GetTree()->Branch("Process_deposit",&this->Process_deposit);
-  this->GetTree()->Branch("Z_deposit",&this->Z_deposit);
-  this->GetTree()->Branch("Theta_deposit",&this->Theta_deposit);
+  if( fWaveformMode ) {
+    this->GetTree()->Branch("Waveform_0",this->Waveform_0,Form("Waveform_0[%d]/F",nWaveformBins));
+    this->GetTree()->Branch("Waveform_1",this->Waveform_1,Form("Waveform_1[%d]/F",nWaveformBins));
+    this->GetTree()->Branch("Waveform_2",this->Waveform_2,Form("Waveform_2[%d]/F",nWaveformBins));
+    this->GetTree()->Branch("Waveform_3",this->Waveform_3,Form("Waveform_3[%d]/F",nWaveformBins));
+    this->GetTree()->Branch("Waveform_APD",this->Waveform_APD,Form("Waveform_APD[%d]/F",nWaveformBins));
+  }
+  else {
+    this->GetTree()->Branch("Photon_timeStep",&this->Photon_timeStep,"Photon_timeStep/F");
+    this->GetTree()->Branch("Photon_time",&this->Photon_time);
+    this->GetTree()->Branch("Photon_z",&this->Photon_z);
+    this->GetTree()->Branch("Photon_theta",&this->Photon_theta);
+    this->GetTree()->Branch("Photon_code",&this->Photon_code);
+    this->GetTree()->Branch("Weight_deposit",&this->Weight_deposit);
+  }
   this->GetTree()->Branch("opPhoton_time",&this->opPhoton_time);    
   this->GetTree()->Branch("opPhoton_process",&this->opPhoton_process);    
   this->GetTree()->Branch("Eabs",&this->Eabs,"Eabs/F");
   this->GetTree()->Branch("Eact",&this->Eact,"Eact/F");
-  this->GetTree()->Branch("NPhot_Act",&this->NPhot_Act,"NPhot_Act/I");
-  this->GetTree()->Branch("NPhot_Fib",&this->NPhot_Fib,"NPhot_Fib/I");
-  this->GetTree()->Branch("NPhot_Fib2",&this->NPhot_Fib2,"NPhot_Fib2/I");
-  this->GetTree()->Branch("NPhot_Fib3",&this->NPhot_Fib3,"NPhot_Fib3/I");
-  this->GetTree()->Branch("NPhot_Fib4",&this->NPhot_Fib4,"NPhot_Fib4/I");
+  this->GetTree()->Branch("NPhot_Act",&this->NPhot_Act,"NPhot_Act/F");
+  this->GetTree()->Branch("NPhot_Fib",&this->NPhot_Fib,"NPhot_Fib/F");
+  this->GetTree()->Branch("NPhot_Fib2",&this->NPhot_Fib2,"NPhot_Fib2/F");
+  this->GetTree()->Branch("NPhot_Fib3",&this->NPhot_Fib3,"NPhot_Fib3/F");
+  this->GetTree()->Branch("NPhot_Fib4",&this->NPhot_Fib4,"NPhot_Fib4/F");
+  this->GetTree()->Branch("NOpt_generated",&this->NOpt_generated,"NOpt_generated/I");
+  this->GetTree()->Branch("NOpt_tracked",&this->NOpt_tracked,"NOpt_tracked/I");
   this->GetTree()->Branch("EfibrCore",&this->EfibrCore,"EfibrCore/F");
   this->GetTree()->Branch("EfibrClad",&this->EfibrClad,"EfibrClad/F");
   this->GetTree()->Branch("nLayers",&this->nLayers,"nLayers/I");
 
-  this->GetTree()->Branch("Fibre_start_0",&this->Fibre_start_0,"Fibre_start_0/I");
+  this->GetTree()->Branch("Fibre_start_0",&this->Fibre_start_0,"Fibre_start_0/F");
 
-  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/I");
-  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/I");
-  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/I");
-  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/I");
+  this->GetTree()->Branch("Fibre_0",&this->Fibre_0,"Fibre_0/F");
+  this->GetTree()->Branch("Fibre_1",&this->Fibre_1,"Fibre_1/F");
+  this->GetTree()->Branch("Fibre_2",&this->Fibre_2,"Fibre_2/F");
+  this->GetTree()->Branch("Fibre_3",&this->Fibre_3,"Fibre_3/F");
+
+  this->GetTree()->Branch("FibreVar_0",&this->FibreVar_0,"FibreVar_0/F");
+  this->GetTree()->Branch("FibreVar_1",&this->FibreVar_1,"FibreVar_1/F");
+  this->GetTree()->Branch("FibreVar_2",&this->FibreVar_2,"FibreVar_2/F");
+  this->GetTree()->Branch("FibreVar_3",&this->FibreVar_3,"FibreVar_3/F");
 
   this->GetTree()->Branch("xPosition",&this->xPosition,"xPosition/F");
   this->GetTree()->Branch("yPosition",&this->yPosition,"yPosition/F");
@@ -59,9 +158,17 @@ CreateTree::CreateTree(TString name)
   this->GetTree()->Branch("EOpt_1",&this->EOpt_1,"EOpt_1/F");
   this->GetTree()->Branch("EOpt_2",&this->EOpt_2,"EOpt_2/F");
   this->GetTree()->Branch("EOpt_3",&this->EOpt_3,"EOpt_3/F");
+
+  this->GetTree()->Branch("Capture_0",&this->Capture_0,"Capture_0/F");
+  this->GetTree()->Branch("Capture_1",&this->Capture_1,"Capture_1/F");
+  this->GetTree()->Branch("Capture_2",&this->Capture_2,"Capture_2/F");
+  this->GetTree()->Branch("Capture_3",&this->Capture_3,"Capture_3/F");
+  this->GetTree()->Branch("Fibre_capture",&this->Fibre_capture);
+  this->GetTree()->Branch("Time_capture",&this->Time_capture);
   
   this->GetTree()->Branch("EAPD",&this->EAPD);
-  this->GetTree()->Branch("Time_deposit_APD",&this->Time_deposit_APD);
+  if( ! fWaveformMode )
+    this->GetTree()->Branch("Time_deposit_APD",&this->Time_deposit_APD);
 
   this->GetTree()->Branch("nParticlesAPD",&this->nParticlesAPD,"nParticlesAPD/I");
 
@@ -79,13 +186,30 @@ bool CreateTree::Write()
 }
 
 
+void CreateTree::AddPhoton(float time, float z, float theta, int code, float weight)
+{
+  // rounded to the nearest step, out of range values saturate
+  float t = time/fTimeStep + 0.5;
+  Photon_time.push_back( t < 65535. ? (unsigned short)(t > 0. ? t : 0.) : 65535 );
+  float zq = floor(z/kZStep + 0.5);
+  if( zq > 32767. ) zq = 32767.;
+  if( zq < -32768. ) zq = -32768.;
+  Photon_z.push_back((short)zq);
+  Photon_theta.push_back((unsigned short)(theta/kThetaStep + 0.5));
+  Photon_code.push_back((Char_t)code);
+  Weight_deposit.push_back(weight);
+}
+
+
 void CreateTree::Clear()
 {
   Event = 0;
-  Time_deposit.clear();
-  Process_deposit.clear();
-  Z_deposit.clear();
-  Theta_deposit.clear();
+  Photon_timeStep = fTimeStep;
+  Photon_time.clear();
+  Photon_z.clear();
+  Photon_theta.clear();
+  Photon_code.clear();
+  Weight_deposit.clear();
   opPhoton_time.clear();
   opPhoton_process.clear();
   Eabs=0;
@@ -100,6 +224,8 @@ void CreateTree::Clear()
   NPhot_Fib2=0;
   NPhot_Fib3=0;
   NPhot_Fib4=0;
+  NOpt_generated=0;
+  NOpt_tracked=0;
   EfibrCore=0;
   EfibrClad=0;
   nLayers=0;
@@ -110,6 +236,11 @@ void CreateTree::Clear()
   Fibre_1=0;
   Fibre_2=0;
   Fibre_3=0;
+
+  FibreVar_0=0;
+  FibreVar_1=0;
+  FibreVar_2=0;
+  FibreVar_3=0;
   
   xPosition=0;
   yPosition=0;
@@ -118,6 +249,13 @@ void CreateTree::Clear()
   EOpt_1=0;
   EOpt_2=0;
   EOpt_3=0;  
+
+  Capture_0=0;
+  Capture_1=0;
+  Capture_2=0;
+  Capture_3=0;
+  Fibre_capture.clear();
+  Time_capture.clear();
   
   Eact_CentralXtal=0.;
   Eabs_CentralXtal=0.;
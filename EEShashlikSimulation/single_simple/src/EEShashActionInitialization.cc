@@ -32,13 +32,23 @@
 #include "EEShashPrimaryGeneratorAction.hh"
 #include "EEShashRunAction.hh"
 #include "EEShashEventAction.hh"
+#include "EEShashStackingAction.hh"
 #include "TrackingAction.hh"
 #include "SteppingAction.hh"
+#include "EEShashProfiler.hh"
+#include "EEShashProfilingSteppingAction.hh"
+#include "EEShashProfilingTrackingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EEShashActionInitialization::EEShashActionInitialization()
- : G4VUserActionInitialization()
+EEShashActionInitialization::EEShashActionInitialization(
+                              EEShashDetectorConstruction* detConstruction,
+                              G4int propagateScintillation,
+                              G4int propagateCerenkov)
+ : G4VUserActionInitialization(),
+   fDetConstruction(detConstruction),
+   fPropagateScintillation(propagateScintillation),
+   fPropagateCerenkov(propagateCerenkov)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -76,6 +86,18 @@ void EEShashActionInitialization::Build() const
   SetUserAction(new EEShashPrimaryGeneratorAction);
   SetUserAction(new EEShashRunAction);
   SetUserAction(new EEShashEventAction);
+  SetUserAction(new EEShashStackingAction);
+  G4UserTrackingAction* trackingAction = new TrackingAction;
+  G4UserSteppingAction* steppingAction
+    = new SteppingAction(fDetConstruction,
+                         fPropagateScintillation, fPropagateCerenkov);
+  // profiling of the steps in front of the tracking and stepping actions
+  if ( EEShashProfiler::IsEnabled() ) {
+    trackingAction = new EEShashProfilingTrackingAction(trackingAction);
+    steppingAction = new EEShashProfilingSteppingAction(steppingAction);
+  }
+  SetUserAction(trackingAction);
+  SetUserAction(steppingAction);
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,243 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashCerenkov.cc
+/// \brief Implementation of the EEShashCerenkov class
+
+#include "EEShashCerenkov.hh"
+
+#include "G4OpticalPhoton.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4Poisson.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // points of the refractive index grid over the window
+  const G4int kNofBandPoints = 101;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashCerenkov::EEShashCerenkov(const G4String& processName,
+                                 G4double energyMin, G4double energyMax)
+ : G4Cerenkov(processName),
+   fEnergyMin(energyMin),
+   fEnergyMax(energyMax)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashCerenkov::~EEShashCerenkov()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashCerenkov::SetEnergyWindow(G4double energyMin, G4double energyMax)
+{
+  fEnergyMin = energyMin;
+  fEnergyMax = energyMax;
+  fBandRindex.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const EEShashCerenkov::BandRindex&
+EEShashCerenkov::GetBandRindex(const G4MaterialPropertyVector* rindex)
+{
+  std::map<const G4MaterialPropertyVector*, BandRindex>::iterator it
+    = fBandRindex.find(rindex);
+  if ( it != fBandRindex.end() ) return it->second;
+
+  BandRindex& band = fBandRindex[rindex];
+  band.eMin = std::max(rindex->GetMinLowEdgeEnergy(), fEnergyMin);
+  band.eMax = std::min(rindex->GetMaxLowEdgeEnergy(), fEnergyMax);
+  if ( band.eMax > band.eMin ) {
+    band.rindex.resize(kNofBandPoints);
+    G4double de = (band.eMax - band.eMin)/(kNofBandPoints-1);
+    for ( G4int i = 0; i < kNofBandPoints; ++i )
+      band.rindex[i] = rindex->Value(band.eMin + i*de);
+  }
+  return band;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashCerenkov::GetBandNumberOfPhotons(G4double charge,
+                                                 G4double beta,
+                                                 const BandRindex& band) const
+{
+  if ( band.rindex.empty() || beta <= 0. ) return 0.;
+
+  // Frank-Tamm, integrated with the trapezoidal rule where n*beta > 1
+  const G4double Rfact = 369.81/(eV*cm);
+  G4double betaInverse2 = 1./(beta*beta);
+  G4double de = (band.eMax - band.eMin)/(kNofBandPoints-1);
+  G4double integral = 0.;
+  G4double previous = 0.;
+  for ( G4int i = 0; i < kNofBandPoints; ++i ) {
+    G4double n = band.rindex[i];
+    G4double value = 1. - betaInverse2/(n*n);
+    if ( value < 0. ) value = 0.;
+    if ( i > 0 ) integral += 0.5*(previous + value)*de;
+    previous = value;
+  }
+
+  return Rfact*charge/eplus*charge/eplus*integral;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* EEShashCerenkov::PostStepDoIt(const G4Track& aTrack,
+                                                 const G4Step& aStep)
+{
+  // follows G4Cerenkov::PostStepDoIt(), with the energy range of the
+  // refractive index replaced by its overlap with the window
+  aParticleChange.Initialize(aTrack);
+
+  const G4DynamicParticle* aParticle = aTrack.GetDynamicParticle();
+  const G4Material* aMaterial = aTrack.GetMaterial();
+
+  G4StepPoint* pPreStepPoint  = aStep.GetPreStepPoint();
+  G4StepPoint* pPostStepPoint = aStep.GetPostStepPoint();
+
+  G4ThreeVector x0 = pPreStepPoint->GetPosition();
+  G4ThreeVector p0 = aStep.GetDeltaPosition().unit();
+  G4double t0 = pPreStepPoint->GetGlobalTime();
+
+  G4MaterialPropertiesTable* aMaterialPropertiesTable
+    = aMaterial->GetMaterialPropertiesTable();
+  if ( ! aMaterialPropertiesTable ) return pParticleChange;
+
+  G4MaterialPropertyVector* Rindex
+    = aMaterialPropertiesTable->GetProperty("RINDEX");
+  if ( ! Rindex ) return pParticleChange;
+
+  const BandRindex& band = GetBandRindex(Rindex);
+  if ( band.rindex.empty() ) return pParticleChange;
+
+  G4double charge = aParticle->GetDefinition()->GetPDGCharge();
+  G4double beta1  = pPreStepPoint->GetBeta();
+  G4double beta2  = pPostStepPoint->GetBeta();
+  G4double beta   = (beta1 + beta2)*0.5;
+
+  G4double MeanNumberOfPhotons
+    = GetBandNumberOfPhotons(charge, beta, band)*aStep.GetStepLength();
+  if ( MeanNumberOfPhotons <= 0. ) return pParticleChange;
+
+  G4int NumPhotons = (G4int) G4Poisson(MeanNumberOfPhotons);
+  if ( NumPhotons <= 0 ) return pParticleChange;
+
+  aParticleChange.SetNumberOfSecondaries(NumPhotons);
+
+  if ( GetTrackSecondariesFirst() ) {
+    if ( aTrack.GetTrackStatus() == fAlive )
+      aParticleChange.ProposeTrackStatus(fSuspend);
+  }
+
+  G4double Pmin = band.eMin;
+  G4double dp   = band.eMax - band.eMin;
+  G4double nMax = *std::max_element(band.rindex.begin(), band.rindex.end());
+
+  G4double BetaInverse = 1./beta;
+  G4double maxCos  = BetaInverse/nMax;
+  G4double maxSin2 = (1.0 - maxCos)*(1.0 + maxCos);
+
+  G4double MeanNumberOfPhotons1 = GetBandNumberOfPhotons(charge, beta1, band);
+  G4double MeanNumberOfPhotons2 = GetBandNumberOfPhotons(charge, beta2, band);
+
+  for ( G4int i = 0; i < NumPhotons; ++i ) {
+
+    // energy and angle of the photon
+    G4double rand;
+    G4double sampledEnergy, sampledRI;
+    G4double cosTheta, sin2Theta;
+    do {
+      rand = G4UniformRand();
+      sampledEnergy = Pmin + rand*dp;
+      sampledRI = Rindex->Value(sampledEnergy);
+      cosTheta  = BetaInverse/sampledRI;
+      sin2Theta = (1.0 - cosTheta)*(1.0 + cosTheta);
+      rand = G4UniformRand();
+    } while ( rand*maxSin2 > sin2Theta );
+
+    // direction and polarization, relative to the particle direction
+    G4double sinTheta = std::sqrt(sin2Theta);
+    G4double phi = twopi*G4UniformRand();
+    G4double sinPhi = std::sin(phi);
+    G4double cosPhi = std::cos(phi);
+
+    G4ParticleMomentum photonMomentum(sinTheta*cosPhi, sinTheta*sinPhi,
+                                      cosTheta);
+    photonMomentum.rotateUz(p0);
+
+    G4ThreeVector photonPolarization(cosTheta*cosPhi, cosTheta*sinPhi,
+                                     -sinTheta);
+    photonPolarization.rotateUz(p0);
+
+    G4DynamicParticle* aCerenkovPhoton
+      = new G4DynamicParticle(G4OpticalPhoton::OpticalPhoton(),
+                              photonMomentum);
+    aCerenkovPhoton->SetPolarization(photonPolarization.x(),
+                                     photonPolarization.y(),
+                                     photonPolarization.z());
+    aCerenkovPhoton->SetKineticEnergy(sampledEnergy);
+
+    // position along the step, following the change of beta
+    G4double NumberOfPhotons, N;
+    do {
+      rand = G4UniformRand();
+      NumberOfPhotons = MeanNumberOfPhotons1
+                        - rand*(MeanNumberOfPhotons1 - MeanNumberOfPhotons2);
+      N = G4UniformRand()*std::max(MeanNumberOfPhotons1, MeanNumberOfPhotons2);
+    } while ( N > NumberOfPhotons );
+
+    G4double delta = rand*aStep.GetStepLength();
+    G4double deltaTime = delta/(pPreStepPoint->GetVelocity()
+      + rand*(pPostStepPoint->GetVelocity() - pPreStepPoint->GetVelocity())*0.5);
+
+    G4double aSecondaryTime = t0 + deltaTime;
+    G4ThreeVector aSecondaryPosition = x0 + rand*aStep.GetDeltaPosition();
+
+    G4Track* aSecondaryTrack
+      = new G4Track(aCerenkovPhoton, aSecondaryTime, aSecondaryPosition);
+    aSecondaryTrack->SetTouchableHandle(pPreStepPoint->GetTouchableHandle());
+    aSecondaryTrack->SetParentID(aTrack.GetTrackID());
+
+    aParticleChange.AddSecondary(aSecondaryTrack);
+  }
+
+  return pParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,268 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashColumnExporter.cc
+/// \brief Implementation of the EEShashColumnExporter class
+
+#include "EEShashColumnExporter.hh"
+
+#include "TTree.h"
+#include "TBranch.h"
+#include "TBranchElement.h"
+#include "TLeaf.h"
+
+#include <cstring>
+
+namespace {
+  // value type and size of a ROOT type name, 0 if not exported
+  char TypeCode(const std::string& name, size_t& size)
+  {
+    size = 4;
+    if ( name == "Float_t" || name == "float" ) return 'f';
+    if ( name == "Int_t" || name == "int" ) return 'i';
+    if ( name == "UInt_t" || name == "unsigned int" ) return 'I';
+    size = 8;
+    if ( name == "Double_t" || name == "double" ) return 'd';
+    if ( name == "Long64_t" || name == "long long" ) return 'l';
+    if ( name == "ULong64_t" || name == "unsigned long long" ) return 'L';
+    size = 2;
+    if ( name == "Short_t" || name == "short" ) return 's';
+    if ( name == "UShort_t" || name == "unsigned short" ) return 'S';
+    size = 1;
+    if ( name == "Char_t" || name == "char" ) return 'c';
+    if ( name == "UChar_t" || name == "unsigned char" ) return 'C';
+    if ( name == "Bool_t" || name == "bool" ) return 'b';
+    size = 0;
+    return 0;
+  }
+
+  // bytes of the values of a std::vector of the given type
+  const void* VectorData(void* address, char type, uint64_t& n)
+  {
+    switch ( type ) {
+      case 'f': { std::vector<float>* v = static_cast<std::vector<float>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'd': { std::vector<double>* v = static_cast<std::vector<double>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'i': { std::vector<int>* v = static_cast<std::vector<int>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'I': { std::vector<unsigned int>* v = static_cast<std::vector<unsigned int>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 's': { std::vector<short>* v = static_cast<std::vector<short>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'S': { std::vector<unsigned short>* v = static_cast<std::vector<unsigned short>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'c': { std::vector<char>* v = static_cast<std::vector<char>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'C': { std::vector<unsigned char>* v = static_cast<std::vector<unsigned char>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'l': { std::vector<Long64_t>* v = static_cast<std::vector<Long64_t>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+      case 'L': { std::vector<ULong64_t>* v = static_cast<std::vector<ULong64_t>*>(address);
+                  n = v->size(); return n ? &(*v)[0] : 0; }
+    }
+    n = 0;
+    return 0;
+  }
+
+  const uint64_t kAlignment = 64;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashColumnExporter::EEShashColumnExporter(const G4String& fileName,
+                                             TTree* tree)
+ : fFileName(fileName),
+   fNofEntries(0),
+   fClosed(false)
+{
+  TIter next(tree->GetListOfBranches());
+  while ( TBranch* branch = (TBranch*)next() ) {
+    if ( branch->InheritsFrom(TBranchElement::Class()) ) {
+      // std::vector<T> booked from the object, e.g. "vector<float>"
+      TBranchElement* element = static_cast<TBranchElement*>(branch);
+      std::string className = element->GetClassName();
+      size_t begin = className.find('<'), end = className.rfind('>');
+      if ( className.compare(0, 6, "vector") != 0
+           || begin == std::string::npos || end == std::string::npos ) {
+        G4cout << "EEShashColumnExporter: " << branch->GetName()
+               << " (" << className << ") not exported" << G4endl;
+        continue;
+      }
+      AddColumn(branch->GetName(),
+                className.substr(begin+1, end-begin-1).c_str(),
+                EEShashColumnIndex::kVector, 0, element->GetObject());
+    }
+    else {
+      // leaf list of one leaf, a scalar or a fixed-size array
+      TLeaf* leaf = static_cast<TLeaf*>(branch->GetListOfLeaves()->At(0));
+      if ( ! leaf || branch->GetListOfLeaves()->GetEntries() != 1
+           || leaf->GetLeafCount() ) {
+        G4cout << "EEShashColumnExporter: " << branch->GetName()
+               << " not exported" << G4endl;
+        continue;
+      }
+      AddColumn(branch->GetName(), leaf->GetTypeName(),
+                leaf->GetLen() > 1 ? EEShashColumnIndex::kArray
+                                   : EEShashColumnIndex::kScalar,
+                leaf->GetLen(), leaf->GetValuePointer());
+    }
+  }
+
+  G4cout << "EEShashColumnExporter: " << fColumns.size()
+         << " columns to " << fFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashColumnExporter::~EEShashColumnExporter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashColumnExporter::AddColumn(const char* name, const char* typeName,
+                                      G4int kind, G4int count, void* address)
+{
+  Column column;
+  std::memset(&column.index, 0, sizeof(column.index));
+  column.index.type = TypeCode(typeName, column.valueSize);
+  if ( ! column.index.type || ! address ) {
+    G4cout << "EEShashColumnExporter: " << name << " (" << typeName
+           << ") not exported" << G4endl;
+    return;
+  }
+  std::strncpy(column.index.name, name, sizeof(column.index.name)-1);
+  column.index.kind  = kind;
+  column.index.count = count;
+  column.address = address;
+  column.data = std::tmpfile();
+  if ( kind == EEShashColumnIndex::kVector ) column.offsets.push_back(0);
+
+  if ( ! column.data ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot create a temporary file for column " << name;
+    G4Exception("EEShashColumnExporter::AddColumn()",
+      "MyCode0011", FatalException, msg);
+    return;
+  }
+  fColumns.push_back(column);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashColumnExporter::Fill()
+{
+  for ( size_t i = 0; i < fColumns.size(); ++i ) {
+    Column& column = fColumns[i];
+    const void* values = column.address;
+    uint64_t n = column.index.count;
+    if ( column.index.kind == EEShashColumnIndex::kVector ) {
+      values = VectorData(column.address, column.index.type, n);
+      column.offsets.push_back(column.offsets.back() + n);
+    }
+    if ( n ) std::fwrite(values, column.valueSize, n, column.data);
+    column.index.nValues += n;
+  }
+  ++fNofEntries;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashColumnExporter::Close()
+{
+  if ( fClosed ) return;
+  fClosed = true;
+
+  FILE* out = std::fopen(fFileName.c_str(), "wb");
+  if ( ! out ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write column file " << fFileName;
+    G4Exception("EEShashColumnExporter::Close()",
+      "MyCode0011", JustWarning, msg);
+    return;
+  }
+
+  EEShashColumnHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, "EESHCOL", sizeof(header.magic));
+  header.version  = 1;
+  header.nColumns = fColumns.size();
+  header.nEntries = fNofEntries;
+  std::fwrite(&header, sizeof(header), 1, out);
+
+  for ( size_t i = 0; i < fColumns.size(); ++i ) {
+    Column& column = fColumns[i];
+    Align(out);
+    column.index.dataOffset = std::ftell(out);
+    Copy(column.data, out, column.index.nValues*column.valueSize);
+    std::fclose(column.data);
+    column.data = 0;
+    if ( column.index.kind == EEShashColumnIndex::kVector ) {
+      Align(out);
+      column.index.offsetsOffset = std::ftell(out);
+      std::fwrite(&column.offsets[0], sizeof(uint64_t), column.offsets.size(), out);
+      std::vector<uint64_t>().swap(column.offsets);
+    }
+  }
+
+  Align(out);
+  header.indexOffset = std::ftell(out);
+  for ( size_t i = 0; i < fColumns.size(); ++i )
+    std::fwrite(&fColumns[i].index, sizeof(EEShashColumnIndex), 1, out);
+  std::fseek(out, 0, SEEK_SET);
+  std::fwrite(&header, sizeof(header), 1, out);
+  std::fclose(out);
+
+  G4cout << "EEShashColumnExporter: " << fNofEntries << " events written to "
+         << fFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashColumnExporter::Copy(FILE* from, FILE* to, uint64_t bytes)
+{
+  std::rewind(from);
+  char buffer[1 << 16];
+  while ( bytes > 0 ) {
+    size_t n = std::fread(buffer, 1, bytes < sizeof(buffer) ? bytes : sizeof(buffer), from);
+    if ( n == 0 ) break;
+    std::fwrite(buffer, 1, n, to);
+    bytes -= n;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashColumnExporter::Align(FILE* out)
+{
+  static const char zeros[kAlignment] = { 0 };
+  uint64_t position = std::ftell(out);
+  uint64_t padding = (kAlignment - position % kAlignment) % kAlignment;
+  if ( padding ) std::fwrite(zeros, 1, padding, out);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -29,18 +29,35 @@
 
 #include "EEShashDetectorConstruction.hh"
 #include "EEShashCalorimeterSD.hh"
+#include "EEShashWeightedReadoutSD.hh"
+#include "EEShashFibreFastModel.hh"
+#include "EEShashFibreTable.hh"
+#include "EEShashTileFastModel.hh"
+#include "EEShashTileTable.hh"
+#include "EEShashMaterialDatabase.hh"
+#include "EEShashDetectorMessenger.hh"
+#include "EEShashMatrixParameterisation.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
 #include "G4Box.hh"
 #include "G4Tubs.hh"
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
 #include "G4SDManager.hh"
+#include "G4VSensitiveDetector.hh"
+#include "G4PhysicsOrderedFreeVector.hh"
 
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
@@ -57,11 +74,23 @@
 #include "G4LogicalSurface.hh"
 #include "G4LogicalSkinSurface.hh"
 #include "G4LogicalBorderSurface.hh"
+#include "G4SurfaceProperty.hh"
+#include "G4SolidStore.hh"
+
+#ifdef G4LIB_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <cmath>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <set>
+#include <unistd.h>
 
 using namespace CLHEP;
 
@@ -78,25 +107,519 @@ EEShashDetectorConstruction::EEShashDetectorConstruction( G4double rotation, G4d
    fNofLayers(-1),
 //   fNofBGOs(-1),
    fRotation(rotation),
-   fZtraslation(zTras)
+   fZtraslationInput(zTras),
+   fZtraslation(zTras),
+   fFibreMode(kFibreFullTracking),
+   fFibreTableFile(""),
+   fFibreRegion(0),
+   fTileMode(kTileFullTracking),
+   fTileTableFile(""),
+   fTileRegion(0),
+   fAbsThickness(6.*mm),
+   fActThickness(6.*mm),
+   fCalorSizeXY(17.*mm),
+   fTyvekThickness(0.2*mm),
+   fPlaceAPDs(true),
+   fPlaceHodoscope(true),
+   fPlaceMatrix(false),
+   fParameterisedMatrix(true),
+   fFibreLength(0.),
+   fGeometryReleased(false),
+   fMessenger(0),
+   fGeometryCacheDir(""),
+   fCacheOverlaps(false)
 {
+  fMessenger = new EEShashDetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EEShashDetectorConstruction::~EEShashDetectorConstruction()
 { 
+  delete fMessenger;
+  delete EEShashFibreTable::Instance();
+  delete EEShashTileTable::Instance();
+  EEShashMaterialDatabase::Delete();
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void EEShashDetectorConstruction::SetFibreMode(G4int mode,
+                                               const G4String& tableFile)
+{
+  fFibreMode = mode;
+  fFibreTableFile = tableFile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::SetTileMode(G4int mode,
+                                              const G4String& tableFile)
+{
+  fTileMode = mode;
+  fTileTableFile = tableFile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::SetGeometryCache(const G4String& directory,
+                                                   G4bool checkOverlaps)
+{
+#ifndef G4LIB_USE_GDML
+  if ( directory != "" ) {
+    G4ExceptionDescription msg;
+    msg << "Geant4 is built without GDML, the geometry cache "
+        << directory << " is not used";
+    G4Exception("EEShashDetectorConstruction::SetGeometryCache()",
+      "MyCode0012", JustWarning, msg);
+  }
+#endif
+  fGeometryCacheDir = directory;
+  fCacheOverlaps = checkOverlaps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::ReinitializeGeometry()
+{
+  // before the initialisation the parameters are used by the first Construct()
+  G4ApplicationState state = G4StateManager::GetStateManager()->GetCurrentState();
+  if ( state != G4State_Idle || fGeometryReleased ) return;
+
+  // the regions outlive the volumes: release them while they still exist,
+  // the new ones are added by Construct()
+  G4RegionStore* regionStore = G4RegionStore::GetInstance();
+  for ( size_t i=0; i<regionStore->size(); ++i ) {
+    G4Region* region = (*regionStore)[i];
+    while ( region->GetNumberOfRootVolumes() > 0 )
+      region->RemoveRootLogicalVolume(*region->GetRootLogicalVolumeIterator());
+  }
+
+  G4LogicalBorderSurface::CleanSurfaceTable();
+  G4LogicalSkinSurface::CleanSurfaceTable();
+  G4SurfaceProperty::CleanSurfacePropertyTable();
+
+  // deletes the volumes and solids; Construct() and ConstructSDandField()
+  // are called again at the next run
+  G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+  fGeometryReleased = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 G4VPhysicalVolume* EEShashDetectorConstruction::Construct()
 {
-  // Define materials 
-  DefineMaterials();
+  // Define materials, once: they are kept when the geometry is rebuilt
+  if ( ! G4Material::GetMaterial("CeF3", false) ) DefineMaterials();
+  fGeometryReleased = false;
   
-  // Define volumes
-  return DefineVolumes();
+  // Define volumes, from the cache if this geometry was built before
+  G4String cacheFile = GetGeometryCacheFile();
+  G4VPhysicalVolume* worldPV = 0;
+  if ( cacheFile != "" ) worldPV = ReadGeometryCache(cacheFile);
+
+  if ( worldPV ) {
+    if ( fCacheOverlaps ) {
+      G4PhysicalVolumeStore* pvStore = G4PhysicalVolumeStore::GetInstance();
+      for ( size_t i=0; i<pvStore->size(); ++i ) (*pvStore)[i]->CheckOverlaps();
+    }
+  }
+  else {
+    worldPV = DefineVolumes();
+    if ( cacheFile != "" ) WriteGeometryCache(cacheFile, worldPV);
+  }
+
+  // Fast simulation envelopes and their light tables
+  DefineRegions();
+
+  // Classify the volumes once for the stepping action
+  fRoleTable.Build();
+
+  return worldPV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // reflectivity of the tyvek wrapping and of the champfers of the tiles
+  G4MaterialPropertiesTable* CeF3SurfaceProperties()
+  {
+    const G4int NUM = 2;
+    G4double pp[NUM] = {1.5*eV, 5.1*eV};
+    G4double reflectivity[NUM] = {0.5, 0.5};
+
+    G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
+    mpt->AddProperty("REFLECTIVITY",pp,reflectivity,NUM);
+    return mpt;
+  }
+
+  // name without the pointer suffix the GDML writer appends
+  G4String StrippedName(const G4String& name)
+  {
+    std::string::size_type idx = name.find("0x");
+    return idx == std::string::npos ? name : G4String(name.substr(0, idx));
+  }
+
+  void CollectVolumes(const G4LogicalVolume* lv,
+                      std::set<const G4LogicalVolume*>& visited,
+                      std::set<std::string>& inventory)
+  {
+    if ( ! visited.insert(lv).second ) return;
+
+    // the material must be the one of DefineMaterials(), which has the
+    // constant properties and Birks constants GDML does not keep
+    const G4Material* material = lv->GetMaterial();
+    G4String materialName = material ? StrippedName(material->GetName()) : "none";
+    std::ostringstream line;
+    line << "volume " << StrippedName(lv->GetName()) << " " << materialName
+         << " " << ( material && G4Material::GetMaterial(materialName, false) == material )
+         << " " << ( material && material->GetMaterialPropertiesTable() );
+    inventory.insert(line.str());
+
+    for ( G4int i=0; i<lv->GetNoDaughters(); ++i )
+      CollectVolumes(lv->GetDaughter(i)->GetLogicalVolume(), visited, inventory);
+  }
+
+  // placed volumes with their materials and the optical surfaces, by name:
+  // what Construct(), DefineRegions() and ConstructSDandField() look up,
+  // the same for a geometry and its cache
+  std::set<std::string> GeometryInventory(const G4VPhysicalVolume* worldPV)
+  {
+    std::set<std::string> inventory;
+    std::set<const G4LogicalVolume*> visited;
+    CollectVolumes(worldPV->GetLogicalVolume(), visited, inventory);
+
+    const G4SurfacePropertyTable* surfaces
+      = G4SurfaceProperty::GetSurfacePropertyTable();
+    for ( size_t i=0; i<surfaces->size(); ++i ) {
+      const G4OpticalSurface* surface
+        = dynamic_cast<const G4OpticalSurface*>((*surfaces)[i]);
+      if ( ! surface ) continue;
+      std::ostringstream line;
+      line << "surface " << StrippedName(surface->GetName()) << " "
+           << ( surface->GetMaterialPropertiesTable() != 0 );
+      inventory.insert(line.str());
+    }
+    return inventory;
+  }
+
+  // Calorimeter sensitive detectors, created by ConstructSDandField() and
+  // attached again to the new volumes after ReinitializeGeometry():
+  // logical volume, detector, hits collection, number of cells (0 for the
+  // number of layers) and parent (-1 for placements instead of replicas)
+  struct CalorimeterSDEntry {
+    const char* volume;
+    const char* detector;
+    const char* collection;
+    G4int nofCells;
+    G4int parent;
+  };
+  const CalorimeterSDEntry kCalorimeterSDs[] = {
+    // 3x3 matrix around the central channel
+    { "AbsLV", "AbsSD", "AbsHitsCollection", 0, 1 },
+    { "ActLV", "ActSD", "ActHitsCollection", 0, 1 },
+    // central channel
+    { "ActLV2", "ActSD2", "ActHitsCollection2", 0, 1 },
+    { "AbsLV2", "AbsSD2", "AbsHitsCollection2", 0, 1 },
+    // remaining channels (aka the three channels on the left)
+    { "ActLV3", "ActSD3", "ActHitsCollection3", 0, 1 },
+    { "AbsLV3", "AbsSD3", "AbsHitsCollection3", 0, 1 },
+    // the fibres and the APDs
+    { "FibreCoreLV", "FibrSDCore", "FibrHitsCollectionCore", 4, -1 },
+    { "FibreCladLV", "FibrSDClad", "FibrHitsCollectionClad", 4, -1 },
+    { "APDLV", "APDLV", "APDHitsCollection", 4, -1 }
+    // the beam line counters are not read out; to read them, add
+    // { "PompomLV", "PompomSD", "PompomHitsCollection", 1, 1 },
+    // { "HodoLV", "HodoSD", "HodoHitsCollection", 1, 1 },
+    // { "Scint3LV", "Scint3SD", "Scint1HitsCollection", 1, 1 },
+    // { "Hodo11LV", "Hodo11SD", "Hodo11HitsCollection", 1, 1 }
+  };
+  const G4int kNofCalorimeterSDs
+    = sizeof(kCalorimeterSDs)/sizeof(kCalorimeterSDs[0]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::DefineRegions()
+{
+  extern int nFibres;
+
+  // the regions and light tables are made with the first geometry and
+  // kept, with their fast simulation models, when it is rebuilt; the
+  // messenger refuses to change the tile and fibre dimensions meanwhile,
+  // and a table of other dimensions is never used
+
+  // envelope for the fast simulation of the light collection in the tiles
+  if ( fTileMode != kTileFullTracking ) {
+    // the captures in the fibres are carried to the readout by the fibre table
+    if ( fTileMode == kTileFastSimulation
+         && fFibreMode != kFibreFastSimulation ) {
+      G4ExceptionDescription msg;
+      msg << "The fast simulation of the tiles needs the fibres in fast "
+          << "simulation mode too";
+      G4Exception("EEShashDetectorConstruction::DefineRegions()",
+        "MyCode0017", FatalException, msg);
+    }
+    if ( ! fTileRegion ) {
+      fTileRegion = new G4Region("TileRegion");
+      EEShashTileTable* tileTable
+        = new EEShashTileTable(fCalorSizeXY, fActThickness, nFibres);
+      if ( fTileMode == kTileFastSimulation ) tileTable->Load(fTileTableFile);
+    }
+    CheckLightTable("tile", EEShashTileTable::Instance()->GetSizeXY(), fCalorSizeXY);
+    CheckLightTable("tile", EEShashTileTable::Instance()->GetThickness(), fActThickness);
+    const char* tiles[] = { "ActLV", "ActLV2", "ActLV3" };
+    for ( G4int i=0; i<3; ++i ) AddRegionRoot(fTileRegion, tiles[i]);
+  }
+
+  // envelope for the fast simulation of the light transport in the cores
+  if ( fFibreMode != kFibreFullTracking ) {
+    if ( ! fFibreRegion ) {
+      fFibreRegion = new G4Region("FibreRegion");
+      EEShashFibreTable* fibreTable = new EEShashFibreTable(fFibreLength);
+      if ( fFibreMode == kFibreFastSimulation ) fibreTable->Load(fFibreTableFile);
+    }
+    CheckLightTable("fibre", EEShashFibreTable::Instance()->GetFibreLength(), fFibreLength);
+    AddRegionRoot(fFibreRegion, "FibreCoreLV");
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::CheckLightTable(const G4String& table,
+                                                  G4double tableValue,
+                                                  G4double value) const
+{
+  // the tables are written with a few significant digits
+  if ( std::fabs(tableValue - value) <= 1.e-4*value ) return;
+
+  G4ExceptionDescription msg;
+  msg << "The " << table << " light table is made for a dimension of "
+      << tableValue/mm << " mm, the geometry has " << value/mm << " mm";
+  G4Exception("EEShashDetectorConstruction::CheckLightTable()",
+    "MyCode0016", FatalException, msg);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::SetTileModelFibres() const
+{
+  EEShashTileFastModel* tileModel = EEShashTileFastModel::GetInstance();
+  if ( ! tileModel ) return;
+
+  // the fibre cores placed in the lab, which is not moved in the world
+  tileModel->ClearFibres();
+  G4PhysicalVolumeStore* pvStore = G4PhysicalVolumeStore::GetInstance();
+  for ( size_t i=0; i<pvStore->size(); ++i ) {
+    G4VPhysicalVolume* pv = (*pvStore)[i];
+    if ( GetRole(pv) != kFibreCoreVolume || pv->IsReplicated() ) continue;
+    if ( ! pv->GetMotherLogical()
+         || pv->GetMotherLogical()->GetName() != "lab" ) continue;
+    const G4Tubs* tubs
+      = dynamic_cast<const G4Tubs*>(pv->GetLogicalVolume()->GetSolid());
+    if ( ! tubs ) continue;
+    G4AffineTransform frame(pv->GetRotation(), pv->GetTranslation());
+    tileModel->AddFibre(pv->GetCopyNo(), frame.Inverse(),
+                        tubs->GetZHalfLength());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::AddRegionRoot(G4Region* region,
+                                                const G4String& lvName)
+{
+  G4LogicalVolume* lv
+    = G4LogicalVolumeStore::GetInstance()->GetVolume(lvName, false);
+  if ( ! lv ) {
+    G4ExceptionDescription msg;
+    msg << "No volume " << lvName << " for the region " << region->GetName();
+    G4Exception("EEShashDetectorConstruction::AddRegionRoot()",
+      "MyCode0012", FatalException, msg);
+    return;
+  }
+  region->AddRootLogicalVolume(lv);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String EEShashDetectorConstruction::GetGeometryCacheFile() const
+{
+  if ( fGeometryCacheDir == "" ) return "";
+
+  extern int nLayers;
+  extern int nFibres;
+
+  // to be increased whenever DefineMaterials() or DefineVolumes() change,
+  // so that the files of the previous geometry are not used any more
+  const G4int geometryVersion = 3;
+
+  std::ostringstream key;
+  key.precision(17);
+  key << geometryVersion << " " << fRotation << " " << fZtraslationInput << " "
+      << nLayers << " " << nFibres << " " << fAbsThickness << " "
+      << fActThickness << " " << fCalorSizeXY << " " << fTyvekThickness << " "
+      << fPlaceAPDs << fPlaceHodoscope << fPlaceMatrix << fParameterisedMatrix;
+
+  // FNV-1a hash of the construction parameters
+  const std::string& keyString = key.str();
+  unsigned long long hash = 14695981039346656037ULL;
+  for ( size_t i=0; i<keyString.size(); ++i ) {
+    hash ^= (unsigned char)keyString[i];
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream fileName;
+  fileName << fGeometryCacheDir << "/EEShash_" << std::hex
+           << std::setw(16) << std::setfill('0') << hash << ".gdml";
+  return fileName.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPhysicalVolume*
+EEShashDetectorConstruction::ReadGeometryCache(const G4String& fileName)
+{
+#ifdef G4LIB_USE_GDML
+  // the parameters derived in DefineVolumes() are kept next to the GDML file
+  std::ifstream parameters((fileName+".par").c_str());
+  std::ifstream gdml(fileName.c_str());
+  if ( ! parameters || ! gdml ) return 0;
+
+  G4int nofLayers;
+  G4double zTraslation, calorSizeXY, actThickness, fibreLength;
+  if ( ! ( parameters >> nofLayers >> zTraslation >> calorSizeXY
+                      >> actThickness >> fibreLength ) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read " << fileName << ".par, the geometry is rebuilt";
+    G4Exception("EEShashDetectorConstruction::ReadGeometryCache()",
+      "MyCode0012", JustWarning, msg);
+    return 0;
+  }
+
+  // the volumes, materials and surfaces of the geometry the cache was
+  // written from
+  std::set<std::string> inventory;
+  G4int nofEntries = 0;
+  parameters >> nofEntries;
+  std::string line;
+  std::getline(parameters, line);
+  for ( G4int i=0; i<nofEntries && std::getline(parameters, line); ++i )
+    inventory.insert(line);
+
+  G4cout << "Reading the geometry from the cache " << fileName << G4endl;
+  G4GDMLParser parser;
+  // not validated against the schema, which the batch nodes may not reach;
+  // the names are looked up, without the pointer suffixes of the writer
+  parser.Read(fileName, false);
+  parser.StripNames();
+  G4VPhysicalVolume* worldPV = parser.GetWorldVolume();
+
+  fNofLayers = nofLayers;
+  fZtraslation = zTraslation;
+  fCalorSizeXY = calorSizeXY;
+  fActThickness = actThickness;
+  fFibreLength = fibreLength;
+
+  // GDML does not keep every constant property of the materials nor the
+  // tables of the optical surfaces: the volumes are moved to the materials
+  // of DefineMaterials(), defined first and so found first by name, and the
+  // surface tables are set again
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for ( size_t i=0; i<lvStore->size(); ++i ) {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    G4Material* material
+      = G4Material::GetMaterial(StrippedName(lv->GetMaterial()->GetName()), false);
+    if ( material ) lv->SetMaterial(material);
+  }
+
+  G4MaterialPropertiesTable* cef3Surface = CeF3SurfaceProperties();
+  const G4SurfacePropertyTable* surfaces
+    = G4SurfaceProperty::GetSurfacePropertyTable();
+  for ( size_t i=0; i<surfaces->size(); ++i ) {
+    G4OpticalSurface* surface = dynamic_cast<G4OpticalSurface*>((*surfaces)[i]);
+    if ( ! surface ) continue;
+    surface->SetName(StrippedName(surface->GetName()));
+    if ( surface->GetName() == "SurfCef3Tyvek"
+      || surface->GetName() == "SurfCef3Air" )
+      surface->SetMaterialPropertiesTable(cef3Surface);
+  }
+
+  // the regions and sensitive detectors are attached to these volumes by
+  // name: a cache which does not give the same ones is not used
+  if ( GeometryInventory(worldPV) != inventory ) {
+    G4ExceptionDescription msg;
+    msg << "The volumes, materials or surfaces of " << fileName
+        << " differ from the geometry it was written from, it is rebuilt";
+    G4Exception("EEShashDetectorConstruction::ReadGeometryCache()",
+      "MyCode0012", JustWarning, msg);
+    G4PhysicalVolumeStore::Clean();
+    G4LogicalVolumeStore::Clean();
+    G4SolidStore::Clean();
+    G4LogicalBorderSurface::CleanSurfaceTable();
+    G4LogicalSkinSurface::CleanSurfaceTable();
+    G4SurfaceProperty::CleanSurfacePropertyTable();
+    return 0;
+  }
+
+  return worldPV;
+#else
+  return 0;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorConstruction::WriteGeometryCache(const G4String& fileName,
+                                      G4VPhysicalVolume* worldPV) const
+{
+#ifdef G4LIB_USE_GDML
+  // GDML writes parameterised volumes of CSG solids only, not the extruded
+  // channels of the matrix: that geometry is built by every job
+  if ( fPlaceMatrix && fParameterisedMatrix ) {
+    G4ExceptionDescription msg;
+    msg << "The parameterised matrix cannot be written to GDML, "
+        << fileName << " not written.";
+    G4Exception("EEShashDetectorConstruction::WriteGeometryCache()",
+      "MyCode0012", JustWarning, msg);
+    return;
+  }
+
+  // written under temporary names and renamed, so that the other jobs of a
+  // scan never read a partial file; the GDML file comes last
+  std::ostringstream suffix;
+  suffix << "." << getpid() << ".tmp";
+  G4String parFile = fileName + ".par";
+  G4String parTmp = parFile + suffix.str();
+  G4String gdmlTmp = fileName + suffix.str();
+
+  std::ofstream parameters(parTmp.c_str());
+  parameters.precision(17);
+  parameters << fNofLayers << " " << fZtraslation << " " << fCalorSizeXY << " "
+             << fActThickness << " " << fFibreLength << std::endl;
+  std::set<std::string> inventory = GeometryInventory(worldPV);
+  parameters << inventory.size() << std::endl;
+  for ( std::set<std::string>::const_iterator it = inventory.begin();
+        it != inventory.end(); ++it )
+    parameters << *it << std::endl;
+  parameters.close();
+
+  G4GDMLParser parser;
+  parser.Write(gdmlTmp, worldPV);
+
+  if ( ! parameters
+    || std::rename(parTmp.c_str(), parFile.c_str()) != 0
+    || std::rename(gdmlTmp.c_str(), fileName.c_str()) != 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write the geometry cache " << fileName;
+    G4Exception("EEShashDetectorConstruction::WriteGeometryCache()",
+      "MyCode0012", JustWarning, msg);
+    std::remove(parTmp.c_str());
+    std::remove(gdmlTmp.c_str());
+    return;
+  }
+  G4cout << "Geometry written to the cache " << fileName << G4endl;
+#endif
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -108,25 +631,27 @@ void EEShashDetectorConstruction::DefineMaterials()
   G4double density; 
   G4int ncomponents, natoms;
   G4double fractionmass;
-  G4String symbol;
 
-  G4Element* F  = new G4Element("Fluor" ,symbol="F" , z=9.,  a=18.998*g/mole);
-  G4Element* Ce = new G4Element("Cerium",symbol="Ce", z=58., a=140.11*g/mole);
+  // elements from the NIST database, built once and shared by all materials,
+  // and the optical properties read once from opticalProperties.dat
+  EEShashMaterialDatabase* database = EEShashMaterialDatabase::Instance();
+
+  G4Element* F  = database->GetElement("F");
+  G4Element* Ce = database->GetElement("Ce");
 
-  G4Element* B  = new G4Element("Boron"  ,symbol="B" , z=5. , a=10.81*g/mole);
-  G4Element* Ge = new G4Element("Germanium" ,symbol="Ge", z=32., a=72.64*g/mole);
-  G4Element* O  = new G4Element("Oxygen" ,symbol="O" , z=8. , a=16.00*g/mole);
+  G4Element* B  = database->GetElement("B");
+  G4Element* O  = database->GetElement("O");
 
-  G4Element* N  = new G4Element("Nitrogen" ,symbol="N" , z=7., a= 14.01*g/mole);
+  G4Element* N  = database->GetElement("N");
 
-  G4Element* C  = new G4Element("Carbon" ,symbol="C" , z=6. , a=12.0107*g/mole);
-  G4Element* H  = new G4Element("Hydrogen" ,symbol="H" , z=1. , a=1.00794*g/mole);
+  G4Element* C  = database->GetElement("C");
+  G4Element* H  = database->GetElement("H");
 
-  G4Element* Si  = new G4Element("Silicon" ,symbol="Si" , z=14. , a=28.085*g/mole);
+  G4Element* Si = database->GetElement("Si");
 
-  G4Element* K = new G4Element("Potassium", symbol="K", z=19. , a=39.098*g/mole);
-  G4Element* Cs = new G4Element("Caesium", symbol="Cs", z=55. , a=132.905*g/mole);
-  G4Element* Sb  = new G4Element("Antimony" ,symbol="Sb" , z=51. , a=121.760*g/mole);
+  G4Element* K  = database->GetElement("K");
+  G4Element* Cs = database->GetElement("Cs");
+  G4Element* Sb = database->GetElement("Sb");
 
 
   //PMT Hamamatsu Bialkali Cathode
@@ -219,338 +744,23 @@ void EEShashDetectorConstruction::DefineMaterials()
 
 
   //Optical properties
-  //Air
-  const G4int nEntries_RI = 42;
-  G4double PhotonEnergy_RI[nEntries_RI] =
-    { 0.1000*eV, 1.0000*eV, 1.0121*eV, 1.0332*eV, 1.0552*eV, 1.0781*eV, 1.1021*eV, 1.1271*eV,
-      1.1533*eV, 1.1808*eV, 1.2096*eV, 1.2398*eV, 1.2716*eV, 1.3051*eV, 1.3404*eV, 1.3776*eV,
-      1.4170*eV, 1.4586*eV, 1.5028*eV, 1.5498*eV, 1.5998*eV, 1.6531*eV, 1.7101*eV, 1.7712*eV,
-      1.8368*eV, 1.9074*eV, 1.9837*eV, 2.0664*eV, 2.1562*eV, 2.2543*eV, 2.3616*eV, 2.4797*eV,
-      2.6102*eV, 2.7552*eV, 2.9173*eV, 3.0996*eV, 3.3062*eV, 3.5424*eV, 3.8149*eV, 4.1328*eV,
-      4.5085*eV, 4.9594*eV };
-  G4double RefractiveIndex[nEntries_RI] =
-    { 1.0003, 1.0003, 1.0003, 1.0003,     1.0003, 1.0003, 1.0003, 1.0003,
-      1.0003, 1.0003, 1.0003, 1.0003,      1.0003, 1.0003, 1.0003, 1.0003,
-      1.0003, 1.0003, 1.0003, 1.0003,      1.0003, 1.0003, 1.0003, 1.0003,
-      1.0003, 1.0003, 1.0003, 1.0003,      1.0003, 1.0003, 1.0003, 1.0003,
-      1.0003, 1.0003, 1.0003, 1.0003,      1.0003, 1.0003, 1.0003, 1.0003,
-      1.0003, 1.0003 };
-  G4MaterialPropertiesTable* myMPT = new G4MaterialPropertiesTable();
-  myMPT->AddProperty("RINDEX",PhotonEnergy_RI,RefractiveIndex,nEntries_RI);
-  pAir->SetMaterialPropertiesTable(myMPT);
-
-  //Polystyrene (Fibre core)//////////////////////////////////////////
-  G4double photonEnergy[] =
-    {0.9*eV, 2.00*eV,2.03*eV,2.06*eV,2.09*eV,2.12*eV,2.15*eV,2.18*eV,2.21*eV,2.24*eV,2.27*eV,
-     2.30*eV,2.33*eV,2.36*eV,2.39*eV,2.42*eV,     2.45*eV,2.48*eV,2.51*eV,2.54*eV,2.57*eV,
-     2.60*eV,2.63*eV,2.66*eV,2.69*eV,2.72*eV,    2.75*eV,2.78*eV,2.81*eV,2.84*eV,2.87*eV,
-     2.90*eV,2.93*eV,2.96*eV,2.99*eV,3.02*eV,     3.05*eV,3.08*eV,3.11*eV,3.14*eV,3.17*eV,
-     3.20*eV,3.23*eV,3.26*eV,3.29*eV,3.32*eV,     3.35*eV,3.38*eV,3.41*eV,3.44*eV,3.47*eV 
-     , 5.5*eV };
-  
-  const G4int nEntries = sizeof(photonEnergy)/sizeof(G4double);
-
-  G4double refractiveIndexPS[] =
-    { 1.59,  1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59,
-      1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59,
-      1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59,
-      1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59,
-      1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59, 1.59};
-  assert(sizeof(refractiveIndexPS) == sizeof(photonEnergy));
-  
- 
-
-  //Polystyren absorption length (for different wavelengths)
-  G4double photonEnergy_PS_abs[] ={
-   1.77138 *eV, 1.77138 *eV, 1.77138 *eV, 1.77281 *eV, 1.77443 *eV, 1.77713 *eV, 1.7802 *eV,
-   1.78473 *eV, 1.78965 *eV, 1.79551 *eV, 1.8016 *eV, 1.80978 *eV, 1.81635 *eV, 1.82315 *eV,
-   1.82904 *eV, 1.83805 *eV, 1.84696 *eV, 1.85674 *eV, 1.86563 *eV, 1.87401 *eV, 1.88875 *eV,
-   1.89836 *eV, 1.90911 *eV, 1.91516 *eV, 1.91914 *eV, 1.92335 *eV, 1.92907 *eV, 1.93674 *eV,
-   1.94146 *eV, 1.94901 *eV, 1.95663 *eV, 1.9632 *eV, 1.97425 *eV, 1.98251 *eV, 1.98949 *eV,
-   1.99719 *eV, 2.00267 *eV, 2.00863 *eV, 2.01209 *eV, 2.01533 *eV, 2.01904 *eV, 2.02161 *eV, 
-   2.02371 *eV, 2.02581 *eV, 2.02815 *eV, 2.0298 *eV, 2.03097 *eV, 2.03262 *eV, 2.03427 *eV, 
-   2.03569 *eV, 2.03853 *eV, 2.04138 *eV, 2.04328 *eV, 2.04567 *eV, 2.04782 *eV, 2.05093 *eV,
-   2.05381 *eV, 2.05791 *eV, 2.06106 *eV, 2.06567 *eV, 2.07153 *eV, 2.08186 *eV, 2.0903 *eV, 
-   2.10309 *eV, 2.11323 *eV, 2.12193 *eV, 2.14006 *eV, 2.15347 *eV, 2.16919 *eV, 2.17943 *eV, 
-   2.19361 *eV, 2.22395 *eV, 2.24761 *eV, 2.2712 *eV, 2.28422 *eV, 2.29408 *eV, 2.30252 *eV, 
-   2.31193 *eV, 2.31896 *eV, 2.32419 *eV, 2.32604 *eV, 2.33223 *eV, 2.34189 *eV, 2.34659 *eV,
-   2.36049 *eV, 2.38717 *eV, 2.40287 *eV, 2.43356 *eV, 2.46435 *eV, 2.49486 *eV, 2.52322 *eV, 
-   2.55299 *eV, 2.58004 *eV, 2.60071 *eV, 2.62957 *eV};
-  
-  G4double absPS[] ={ 
-    3.6621*m, 4.52676*m, 4.69522*m, 4.96965*m, 5.29245*m, 5.80285*m, 6.3699*m, 7.3105*m, 
-    8.14816*m, 9.40172*m, 10.657*m, 12.4558*m, 13.9683*m, 15.2778*m, 16.4333*m, 17.2296*m, 
-    17.3058*m, 16.5026*m, 15.9637*m, 15.6445*m, 13.4403*m, 11.4696*m, 9.95195*m, 9.63329*m, 
-    9.87656*m, 9.97734*m, 10.4296*m, 11.1428*m, 11.8879*m, 12.9937*m, 13.8202*m, 14.5395*m,
-    15.3377*m, 15.2778*m, 14.8712*m, 14.3791*m, 13.6752*m, 12.7398*m, 11.4696*m, 10.2385*m, 
-    8.76932*m, 7.40742*m, 6.72013*m, 6.00786*m, 5.43966*m, 5.05312*m, 4.82854*m, 4.67837*m, 
-    4.52152*m, 4.41934*m, 4.36509*m, 4.35536*m, 4.42935*m, 4.62854*m, 4.85853*m, 5.11257*m, 
-    5.52418*m, 5.96207*m, 6.57331*m, 7.33793*m, 8.44734*m, 10.0802*m, 11.2712*m, 12.2991*m, 
-    12.4162*m, 12.7814*m, 12.6165*m, 11.9241*m, 11.2712*m, 10.6861*m, 10.5992*m, 10.0802*m, 
-    9.70501*m, 9.20263*m, 8.7497*m, 8.46562*m, 8.08082*m, 7.40742*m, 6.81379*m, 6.55129*m, 
-    6.41167*m, 6.2981*m, 6.33893*m, 6.47536*m, 6.60662*m, 6.59548*m, 6.4861*m, 6.1399*m, 
-    5.75164*m, 5.3798*m, 4.96965*m, 4.64503*m, 4.26048*m, 3.95462*m, 3.6621*m };
-  
-  assert(sizeof(absPS) == sizeof(photonEnergy_PS_abs));
-
-  const G4int nEntries_PS_abs = sizeof(photonEnergy_PS_abs)/sizeof(G4double);
-
-   /*
-  G4double scintilFast[] =
-    {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-     0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-     0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-     1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0,
-     1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
-  assert(sizeof(scintilFast) == sizeof(photonEnergy));
-  */
-
-  G4double photonEnergy_emis[] = {
-    1.90726 *eV, 1.92014 *eV, 1.9359 *eV, 1.95784 *eV, 1.97001 *eV, 1.98151 *eV, 1.99541 *eV,
-    2.00202 *eV, 2.00951 *eV, 2.01621 *eV, 2.02466 *eV, 2.0321 *eV, 2.04089 *eV, 2.04737 *eV,
-    2.05302 *eV, 2.05783 *eV, 2.0653 *eV, 2.07172 *eV, 2.07772 *eV, 2.08444 *eV, 2.0903 *eV, 
-    2.09369 *eV, 2.10646 *eV, 2.12032 *eV, 2.13036 *eV, 2.1405 *eV, 2.15505 *eV, 2.17174 *eV, 
-    2.18598 *eV, 2.1979 *eV, 2.20693 *eV, 2.214 *eV, 2.22189 *eV, 2.22829 *eV, 2.23524 *eV, 
-    2.24224 *eV, 2.25216 *eV, 2.25821 *eV, 2.27253 *eV, 2.28273 *eV, 2.29274 *eV, 2.30393 *eV,
-    2.31663 *eV, 2.32526 *eV, 2.33283 *eV, 2.33932 *eV, 2.3547 *eV, 2.36796 *eV, 2.38519 *eV,
-    2.3994 *eV, 2.41558 *eV, 2.42436 *eV, 2.42832 *eV, 2.43627 *eV, 2.44489 *eV, 2.45389 *eV,
-    2.46201 *eV, 2.47081 *eV, 2.47778 *eV, 2.48127 *eV, 2.49214 *eV, 2.50279 *eV, 2.51417 *eV,
-    2.52566 *eV, 2.5336 *eV, 2.54964 *eV, 2.56485 *eV, 2.58369 *eV  };
-
-  G4double emissionPS [] = {
-    0.000740953, 0.0007897, 0.000896943, 0.00114068, 0.00132592, 0.0015209, 0.00184263, 
-    0.00194013, 0.00194988, 0.00201812, 0.00213511, 0.00232035, 0.00256409, 0.00272983,
-    0.00285657, 0.00296381, 0.0031978, 0.00349028, 0.00379251, 0.00410449, 0.00430923,
-    0.00435797, 0.00472845, 0.00545965, 0.00590812, 0.00636634, 0.0071073, 0.00802374,
-    0.00885244, 0.0094569, 0.00979812, 0.0101589, 0.0104611, 0.0107633, 0.0111143, 0.0113385, 
-    0.0116603, 0.0119625, 0.0126937, 0.0132494, 0.0137954, 0.0142243, 0.0146436, 0.0148093,
-    0.0148483, 0.0148093, 0.0140489, 0.0132494, 0.011982, 0.0102466, 0.00811148, 0.0070098, 
-    0.00621035, 0.00540116, 0.00466995, 0.00382176, 0.00309055, 0.00224236, 0.00177439,
-    0.00141366, 0.00116993, 0.000994437, 0.000750702, 0.000428973, 0.000263233, 0.000165739, 
-    9.74938e-05, 4.87469e-05   };
-
-  //  for(int k=0; k<sizeof(emissionPS);k++)
-  //    emissionPS[k]= 100*emissionPS[k];  
-
-  assert(sizeof(photonEnergy_emis) == sizeof(emissionPS));
-  const G4int nEntries_emis = sizeof(photonEnergy_emis)/sizeof(G4double);
-
-  G4double photonEnergy_WLS_abs[] = { 1*eV, 2*eV,3*eV, 6*eV};
-  G4double WLS_abs[]= { 10*m, 4*m, 0.1*mm, 0.1*mm};
-
-  const G4int nEntries_WLS_abs = sizeof(photonEnergy_WLS_abs)/sizeof(G4double);
-
-
-  // Add entries into properties table
-  G4MaterialPropertiesTable* mptPolystyrene = new G4MaterialPropertiesTable();
-  mptPolystyrene->AddProperty("RINDEX",photonEnergy,refractiveIndexPS,nEntries);
-
-   mptPolystyrene->AddProperty("ABSLENGTH",photonEnergy_PS_abs,absPS,nEntries_PS_abs);
-   
-  mptPolystyrene->AddProperty("FASTCOMPONENT",photonEnergy_emis,emissionPS,nEntries_emis);
-  //mptPolystyrene->AddConstProperty("SCINTILLATIONYIELD",100./MeV);//10/keV nominally 
-  mptPolystyrene->AddConstProperty("SCINTILLATIONYIELD",0./MeV);//10/keV nominally 
-  mptPolystyrene->AddConstProperty("FASTTIMECONSTANT", 7.0*ns);
- mptPolystyrene->AddConstProperty ("RESOLUTIONSCALE", 1);
-  
-  
-   //mptPolystyrene->AddProperty ("FASTCOMPONENT", photonEnergy, scintilFast, nEntries);
-
-  // Approximation:
-  mptPolystyrene->AddProperty("WLSABSLENGTH",photonEnergy_WLS_abs,WLS_abs,nEntries_WLS_abs);
-  // From Kuraray:
-  //mptPolystyrene->AddProperty("WLSABSLENGTH",photonEnergy_PS_abs,absPS,nEntries_PS_abs);
+  pAir->SetMaterialPropertiesTable(database->CreatePropertiesTable("Air"));
 
-    //mptPolystyrene->AddConstProperty("RESOLUTIONSCALE",1.0);
-  mptPolystyrene->AddProperty("WLSCOMPONENT",photonEnergy_emis,emissionPS,nEntries_emis);
-  mptPolystyrene->AddConstProperty("WLSTIMECONSTANT", 7.0*ns);
-
-
-  polystyrene->SetMaterialPropertiesTable(mptPolystyrene);
+  //Polystyrene (Fibre core)
+  polystyrene->SetMaterialPropertiesTable(database->CreatePropertiesTable("Polystyrene"));
  
   // Set the Birks Constant for the Polystyrene scintillator
     polystyrene->GetIonisation()->SetBirksConstant(0.126*mm/MeV);  
 
+  //PMMA (Fibre clad)
+  PMMA->SetMaterialPropertiesTable(database->CreatePropertiesTable("PMMA"));
 
-  //PMMA
-  G4double refractiveIndexWLSfiber[] =
-    { 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49,
-      1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49,
-      1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49,
-      1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49,
-      1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49, 1.49 , 1.49};
-  assert(sizeof(refractiveIndexWLSfiber) == sizeof(photonEnergy));
-  
-  G4double absWLSfiber[] =  {
-    20.0*m,20.0*m,20.0*m,20.0*m,20.0*m,20.0*m, 20.0*m,20.0*m,20.0*m,20.0*m,20.0*m,
-    20.0*m,20.0*m,20.0*m,20.0*m,20.0*m, 20.0*m,20.0*m,20.0*m,20.0*m,20.0*m,
-    20.0*m,20.0*m,20.0*m,20.0*m,20.0*m, 20.0*m,20.0*m,20.0*m,20.0*m,20.0*m,
-    20.0*m,20.0*m,20.0*m,20.0*m,20.0*m, 20.0*m,20.0*m,20.0*m,20.0*m,20.0*m,
-    20.0*m,20.0*m,20.0*m,20.0*m,20.0*m, 20.0*m,20.0*m,20.0*m,20.0*m,20.0*m,20.0*m };
-  assert(sizeof(absWLSfiber) == sizeof(photonEnergy));
-  /*
-  G4double absWLSfiber[] =
-    {5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,
-     5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,
-     5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,5.40*m,1.10*m,
-     1.10*m,1.10*m,1.10*m,1.10*m,1.10*m,1.10*m, 1.*mm, 1.*mm, 1.*mm, 1.*mm,
-     1.*mm, 1.*mm, 1.*mm, 1.*mm, 1.*mm, 1.*mm, 1.*mm, 1.*mm, 1.*mm, 1.*mm};
-  assert(sizeof(absWLSfiber) == sizeof(photonEnergy));
- 
-  G4double emissionFib[] =
-    {0.05, 0.10, 0.30, 0.50, 0.75, 1.00, 1.50, 1.85, 2.30, 2.75,
-     3.25, 3.80, 4.50, 5.20, 6.00, 7.00, 8.50, 9.50, 11.1, 12.4,
-     12.9, 13.0, 12.8, 12.3, 11.1, 11.0, 12.0, 11.0, 17.0, 16.9,
-     15.0, 9.00, 2.50, 1.00, 0.05, 0.00, 0.00, 0.00, 0.00, 0.00,
-     0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00};
-  assert(sizeof(emissionFib) == sizeof(photonEnergy));
-   */
-  // Add entries into properties table
-  G4MaterialPropertiesTable* mptWLSfiber = new G4MaterialPropertiesTable();
-  mptWLSfiber->AddProperty("RINDEX",photonEnergy,refractiveIndexWLSfiber,nEntries);
-  mptWLSfiber->AddProperty("ABSLENGTH",photonEnergy,absWLSfiber,nEntries);
-  //  mptWLSfiber->AddProperty("WLSABSLENGTH",photonEnergy,absWLSfiber,nEntries);
-    //mptWLSfiber->AddProperty("WLSCOMPONENT",photonEnergy,emissionFib,nEntries);
-    //mptWLSfiber->AddConstProperty("WLSTIMECONSTANT", 0.5*ns);
-   PMMA->SetMaterialPropertiesTable(mptWLSfiber);
-
-
-
-
-  //OPTICAL GREASE ///////////////////////////////////////////////////////////////
-  const G4int nEntries_grease = 35;
-  G4double PhotonEnergy_grease[nEntries_grease] =
-    { 0.0001*eV, 1.000*eV, 2.034*eV, 2.068*eV,
-      2.103*eV, 2.139*eV, 2.177*eV, 2.216*eV,
-      2.256*eV, 2.298*eV, 2.341*eV, 2.386*eV,
-      2.433*eV, 2.481*eV, 2.532*eV, 2.585*eV,
-      2.640*eV, 2.697*eV, 2.757*eV, 2.820*eV,
-      2.885*eV, 2.954*eV, 3.026*eV, 3.102*eV,
-      3.181*eV, 3.265*eV, 3.353*eV, 3.446*eV,
-      3.545*eV, 3.649*eV, 3.760*eV, 3.877*eV,
-      4.002*eV, 4.136*eV, 6.260*eV };
-  G4double RefractiveIndex_grease[nEntries_grease] =
-    { 1.403, 1.403, 1.403, 1.403,      1.403, 1.403, 1.403, 1.403,
-      1.403, 1.403, 1.403, 1.403,      1.403, 1.403, 1.403, 1.403,
-      1.403, 1.403, 1.403, 1.403,      1.403, 1.403, 1.403, 1.403,
-      1.403, 1.403, 1.403, 1.403,      1.403, 1.403, 1.403, 1.403,
-      1.403, 1.403, 1.403 };
-  G4MaterialPropertiesTable* mptGrease = new G4MaterialPropertiesTable();
-  mptGrease->AddProperty("RINDEX", PhotonEnergy_grease, RefractiveIndex_grease, nEntries_grease);
-  //myMPT->AddProperty("ABSLENGTH", PhotonEnergy, Absorption, nEntries);
-  grease->SetMaterialPropertiesTable(mptGrease);
-
-
-
-
-  //CeF3 = sens (sensitive material) //////////////////////////////////////////////////////
-  G4double refractiveIndex_CeF3[] =
-    { 1.68,   1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68,
-      1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68,
-      1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68,
-      1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68,
-      1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68, 1.68  , 1.68};
-  assert(sizeof(refractiveIndex_CeF3) == sizeof(photonEnergy));
-  
-
-  const G4int nEntries_CeF = 178;
-  G4double PhotonEnergy_CeF[nEntries_CeF] = {
-    2.91782 * eV, 2.92101 * eV, 2.92332 * eV, 2.92465 * eV, 2.9267 * eV, 
-    2.92831 * eV, 2.93107 * eV, 2.9342 * eV, 2.93707 * eV, 2.93887 * eV, 
-    2.93959 * eV, 2.94004 * eV, 2.94094 * eV, 2.94247 * eV, 2.94409 * eV, 
-    2.94634 * eV, 2.94924 * eV, 2.95232 * eV, 2.95386 * eV, 2.95631 * eV, 
-    2.95886 * eV, 2.96177 * eV, 2.96406 * eV, 2.96643 * eV, 2.9701 * eV, 
-    2.97249 * eV, 2.97672 * eV, 2.98051 * eV, 2.98384 * eV, 2.98727 * eV, 
-    2.99089 * eV, 2.99546 * eV, 3.00079 * eV, 3.01888 * eV, 3.06098 * eV, 
-    3.07527 * eV, 3.08801 * eV, 3.10356 * eV, 3.13095 * eV, 3.14211 * eV, 
-    3.15345 * eV, 3.16091 * eV, 3.16998 * eV, 3.17899 * eV, 3.18478 * eV, 
-    3.19187 * eV, 3.20431 * eV, 3.21589 * eV, 3.22528 * eV, 3.23428 * eV, 
-    3.24224 * eV, 3.25014 * eV, 3.25498 * eV, 3.25895 * eV, 3.26293 * eV, 
-    3.26659 * eV, 3.26981 * eV, 3.27371 * eV, 3.27773 * eV, 3.28276 * eV, 
-    3.2868 * eV, 3.29029 * eV, 3.29356 * eV, 3.29706 * eV, 3.30102 * eV, 
-    3.30488 * eV, 3.30863 * eV, 3.31399 * eV, 3.31972 * eV, 3.32385 * eV, 
-    3.32914 * eV, 3.33284 * eV, 3.33758 * eV, 3.34234 * eV, 3.34734 * eV, 
-    3.35213 * eV, 3.35821 * eV, 3.36385 * eV, 3.37282 * eV, 3.37887 * eV, 
-    3.38744 * eV, 3.3921 * eV, 3.39678 * eV, 3.3993 * eV, 3.40447 * eV, 
-    3.40894 * eV, 3.41245 * eV, 3.41742 * eV, 3.4218 * eV, 3.42656 * eV, 
-    3.43108 * eV, 3.43537 * eV, 3.43967 * eV, 3.44497 * eV, 3.4493 * eV, 
-    3.455 * eV, 3.4616 * eV, 3.46684 * eV, 3.47323 * eV, 3.47939 * eV, 
-    3.4862 * eV, 3.48961 * eV, 3.49316 * eV, 3.49647 * eV, 3.4999 * eV, 
-    3.50322 * eV, 3.50731 * eV, 3.51218 * eV, 3.51565 * eV, 3.51989 * eV, 
-    3.52493 * eV, 3.52868 * eV, 3.53283 * eV, 3.53725 * eV, 3.54168 * eV, 
-    3.54442 * eV, 3.54926 * eV, 3.55241 * eV, 3.55661 * eV, 3.56109 * eV, 
-    3.56558 * eV, 3.57009 * eV, 3.5754 * eV, 3.58006 * eV, 3.58406 * eV, 
-    3.58968 * eV, 3.59545 * eV, 3.60124 * eV, 3.60651 * eV, 3.61275 * eV, 
-    3.6205 * eV, 3.62761 * eV, 3.63584 * eV, 3.64438 * eV, 3.65408 * eV, 
-    3.66662 * eV, 3.67756 * eV, 3.6897 * eV, 3.7062 * eV, 3.71881 * eV,
-    3.73267 * eV, 3.74722 * eV, 3.76012 * eV, 3.77133 * eV, 3.7832 * eV, 
-    3.79485 * eV, 3.80446 * eV, 3.81806 * eV, 3.82992 * eV, 3.84125 * eV,
-    3.85356 * eV, 3.86472 * eV, 3.87593 * eV, 3.88502 * eV, 3.89572 * eV,
-    3.90427 * eV, 3.91891 * eV, 3.93141 * eV, 3.9414 * eV, 3.95274 * eV,
-    3.96513 * eV, 3.97431 * eV, 3.98519 * eV, 3.99413 * eV, 4.00177 * eV, 
-    4.00744 * eV, 4.0128 * eV, 4.01682 * eV, 4.01984 * eV, 4.02354 * eV, 
-    4.02759 * eV, 4.03063 * eV, 4.03266 * eV, 4.03706 * eV, 4.04249 * eV, 
-    4.04896 * eV, 4.05545 * eV, 4.06334 * eV };
-
-  G4double Emission_CeF[nEntries_CeF] = {
-    8.45186e-06, 0.000141569, 0.000245104, 0.000380334, 0.000547258, 0.000764893,
-    0.00119382, 0.00170516, 0.00223974, 0.00259261, 0.00273206, 0.00290744,
-    0.00304478, 0.00325185, 0.00342934, 0.0036829, 0.00387518, 0.00403154, 
-    0.0041076, 0.00419001, 0.0042703, 0.00433792, 0.0043844, 0.00442666, 
-    0.00447526, 0.00449639, 0.00453865, 0.00458513, 0.0046295, 0.00468444, 
-    0.00474994, 0.00483869, 0.00493377, 0.00525283, 0.00598603, 0.00623113, 
-    0.00645088, 0.0066981, 0.00712703, 0.00728973, 0.0074651, 0.00757075, 
-    0.00770387, 0.00782431, 0.00789192, 0.00796165, 0.00808209, 0.00819619, 
-    0.0082955, 0.00838424, 0.00846876, 0.00856173, 0.00859765, 0.00861244, 
-    0.00862301, 0.00862089, 0.00859554, 0.00855962, 0.00853004, 0.0084751,
-    0.00841805, 0.00838424, 0.008361, 0.00834198, 0.0083441, 0.00834832, 
-    0.0083779, 0.008492, 0.00864625, 0.00880261, 0.00895686, 0.00907518, 
-    0.00923365, 0.00939635, 0.00954215, 0.00964568, 0.0097302, 0.0097788, 
-    0.0098443, 0.00988867, 0.00993938, 0.00996897, 0.0100155, 0.0100429, 
-    0.0100936, 0.0101465, 0.0101951, 0.0102373, 0.0102965, 0.010343, 0.0104063,
-    0.0104486, 0.0105014, 0.0105395, 0.0105733, 0.010569, 0.0105669, 0.0105669, 
-    0.0105669, 0.0105733, 0.0105881, 0.0106134, 0.0106599, 0.0107212, 0.0107698,
-    0.0108606, 0.0109536, 0.0110762, 0.0111649, 0.0112811, 0.011391, 0.0114966, 
-    0.0115812, 0.0116593, 0.0117122, 0.0117502, 0.0117629, 0.0117671, 0.0117671, 
-    0.0117586, 0.0117333, 0.0117164, 0.0116931, 0.0116678, 0.0116572, 0.0116424,
-    0.0116614, 0.0116974, 0.0117312, 0.0117882, 0.0118601, 0.0119319, 0.012008, 
-    0.0120756, 0.0121094, 0.0121136, 0.0120925, 0.0120502, 0.0119488, 0.0118432,
-    0.0117206, 0.0115431, 0.0113741, 0.0112008, 0.0110276, 0.0108163, 0.0106641,
-    0.0104021, 0.0101697, 0.00992037, 0.00964146, 0.00939635, 0.0091597, 
-    0.00896953, 0.00875824, 0.00858075, 0.00827225, 0.00799757, 0.00777782,
-    0.00751581, 0.00721155, 0.00696222, 0.00666218, 0.00632833, 0.00602829,
-    0.0057367, 0.00533523, 0.00492532, 0.00458725, 0.003797, 0.00293068, 
-    0.00213621, 0.00175587, 0.00116847, 0.00074165, 0.000424706, 0.00019228, 0  };
-  assert(sizeof(Emission_CeF) == sizeof(PhotonEnergy_CeF));
-
- 
- G4MaterialPropertiesTable* mptCeF = new G4MaterialPropertiesTable();
- mptCeF->AddProperty ("FASTCOMPONENT", PhotonEnergy_CeF, Emission_CeF, nEntries_CeF);
- mptCeF->AddProperty ("RINDEX", PhotonEnergy_RI, refractiveIndex_CeF3, nEntries_RI);
- // mptCeF->AddProperty ("RINDEX", PhotonEnergy_RI, refractiveIndex_CeF3, nEntries_RI)->SetSpline(true);
- //mptCeF->AddProperty ("ABSLENGTH", PhotonEnergy_ABS, Absorption, nEntries_ABS);
- 
- //mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);//this should be 1000./MeV 
- //test
- //mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 6./MeV);//this should be 1000./MeV
- mptCeF->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);//this should be 1000./MeV 
- mptCeF->AddConstProperty ("RESOLUTIONSCALE", 1);
- // mptCeF->AddConstProperty ("RESOLUTIONSCALE", 2.58);
- mptCeF->AddConstProperty ("FASTTIMECONSTANT", 32.5 *ns);
- 
- 
- G4MaterialPropertiesTable* mptCeF_center = new G4MaterialPropertiesTable();
- mptCeF_center->AddProperty ("FASTCOMPONENT", PhotonEnergy_CeF, Emission_CeF, nEntries_CeF);
- mptCeF_center->AddProperty ("RINDEX", PhotonEnergy_RI, refractiveIndex_CeF3, nEntries_RI);
- mptCeF_center->AddConstProperty ("SCINTILLATIONYIELD", 1000./MeV);//this should be 1000./MeV 
- mptCeF_center->AddConstProperty ("RESOLUTIONSCALE", 1);
- mptCeF_center->AddConstProperty ("FASTTIMECONSTANT", 32.5 *ns);
-  
- sens->SetMaterialPropertiesTable (mptCeF);
- sens_center->SetMaterialPropertiesTable (mptCeF_center);
-
-
+  //OPTICAL GREASE
+  grease->SetMaterialPropertiesTable(database->CreatePropertiesTable("Grease"));
 
+  //CeF3 = sens (sensitive material), same properties in the central channel
+  sens->SetMaterialPropertiesTable(database->CreatePropertiesTable("CeF3"));
+  sens_center->SetMaterialPropertiesTable(database->CreatePropertiesTable("CeF3"));
 
 
   // Print materials
@@ -581,20 +791,20 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
 //  G4double actThickness = 10.*mm;
 //  G4double calorSizeXY  = 24.*mm;
 
-  G4double absThickness = 6.*mm;
-  G4double actThickness = 6.*mm;
-  G4double calorSizeXY  = 17.*mm;
+  G4double absThickness = fAbsThickness;
+  G4double actThickness = fActThickness;
+  G4double calorSizeXY  = fCalorSizeXY;
 
   //  G4double layerThickness = absThickness + actThickness;
 
   G4double rotationDist = 357.*mm; //Because matrix doesn't start at box edge
 
   //Tyvek between layers
-  G4double tyvekThickness = 0.2*mm;
+  G4double tyvekThickness = fTyvekThickness;
 
   G4double layerThickness = absThickness + actThickness + 2.*tyvekThickness;
   G4double calorThickness = fNofLayers * layerThickness;
-  fZtraslation += calorThickness/2.;
+  fZtraslation = fZtraslationInput + calorThickness/2.;
 
   //Tyvek around central channel
   G4double tyvekSizeXY=(calorSizeXY +0.2+0.2)*mm;
@@ -613,6 +823,9 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
   // G4double fibreLength = 50.*mm;
   G4double fibreLength = calorThickness + 128.5*mm;
 
+  // kept for the light tables of the fast simulation, see DefineRegions()
+  fFibreLength = fibreLength;
+
 
   // Weird plastic piece at beginning of shashlik, I shall name it PomPom
   G4double pompomSizeXY = calorSizeXY *mm;
@@ -1336,6 +1549,7 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
       G4double yPosAPD = iy*(fiberRelPos) + sin(fRotation*3.14159265359/180.)*sqrt(((fibreLength-calorThickness)/2.+calorThickness/2.+ fibreLength/2.+greaseThickness +APDThickness/2.)*((fibreLength-calorThickness)/2.+calorThickness/2+ fibreLength/2.+greaseThickness +APDThickness/2.) + xPos*xPos) ;
 
       //place the apd
+      if ( fPlaceAPDs )
       new G4PVPlacement(
                      rotation,                // no rotation
                      G4ThreeVector(xPos,yPosAPD,  cos(-fRotation*3.14159265359/180.)*((fibreLength-calorThickness)/2.+calorThickness/2. + fibreLength/2.+greaseThickness +APDThickness/2.)  - sin(fRotation*3.14159265359/180.)*(iy*(fiberRelPos)) ), // its position
@@ -1444,6 +1658,7 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
                 hodoMaterial,  // its material
                 "HodoLV");   // its name
   
+  if ( fPlaceHodoscope )
   new G4PVPlacement(
 		    rotation,                // no rotation
 		    G4ThreeVector(0.,sin(fRotation*3.14159265359/180.)*(-hodoLength/2.-hodoDistance),  cos(-fRotation*3.14159265359/180.)*(-hodoLength/2.-hodoDistance) ), // its position
@@ -1470,12 +1685,10 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
   
   G4double pp[NUM] = {1.5*eV, 5.1*eV};
   //  G4double rindex[NUM] = {1.59, 1.59};
-  G4double reflectivity[NUM] = {0.5, 0.5};
   G4double reflectivity_Fib[NUM] = {0.9, 0.9};
   G4double efficiency[NUM] = {0.9 , 0.9};
   
-  G4MaterialPropertiesTable *OpSurfacePropertyCef3 = new G4MaterialPropertiesTable();
-  OpSurfacePropertyCef3 -> AddProperty("REFLECTIVITY",pp,reflectivity,NUM);
+  G4MaterialPropertiesTable *OpSurfacePropertyCef3 = CeF3SurfaceProperties();
   //  OpSurfacePropertyCef3 -> AddProperty("EFFICIENCY",pp,efficiency,NUM);
   
   
@@ -1936,6 +2149,77 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
 //  }
       
 
+  // the other channels of the matrix, parameterised: calorLV for ix<=0 and
+  // calorLV3 for ix>0, each in an envelope with nothing else inside; the
+  // left one leaves a hole for the central channel, its tyvek, pompom and
+  // fibres. The envelopes are rotated with the calorimeter as a whole.
+  if ( fPlaceMatrix && fParameterisedMatrix ) {
+    G4double pitch = calorSizeXY + 1.5*mm;  // miniGap of the placements below
+
+    G4VSolid* matrixLeftBoxS
+      = new G4Box("MatrixLeftBox", 1.5*pitch, 1.5*pitch, calorThickness/2.);
+    G4VSolid* matrixHoleS
+      = new G4Box("MatrixHole", pitch/2., pitch/2., calorThickness/2.+1.*mm);
+    G4VSolid* matrixLeftS
+      = new G4SubtractionSolid("MatrixLeft", matrixLeftBoxS, matrixHoleS);
+    G4LogicalVolume* matrixLeftLV
+      = new G4LogicalVolume(matrixLeftS, defaultMaterial, "MatrixLeftLV");
+
+    G4VSolid* matrixRightS
+      = new G4Box("MatrixRight", pitch, 1.5*pitch, calorThickness/2.);
+    G4LogicalVolume* matrixRightLV
+      = new G4LogicalVolume(matrixRightS, defaultMaterial, "MatrixRightLV");
+
+    EEShashMatrixParameterisation* leftParam
+      = new EEShashMatrixParameterisation(pitch, -1.);
+    EEShashMatrixParameterisation* rightParam
+      = new EEShashMatrixParameterisation(pitch, 1.5);
+    for( int ix=-2; ix<=2; ++ix ) {
+      for( int iy=-1; iy<=1; ++iy ) {
+        if( iy==0 && ix==-1 ) continue;  // central channel
+        if( ix<=0 ) leftParam->AddCell(ix, iy);
+        else        rightParam->AddCell(ix, iy);
+      }
+    }
+
+    G4double zPos = fZtraslation;
+    new G4PVPlacement(
+                 rotation,                // rotation
+                 G4ThreeVector(-pitch, sin(fRotation*3.14159265359/180.)*zPos, cos(-fRotation*3.14159265359/180.)*zPos),
+                 matrixLeftLV,            // its logical volume
+                 "MatrixLeft",            // its name
+                 labLV,          // its mother  volume
+                 false,            // no boolean operation
+                 0,                // copy number
+                 fCheckOverlaps);  // checking overlaps
+    new G4PVPlacement(
+                 rotation,                // rotation
+                 G4ThreeVector(1.5*pitch, sin(fRotation*3.14159265359/180.)*zPos, cos(-fRotation*3.14159265359/180.)*zPos),
+                 matrixRightLV,           // its logical volume
+                 "MatrixRight",           // its name
+                 labLV,          // its mother  volume
+                 false,            // no boolean operation
+                 0,                // copy number
+                 fCheckOverlaps);  // checking overlaps
+
+    new G4PVParameterised(
+                 "Calorimeter",    // its name
+                 calorLV,          // its logical volume
+                 matrixLeftLV,     // its mother
+                 kUndefined,       // 3D voxelisation
+                 leftParam->GetNumberOfCells(),
+                 leftParam,
+                 fCheckOverlaps);  // checking overlaps
+    new G4PVParameterised(
+                 "Calorimeter3",   // its name
+                 calorLV3,         // its logical volume
+                 matrixRightLV,    // its mother
+                 kUndefined,       // 3D voxelisation
+                 rightParam->GetNumberOfCells(),
+                 rightParam,
+                 fCheckOverlaps);  // checking overlaps
+  }
+
   int copyNumber = 1;
   int totalCopies = 25;
 
@@ -1973,8 +2257,8 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
 			  copyNumber,                // copy number
 			  fCheckOverlaps);  // checking overlaps 
 
-      }else{
-      /*
+      }else if ( fPlaceMatrix && ! fParameterisedMatrix ) {
+      // the other channels of the matrix, one placement each
   if(ix<=0){
 	new G4PVPlacement(
 			  rotation,                // rotation
@@ -1999,7 +2283,7 @@ G4VPhysicalVolume* EEShashDetectorConstruction::DefineVolumes()
 			  fCheckOverlaps);  // checking overlaps 
 
 
-	}*/
+	}
 
       }
 if(iy==0 && ix==-1){
@@ -2045,86 +2329,58 @@ void EEShashDetectorConstruction::ConstructSDandField()
 {
   // G4SDManager::GetSDMpointer()->SetVerboseLevel(1);
 
+  // After ReinitializeGeometry() the detectors, fast simulation models and
+  // field of this thread exist already: only the new volumes are attached,
+  // from the same table the detectors are created from
+  G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+  G4bool reattach = sdManager->FindSensitiveDetector("AbsSD", false) != 0;
+
   // 
   // Sensitive detectors
   //
-  //
-  // First the actual Shashlik:
-  //3x3 matrix around central channel
-  EEShashCalorimeterSD* absSD 
-    = new EEShashCalorimeterSD("AbsSD", "AbsHitsCollection", fNofLayers,1);
-  SetSensitiveDetector("AbsLV",absSD);
-  
-
-  EEShashCalorimeterSD* actSD 
-    = new EEShashCalorimeterSD("ActSD", "ActHitsCollection", fNofLayers,1);
-  SetSensitiveDetector("ActLV",actSD);
-
-  //central channel
-  EEShashCalorimeterSD* actSD2 
-    = new EEShashCalorimeterSD("ActSD2", "ActHitsCollection2", fNofLayers,1);
-  SetSensitiveDetector("ActLV2",actSD2);
-
-  EEShashCalorimeterSD* absSD2 
-    = new EEShashCalorimeterSD("AbsSD2", "AbsHitsCollection2", fNofLayers,1);
-  SetSensitiveDetector("AbsLV2",absSD2);
-
-  //remaining channels (aka the three channels on the left)
-  EEShashCalorimeterSD* actSD3 
-    = new EEShashCalorimeterSD("ActSD3", "ActHitsCollection3", fNofLayers,1);
-  SetSensitiveDetector("ActLV3",actSD3);
-
-  EEShashCalorimeterSD* absSD3 
-    = new EEShashCalorimeterSD("AbsSD3", "AbsHitsCollection3", fNofLayers,1);
-  SetSensitiveDetector("AbsLV3",absSD3);
-
-
-  // then the surrounding BGO matrix:
-//  EEShashCalorimeterSD* bgoSD 
-//    = new EEShashCalorimeterSD("BgoSD", "BgoHitsCollection", fNofBGOs,-1);//use -1 if it is constructed with placement and not replica
-//  SetSensitiveDetector("BGOLV",bgoSD);
-
-  // then the fibres
-  EEShashCalorimeterSD* fibrSDCore 
-    = new EEShashCalorimeterSD("FibrSDCore", "FibrHitsCollectionCore", 4,-1);
-  SetSensitiveDetector("FibreCoreLV",fibrSDCore);
-
-  EEShashCalorimeterSD* fibrSDClad 
-    = new EEShashCalorimeterSD("FibrSDClad", "FibrHitsCollectionClad", 4,-1);
-  SetSensitiveDetector("FibreCladLV",fibrSDClad);
-
-  EEShashCalorimeterSD* APDSD
-    = new EEShashCalorimeterSD("APDLV", "APDHitsCollection", 4,-1);
-  SetSensitiveDetector("APDLV",APDSD);
-
-  /*
-  // and  POMMMELS:
-  EEShashCalorimeterSD* pompomSD 
-    = new EEShashCalorimeterSD("PompomSD", "PompomHitsCollection", 1,1);
-  SetSensitiveDetector("PompomLV",pompomSD);
-
-  // and now also the HODOR
-    EEShashCalorimeterSD* hodoSD 
-    = new EEShashCalorimeterSD("HodoSD", "HodoHitsCollection", 1,1);
-  SetSensitiveDetector("HodoLV",hodoSD);
-
- // then there is also the Scintillator 3
-  EEShashCalorimeterSD* scint3SD 
-    = new EEShashCalorimeterSD("Scint3SD", "Scint1HitsCollection", 1,1);
-  SetSensitiveDetector("Scint3LV",scint3SD);
-
-  // and now also the HODOR 11
-  EEShashCalorimeterSD* hodo11SD 
-    = new EEShashCalorimeterSD("Hodo11SD", "Hodo11HitsCollection", 1,1);
-  SetSensitiveDetector("Hodo11LV",hodo11SD);
-
-  // and now also the HODOR 12
-  EEShashCalorimeterSD* hodo12SD 
-    = new EEShashCalorimeterSD("Hodo12SD", "Hodo12HitsCollection", 1,1);
-  SetSensitiveDetector("Hodo11LV",hodo12SD);
+  for ( G4int i=0; i<kNofCalorimeterSDs; ++i ) {
+    const CalorimeterSDEntry& entry = kCalorimeterSDs[i];
+    G4VSensitiveDetector* sd = reattach
+      ? sdManager->FindSensitiveDetector(entry.detector)
+      : new EEShashCalorimeterSD(entry.detector, entry.collection,
+                                 entry.nofCells ? entry.nofCells : fNofLayers,
+                                 entry.parent);
+    SetSensitiveDetector(entry.volume, sd);
+  }
+  if ( reattach ) {
+    SetSensitiveDetector("GreaseLV",
+                         sdManager->FindSensitiveDetector("OpticalSD"));
+    SetTileModelFibres();
+    return;
+  }
 
-  */
+  // and the photons reaching the grease at the fibre ends
+  G4double quantumEfficiency = 0.25; //average value of qe
+  G4double mirroringGain = 0.25; //mirroring a fibre at one end gives 25% light more (theoretical max is 50%)
+  EEShashOpticalReadoutSD* opticalSD
+    = new EEShashWeightedReadoutSD("OpticalSD", "OpticalHitsCollection", 4,
+                                   1+mirroringGain);
+  // qe spectrum: the average value in the 480-620 nm window of the photodetector, zero outside
+  const G4int nQE = 4;
+  G4double qeEnergy[nQE] = { 1239.84193/620.001*eV, 1239.84193/620.*eV, 1239.84193/480.*eV, 1239.84193/479.999*eV };
+  G4double qeValue[nQE] = { 0., quantumEfficiency, quantumEfficiency, 0. };
+  opticalSD->SetQuantumEfficiency(new G4PhysicsOrderedFreeVector(qeEnergy, qeValue, nQE));
+  SetSensitiveDetector("GreaseLV",opticalSD);
+
+  // and the parameterised light transport along the fibres
+  if ( fFibreRegion ) {
+    new EEShashFibreFastModel("FibreFastModel", fFibreRegion,
+                              EEShashFibreTable::Instance(), fFibreMode,
+                              opticalSD);
+  }
 
+  // and the parameterised light collection in the tiles
+  if ( fTileRegion ) {
+    new EEShashTileFastModel("TileFastModel", fTileRegion,
+                             EEShashTileTable::Instance(), fTileMode,
+                             EEShashFibreTable::Instance(), opticalSD);
+    SetTileModelFibres();
+  }
 
   // 
   // Magnetic field
@@ -0,0 +1,227 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashDetectorMessenger.cc
+/// \brief Implementation of the EEShashDetectorMessenger class
+
+#include "EEShashDetectorMessenger.hh"
+#include "EEShashDetectorConstruction.hh"
+#include "EEShashFibreFastModel.hh"
+#include "EEShashTileFastModel.hh"
+#include "common.h"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4StateManager.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  G4UIcmdWithADoubleAndUnit* MakeLengthCommand(const char* name,
+                                               const char* guidance,
+                                               G4UImessenger* messenger)
+  {
+    G4UIcmdWithADoubleAndUnit* command
+      = new G4UIcmdWithADoubleAndUnit(name, messenger);
+    command->SetGuidance(guidance);
+    command->SetParameterName("length", false);
+    command->SetRange("length>0.");
+    command->SetUnitCategory("Length");
+    command->SetDefaultUnit("mm");
+    command->AvailableForStates(G4State_PreInit, G4State_Idle);
+    command->SetToBeBroadcasted(false);
+    return command;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashDetectorMessenger::EEShashDetectorMessenger(
+                                       EEShashDetectorConstruction* detector)
+ : G4UImessenger(),
+   fDetector(detector)
+{
+  fGeometryDir = new G4UIdirectory("/EEShash/geometry/");
+  fGeometryDir->SetGuidance("Construction parameters of the calorimeter.");
+  fGeometryDir->SetGuidance("Changes between runs rebuild the geometry at");
+  fGeometryDir->SetGuidance("the next run.");
+
+  std::ostringstream fibreRange;
+  fibreRange << "n>=0 && n<=" << nMaxFibres;
+
+  fNLayersCmd = new G4UIcmdWithAnInteger("/EEShash/geometry/nLayers", this);
+  fNLayersCmd->SetGuidance("Number of layers; the output columns are booked");
+  fNLayersCmd->SetGuidance("from it, so it is set before the initialisation.");
+  fNLayersCmd->SetParameterName("n", false);
+  fNLayersCmd->SetRange("n>0");
+  fNLayersCmd->AvailableForStates(G4State_PreInit);
+  fNLayersCmd->SetToBeBroadcasted(false);
+
+  fNFibresCmd = new G4UIcmdWithAnInteger("/EEShash/geometry/nFibres", this);
+  fNFibresCmd->SetGuidance("Number of read out fibres, set before the");
+  fNFibresCmd->SetGuidance("initialisation.");
+  fNFibresCmd->SetParameterName("n", false);
+  fNFibresCmd->SetRange(fibreRange.str().c_str());
+  fNFibresCmd->AvailableForStates(G4State_PreInit);
+  fNFibresCmd->SetToBeBroadcasted(false);
+
+  fRotationCmd = new G4UIcmdWithADoubleAndUnit("/EEShash/geometry/rotation", this);
+  fRotationCmd->SetGuidance("Rotation of the calorimeter to the beam.");
+  fRotationCmd->SetParameterName("angle", false);
+  fRotationCmd->SetUnitCategory("Angle");
+  fRotationCmd->SetDefaultUnit("deg");
+  fRotationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRotationCmd->SetToBeBroadcasted(false);
+
+  fZtraslationCmd = new G4UIcmdWithADoubleAndUnit("/EEShash/geometry/zTraslation", this);
+  fZtraslationCmd->SetGuidance("Translation along the beam, before the rotation.");
+  fZtraslationCmd->SetParameterName("z", false);
+  fZtraslationCmd->SetUnitCategory("Length");
+  fZtraslationCmd->SetDefaultUnit("mm");
+  fZtraslationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fZtraslationCmd->SetToBeBroadcasted(false);
+
+  fAbsThicknessCmd = MakeLengthCommand("/EEShash/geometry/absThickness",
+    "Thickness of the absorber plates.", this);
+  fActThicknessCmd = MakeLengthCommand("/EEShash/geometry/actThickness",
+    "Thickness of the CeF3 tiles.", this);
+  fTileSizeCmd = MakeLengthCommand("/EEShash/geometry/tileSize",
+    "Transverse size of the tiles.", this);
+  fTyvekThicknessCmd = MakeLengthCommand("/EEShash/geometry/tyvekThickness",
+    "Thickness of the tyvek between the layers.", this);
+
+  fAPDCmd = new G4UIcmdWithABool("/EEShash/geometry/apd", this);
+  fAPDCmd->SetGuidance("Place the APDs behind the grease at the fibre ends.");
+  fAPDCmd->SetParameterName("apd", true);
+  fAPDCmd->SetDefaultValue(true);
+  fAPDCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAPDCmd->SetToBeBroadcasted(false);
+
+  fHodoscopeCmd = new G4UIcmdWithABool("/EEShash/geometry/hodoscope", this);
+  fHodoscopeCmd->SetGuidance("Place the hodoscope in front of the calorimeter.");
+  fHodoscopeCmd->SetParameterName("hodoscope", true);
+  fHodoscopeCmd->SetDefaultValue(true);
+  fHodoscopeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fHodoscopeCmd->SetToBeBroadcasted(false);
+
+  fMatrixCmd = new G4UIcmdWithABool("/EEShash/geometry/matrix", this);
+  fMatrixCmd->SetGuidance("Place the channels around the central one.");
+  fMatrixCmd->SetParameterName("matrix", true);
+  fMatrixCmd->SetDefaultValue(true);
+  fMatrixCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMatrixCmd->SetToBeBroadcasted(false);
+
+  fParameterisedMatrixCmd
+    = new G4UIcmdWithABool("/EEShash/geometry/parameterisedMatrix", this);
+  fParameterisedMatrixCmd->SetGuidance("Place the channels of the matrix as parameterised");
+  fParameterisedMatrixCmd->SetGuidance("volumes (default), or one placement each.");
+  fParameterisedMatrixCmd->SetParameterName("parameterised", true);
+  fParameterisedMatrixCmd->SetDefaultValue(true);
+  fParameterisedMatrixCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fParameterisedMatrixCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashDetectorMessenger::~EEShashDetectorMessenger()
+{
+  delete fNLayersCmd;
+  delete fNFibresCmd;
+  delete fRotationCmd;
+  delete fZtraslationCmd;
+  delete fAbsThicknessCmd;
+  delete fActThicknessCmd;
+  delete fTileSizeCmd;
+  delete fTyvekThicknessCmd;
+  delete fAPDCmd;
+  delete fHodoscopeCmd;
+  delete fMatrixCmd;
+  delete fParameterisedMatrixCmd;
+  delete fGeometryDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashDetectorMessenger::SetNewValue(G4UIcommand* command,
+                                           G4String newValue)
+{
+  // defined in main, read by the detector and the output booking
+  extern int nLayers;
+  extern int nFibres;
+
+  // the light tables of the fast simulation and calibration are made for
+  // the tile and fibre dimensions of the first geometry
+  G4bool dimension = command == fAbsThicknessCmd || command == fActThicknessCmd
+                  || command == fTileSizeCmd || command == fTyvekThicknessCmd;
+  if ( dimension
+       && G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle
+       && ( fDetector->GetTileMode() != kTileFullTracking
+            || fDetector->GetFibreMode() != kFibreFullTracking ) ) {
+    G4ExceptionDescription msg;
+    msg << command->GetCommandPath() << " ignored: the light tables are made"
+        << " for the dimensions of the first geometry, set them before the"
+        << " initialisation";
+    G4Exception("EEShashDetectorMessenger::SetNewValue()",
+      "MyCode0016", JustWarning, msg);
+    return;
+  }
+
+  if ( command == fNLayersCmd )
+    nLayers = fNLayersCmd->GetNewIntValue(newValue);
+  else if ( command == fNFibresCmd )
+    nFibres = fNFibresCmd->GetNewIntValue(newValue);
+  else if ( command == fRotationCmd )
+    fDetector->SetRotation(fRotationCmd->GetNewDoubleValue(newValue)/deg);
+  else if ( command == fZtraslationCmd )
+    fDetector->SetZtraslation(fZtraslationCmd->GetNewDoubleValue(newValue));
+  else if ( command == fAbsThicknessCmd )
+    fDetector->SetAbsThickness(fAbsThicknessCmd->GetNewDoubleValue(newValue));
+  else if ( command == fActThicknessCmd )
+    fDetector->SetActThickness(fActThicknessCmd->GetNewDoubleValue(newValue));
+  else if ( command == fTileSizeCmd )
+    fDetector->SetTileSize(fTileSizeCmd->GetNewDoubleValue(newValue));
+  else if ( command == fTyvekThicknessCmd )
+    fDetector->SetTyvekThickness(fTyvekThicknessCmd->GetNewDoubleValue(newValue));
+  else if ( command == fAPDCmd )
+    fDetector->SetAPDs(fAPDCmd->GetNewBoolValue(newValue));
+  else if ( command == fHodoscopeCmd )
+    fDetector->SetHodoscope(fHodoscopeCmd->GetNewBoolValue(newValue));
+  else if ( command == fMatrixCmd )
+    fDetector->SetMatrix(fMatrixCmd->GetNewBoolValue(newValue));
+  else if ( command == fParameterisedMatrixCmd )
+    fDetector->SetParameterisedMatrix(
+      fParameterisedMatrixCmd->GetNewBoolValue(newValue));
+
+  // between runs: rebuilt at the next one, nothing is done before the
+  // initialisation
+  fDetector->ReinitializeGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,12 +33,19 @@
 #include "EEShashCalorimeterSD.hh"
 #include "EEShashCalorHit.hh"
 #include "EEShashAnalysis.hh"
+#include "EEShashTileTable.hh"
+#include "EEShashEventContext.hh"
+#include "EEShashTreeMerger.hh"
+#include "EEShashTreeWriter.hh"
+#include "EEShashRunTelemetry.hh"
+#include "EEShashShowerLibrary.hh"
 
 #include "G4RunManager.hh"
 #include "G4Event.hh"
 #include "G4SDManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
 
 #include "Randomize.hh"
 #include <iomanip>
@@ -53,7 +60,8 @@ EEShashEventAction::EEShashEventAction()
    fActHCID(-1),
    //fBgoHCID(-1),
    fFibrHCIDCore(-1),
-   fFibrHCIDClad(-1)
+   fFibrHCIDClad(-1),
+   fOpticalHCID(-1)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -83,6 +91,26 @@ EEShashEventAction::GetHitsCollection(G4int hcID,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+EEShashOpticalHitsCollection* 
+EEShashEventAction::GetOpticalHitsCollection(G4int hcID,
+                                  const G4Event* event) const
+{
+  EEShashOpticalHitsCollection* hitsCollection 
+    = static_cast<EEShashOpticalHitsCollection*>(
+        event->GetHCofThisEvent()->GetHC(hcID));
+  
+  if ( ! hitsCollection ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot access hitsCollection ID " << hcID; 
+    G4Exception("EEShashEventAction::GetOpticalHitsCollection()",
+      "MyCode0003", FatalException, msg);
+  }         
+
+  return hitsCollection;
+}    
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void EEShashEventAction::PrintEventStatistics(
                               G4double absEdep, G4double absTrackLength,
                               G4double actEdep, G4double actTrackLength,
@@ -125,8 +153,14 @@ void EEShashEventAction::PrintEventStatistics(
 
 void EEShashEventAction::BeginOfEventAction(const G4Event* /*event*/)
 {
+  EEShashRunTelemetry::BeginOfEvent();
   CreateTree::Instance() -> Clear();
 
+  // photons still pending in the tile calibration belong to the last event
+  if( EEShashTileTable::Instance() ) EEShashTileTable::Instance()->ClearPending();
+  // steps left over by an aborted event
+  if( EEShashShowerLibrary::Instance() ) EEShashShowerLibrary::Instance()->BeginOfEvent();
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -164,6 +198,8 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
       = G4SDManager::GetSDMpointer()->GetCollectionID("FibrHitsCollectionCore");
     fFibrHCIDClad 
       = G4SDManager::GetSDMpointer()->GetCollectionID("FibrHitsCollectionClad");
+    fOpticalHCID
+      = G4SDManager::GetSDMpointer()->GetCollectionID("OpticalHitsCollection");
     fAPDHCID
       = G4SDManager::GetSDMpointer()->GetCollectionID("APDHitsCollection");
 
@@ -188,6 +224,7 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   EEShashCalorHitsCollection* fibrHCCore = GetHitsCollection(fFibrHCIDCore, event);
   EEShashCalorHitsCollection* fibrHCClad = GetHitsCollection(fFibrHCIDClad, event);
   EEShashCalorHitsCollection* APDHC = GetHitsCollection(fAPDHCID, event);
+  EEShashOpticalHitsCollection* opticalHC = GetOpticalHitsCollection(fOpticalHCID, event);
   // EEShashCalorHitsCollection* scint1HC = GetHitsCollection(fScint1HCID, event);
   // EEShashCalorHitsCollection* hodo11HC = GetHitsCollection(fHodo11HCID, event);
   //  EEShashCalorHitsCollection* hodo12HC = GetHitsCollection(fHodo12HCID, event);
@@ -208,6 +245,47 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   // EEShashCalorHit* hodo11Hit = (*hodo11HC)[hodo11HC->entries()-1];
   // EEShashCalorHit* hodo12Hit = (*hodo12HC)[hodo11HC->entries()-1];
  
+  // Sum the photons detected at the end of each fibre, each with its weight
+  G4double fibre[nMaxFibres];
+  G4double fibreVar[nMaxFibres];
+  G4double NPhotFib[nMaxFibres];
+  G4double EOpt[nMaxFibres];
+  for( int i=0; i<nMaxFibres; ++i ) {
+    fibre[i] = 0.;
+    fibreVar[i] = 0.;
+    NPhotFib[i] = 0.;
+    EOpt[i] = 0.;
+  }
+  G4bool waveformMode = CreateTree::GetWaveformMode();
+  if( waveformMode ) {
+    for( int i=0; i<nMaxFibres; ++i ) fWaveform[i].Reset();
+    fWaveformAPD.Reset();
+  }
+  for( G4int i=0; i<opticalHC->entries(); ++i ) {
+    EEShashOpticalHit* opticalHit = (*opticalHC)[i];
+    G4int iFibre = opticalHit->GetFibre();
+    G4double weight = opticalHit->GetWeight();
+    EEShashRunTelemetry::PhotonsDetected(weight);
+    EOpt[iFibre] += weight*opticalHit->GetEnergy()/eV;
+    if( opticalHit->GetProcess() == EEShashOpticalHit::kWLS ) {
+      fibre[iFibre] += weight;
+      fibreVar[iFibre] += weight*weight;
+    }
+    if( opticalHit->GetProcess() == EEShashOpticalHit::kScintillation ) NPhotFib[iFibre] += weight;
+    if( waveformMode ) {
+      fWaveform[iFibre].Fill(opticalHit->GetTime()/ns, weight);
+      continue;
+    }
+    // process code is 3*fibre + 1 (WLS), 2 (scintillation), 3 (cherenkov)
+    G4int code = -1;
+    if( opticalHit->GetProcess() != EEShashOpticalHit::kOther )
+      code = 3*iFibre+opticalHit->GetProcess();
+    CreateTree::Instance() -> AddPhoton(opticalHit->GetTime()/ns,
+                                        opticalHit->GetVertexZ()/mm,
+                                        opticalHit->GetVertexTheta(),
+                                        code, weight);
+  }
+ 
   // Print per event (modulo n)
   //
   G4int eventID = event->GetEventID();
@@ -291,26 +369,28 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   }
   placeHolder=placeHolder+nFibres;
   
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre0  );
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre1  );
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre2  );
-  analysisManager->FillNtupleDColumn(placeHolder++, fibre3  );
+  for(int i=0;i<nMaxFibres;++i){
+    analysisManager->FillNtupleDColumn(placeHolder++, fibre[i]  );
+  }
    
 
+  EEShashEventContext* context = EEShashEventContext::Instance();
+  G4double xBeamPos = context->GetXBeamPos();
+  G4double yBeamPos = context->GetYBeamPos();
+  std::vector<float>& time_vector = context->GetTimeVector();
+
   std::cout << "xPosition = " << xBeamPos << std::endl;
   analysisManager->FillNtupleDColumn(placeHolder++, xBeamPos  );
   std::cout << "yPosition = " << yBeamPos << std::endl;
   analysisManager->FillNtupleDColumn(placeHolder++, yBeamPos  );
 
-  std::cout << "EOpt_0    = " << EOpt_0 << std::endl;
-  std::cout << "EOpt_1    = " << EOpt_1 << std::endl;
-  std::cout << "EOpt_2    = " << EOpt_2 << std::endl;
-  std::cout << "EOpt_3    = " << EOpt_3 << std::endl;
+  for(int i=0;i<nMaxFibres;++i){
+    std::cout << "EOpt_" << i << "    = " << EOpt[i] << std::endl;
+  }
 
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_0  );
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_1  );
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_2  );
-  analysisManager->FillNtupleDColumn(placeHolder++, EOpt_3  );
+  for(int i=0;i<nMaxFibres;++i){
+    analysisManager->FillNtupleDColumn(placeHolder++, EOpt[i]  );
+  }
 
   std::cout<<"filling time"<<std::endl;
   for(unsigned i=0;i<nPhotonsForTiming;++i){
@@ -323,10 +403,10 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   
   std::cout << 1+event->GetEventID() << " events done " << std::endl;
   
-  CreateTree::Instance() -> EOpt_0 = EOpt_0;
-  CreateTree::Instance() -> EOpt_1 = EOpt_1;
-  CreateTree::Instance() -> EOpt_2 = EOpt_2;
-  CreateTree::Instance() -> EOpt_3 = EOpt_3;
+  CreateTree::Instance() -> EOpt_0 = EOpt[0];
+  CreateTree::Instance() -> EOpt_1 = EOpt[1];
+  CreateTree::Instance() -> EOpt_2 = EOpt[2];
+  CreateTree::Instance() -> EOpt_3 = EOpt[3];
   CreateTree::Instance() -> nLayers = nLayers;
 
   CreateTree::Instance() -> Eabs = absHit->GetEdep();
@@ -344,16 +424,20 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
   CreateTree::Instance() -> EfibrCore =  fibrHitCore->GetEdep();
   CreateTree::Instance() -> EfibrClad =  fibrHitClad->GetEdep();
 
-  CreateTree::Instance() -> Fibre_0 = fibre0;
-  CreateTree::Instance() -> Fibre_1 = fibre1;
-  CreateTree::Instance() -> Fibre_2 = fibre2;
-  CreateTree::Instance() -> Fibre_3 = fibre3;
-  CreateTree::Instance() -> NPhot_Act = NPhotAct;
-  CreateTree::Instance() -> NPhot_Fib = NPhotFib;
-  CreateTree::Instance() -> NPhot_Fib2 = NPhotFib2;
-  CreateTree::Instance() -> NPhot_Fib3 = NPhotFib3;
-  CreateTree::Instance() -> NPhot_Fib4 = NPhotFib4;
-  CreateTree::Instance() -> Fibre_start_0 = fibreStart0;
+  CreateTree::Instance() -> Fibre_0 = fibre[0];
+  CreateTree::Instance() -> Fibre_1 = fibre[1];
+  CreateTree::Instance() -> Fibre_2 = fibre[2];
+  CreateTree::Instance() -> Fibre_3 = fibre[3];
+  CreateTree::Instance() -> FibreVar_0 = fibreVar[0];
+  CreateTree::Instance() -> FibreVar_1 = fibreVar[1];
+  CreateTree::Instance() -> FibreVar_2 = fibreVar[2];
+  CreateTree::Instance() -> FibreVar_3 = fibreVar[3];
+  CreateTree::Instance() -> NPhot_Act = context->GetNPhotAct();
+  CreateTree::Instance() -> NPhot_Fib = NPhotFib[0];
+  CreateTree::Instance() -> NPhot_Fib2 = NPhotFib[1];
+  CreateTree::Instance() -> NPhot_Fib3 = NPhotFib[2];
+  CreateTree::Instance() -> NPhot_Fib4 = NPhotFib[3];
+  CreateTree::Instance() -> Fibre_start_0 = context->GetFibreStart0();
   CreateTree::Instance() -> xPosition = xBeamPos;
   CreateTree::Instance() -> yPosition = yBeamPos;
   
@@ -362,7 +446,28 @@ void EEShashEventAction::EndOfEventAction(const G4Event* event)
     CreateTree::Instance() -> EAPD.push_back(APDHit->GetEdep());
   }
 
-  CreateTree::Instance()->Fill(); 
+  if( waveformMode ) {
+    const std::vector<float>& timeAPD = CreateTree::Instance() -> Time_deposit_APD;
+    for( size_t i=0; i<timeAPD.size(); ++i ) fWaveformAPD.Fill(timeAPD[i]);
+    float* samples[nMaxFibres] = { CreateTree::Instance() -> Waveform_0,
+                                   CreateTree::Instance() -> Waveform_1,
+                                   CreateTree::Instance() -> Waveform_2,
+                                   CreateTree::Instance() -> Waveform_3 };
+    for( int i=0; i<nMaxFibres; ++i ) {
+      fWaveform[i].Convolve();
+      fWaveform[i].CopyTo(samples[i]);
+    }
+    fWaveformAPD.Convolve();
+    fWaveformAPD.CopyTo(CreateTree::Instance() -> Waveform_APD);
+  }
+
+  if( EEShashTreeWriter::Instance() ) EEShashTreeWriter::Instance()->Fill();
+  else CreateTree::Instance()->Fill(); 
+  EEShashTreeMerger::EventFilled();
+  EEShashRunTelemetry::EndOfEvent(event);
+
+  EEShashShowerLibrary* showerLibrary = EEShashShowerLibrary::Instance();
+  if( showerLibrary && showerLibrary->IsRecording() ) showerLibrary->EndOfEvent(event);
   
 }  
 
@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashFibreFastModel.cc
+/// \brief Implementation of the EEShashFibreFastModel class
+
+#include "EEShashFibreFastModel.hh"
+#include "EEShashFibreTable.hh"
+#include "EEShashOpticalReadoutSD.hh"
+#include "EEShashOpticalHit.hh"
+#include "TrackInformation.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Tubs.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashFibreFastModel::EEShashFibreFastModel(const G4String& name,
+                                             G4Region* envelope,
+                                             EEShashFibreTable* table,
+                                             G4int mode,
+                                             EEShashOpticalReadoutSD* readout)
+ : G4VFastSimulationModel(name, envelope),
+   fTable(table),
+   fMode(mode),
+   fReadout(readout)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashFibreFastModel::~EEShashFibreFastModel()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashFibreFastModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4OpticalPhoton::OpticalPhotonDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashFibreFastModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+
+  // only the photons re-emitted in the core, at their first step
+  if ( track->GetCurrentStepNumber() > 1 ) return false;
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if ( ! creator || creator->GetProcessSubType() != fOpWLS ) return false;
+
+  if ( fMode == kFibreCalibration ) {
+    G4double distance, cosTheta, lambda;
+    GetLocalCoordinates(fastTrack, distance, cosTheta, lambda);
+    fTable->RecordBirth(track->GetTrackID(), track->GetParentID(),
+                        fTable->GetBin(distance, cosTheta, lambda),
+                        track->GetGlobalTime());
+    return false;
+  }
+
+  return fMode == kFibreFastSimulation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashFibreFastModel::DoIt(const G4FastTrack& fastTrack,
+                                 G4FastStep& fastStep)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+
+  G4double distance, cosTheta, lambda, delay;
+  GetLocalCoordinates(fastTrack, distance, cosTheta, lambda);
+
+  if ( fTable->SampleArrival(distance, cosTheta, lambda, delay) ) {
+    // fibre number is the copy number of the core
+    G4int fibre = fastTrack.GetEnvelopePhysicalVolume()->GetCopyNo();
+    const TrackInformation* info
+      = static_cast<const TrackInformation*>(track->GetUserInformation());
+    const G4ThreeVector& vertex = track->GetVertexPosition();
+    fReadout->AddPhoton(fibre, track->GetTotalEnergy(),
+                        track->GetGlobalTime() + delay,
+                        vertex.z(), vertex.theta(), EEShashOpticalHit::kWLS,
+                        info ? info->GetParticleWeight() : 1.,
+                        info && info->GetQEApplied());
+  }
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashFibreFastModel::GetLocalCoordinates(const G4FastTrack& fastTrack,
+                                                G4double& distance,
+                                                G4double& cosTheta,
+                                                G4double& lambda) const
+{
+  G4double halfLength = fTable->GetFibreLength()/2.;
+  const G4Tubs* tubs = dynamic_cast<const G4Tubs*>(fastTrack.GetEnvelopeSolid());
+  if ( tubs ) halfLength = tubs->GetZHalfLength();
+
+  distance = halfLength - fastTrack.GetPrimaryTrackLocalPosition().z();
+  cosTheta = fastTrack.GetPrimaryTrackLocalDirection().z();
+  lambda   = 1239.84193/(fastTrack.GetPrimaryTrack()->GetTotalEnergy()/eV);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,306 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashFibreTable.cc
+/// \brief Implementation of the EEShashFibreTable class
+
+#include "EEShashFibreTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+EEShashFibreTable* EEShashFibreTable::fInstance = 0;
+G4ThreadLocal EEShashFibreTable::PendingMap* EEShashFibreTable::fPending = 0;
+G4ThreadLocal EEShashFibreTable::ChainMap* EEShashFibreTable::fChains = 0;
+
+namespace {
+  G4Mutex fibreTableMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashFibreTable::EEShashFibreTable(G4double fibreLength, G4int nZ,
+                                     G4int nCos, G4int nLambda,
+                                     G4double lambdaMin, G4double lambdaMax)
+ : fFibreLength(fibreLength),
+   fNZ(nZ),
+   fNCos(nCos),
+   fNLambda(nLambda),
+   fLambdaMin(lambdaMin),
+   fLambdaMax(lambdaMax)
+{
+  G4int nBins = fNZ*fNCos*fNLambda;
+  fGenerated.assign(nBins, 0.);
+  fArrived.assign(nBins, 0.);
+  fSumDelay.assign(nBins, 0.);
+  fSumDelay2.assign(nBins, 0.);
+
+  fInstance = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashFibreTable::~EEShashFibreTable()
+{
+  if ( fInstance == this ) fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashFibreTable::GetBin(G4double distance, G4double cosTheta,
+                                G4double lambda) const
+{
+  if ( distance < 0. || distance > fFibreLength ) return -1;
+  if ( lambda < fLambdaMin || lambda >= fLambdaMax ) return -1;
+
+  G4int iz = G4int(distance/fFibreLength*fNZ);
+  if ( iz >= fNZ ) iz = fNZ-1;
+  G4int icos = G4int((cosTheta+1.)/2.*fNCos);
+  if ( icos < 0 ) icos = 0;
+  if ( icos >= fNCos ) icos = fNCos-1;
+  G4int ilambda = G4int((lambda-fLambdaMin)/(fLambdaMax-fLambdaMin)*fNLambda);
+
+  return (iz*fNCos + icos)*fNLambda + ilambda;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashFibreTable::PendingMap& EEShashFibreTable::GetPending()
+{
+  if ( ! fPending ) fPending = new PendingMap;
+  return *fPending;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashFibreTable::ChainMap& EEShashFibreTable::GetChains()
+{
+  if ( ! fChains ) fChains = new ChainMap;
+  return *fChains;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashFibreTable::RecordBirth(G4int trackID, G4int parentID,
+                                    G4int bin, G4double time)
+{
+  // a re-emission continues the chain of the photon absorbed in the core
+  ChainMap& chains = GetChains();
+  ChainMap::iterator parent = chains.find(parentID);
+  if ( parent != chains.end() ) {
+    chains[trackID] = parent->second;
+    return;
+  }
+
+  if ( bin < 0 ) return;
+  chains[trackID] = trackID;
+  GetPending()[trackID] = std::make_pair(bin, time);
+  G4AutoLock lock(&fibreTableMutex);
+  fGenerated[bin] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashFibreTable::RecordArrival(G4int trackID, G4double time)
+{
+  ChainMap& chains = GetChains();
+  ChainMap::iterator chain = chains.find(trackID);
+  if ( chain == chains.end() ) return;
+
+  PendingMap& pending = GetPending();
+  PendingMap::iterator it = pending.find(chain->second);
+  if ( it == pending.end() ) return;
+
+  G4int bin = it->second.first;
+  G4double delay = (time - it->second.second)/ns;
+  pending.erase(it);
+
+  G4AutoLock lock(&fibreTableMutex);
+  fArrived[bin]   += 1.;
+  fSumDelay[bin]  += delay;
+  fSumDelay2[bin] += delay*delay;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashFibreTable::GetEfficiency(G4int bin) const
+{
+  if ( bin < 0 || fGenerated[bin] <= 0. ) return 0.;
+  return fArrived[bin]/fGenerated[bin];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashFibreTable::SampleArrival(G4double distance, G4double cosTheta,
+                                        G4double lambda, G4double& delay) const
+{
+  delay = 0.;
+  G4int bin = GetBin(distance, cosTheta, lambda);
+  if ( bin < 0 ) return false;
+  if ( G4UniformRand() >= GetEfficiency(bin) ) return false;
+
+  delay = SampleDelay(bin);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashFibreTable::SampleEmission(G4double distance, G4double& lambda,
+                                         G4double& delay) const
+{
+  lambda = 0.;
+  delay = 0.;
+  if ( distance < 0. || distance > fFibreLength ) return false;
+  G4int iz = G4int(distance/fFibreLength*fNZ);
+  if ( iz >= fNZ ) iz = fNZ-1;
+  if ( iz >= G4int(fSliceGenerated.size()) || fSliceGenerated[iz] <= 0. )
+    return false;
+
+  // the direction and wavelength bins of the distance compete for the
+  // photon in proportion to their calibration photons
+  G4int first = iz*fNCos*fNLambda;
+  std::vector<G4double>::const_iterator begin = fSliceArrived.begin() + first;
+  std::vector<G4double>::const_iterator end = begin + fNCos*fNLambda;
+  G4double r = G4UniformRand()*fSliceGenerated[iz];
+  std::vector<G4double>::const_iterator it = std::upper_bound(begin, end, r);
+  if ( it == end ) return false;
+
+  G4int bin = first + G4int(it - begin);
+  G4int ilambda = bin % fNLambda;
+  lambda = fLambdaMin
+           + (ilambda + G4UniformRand())*(fLambdaMax - fLambdaMin)/fNLambda;
+  delay = SampleDelay(bin);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashFibreTable::SampleDelay(G4int bin) const
+{
+  G4double mean = fSumDelay[bin]/fArrived[bin];
+  G4double rms2 = fSumDelay2[bin]/fArrived[bin] - mean*mean;
+  G4double rms  = rms2 > 0. ? std::sqrt(rms2) : 0.;
+
+  G4double delay = G4RandGauss::shoot(mean, rms);
+  if ( delay < 0. ) delay = 0.;
+  return delay*ns;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashFibreTable::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName.c_str());
+  if ( !out ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open fibre table file " << fileName << " for writing";
+    G4Exception("EEShashFibreTable::Write()",
+      "MyCode0006", FatalException, msg);
+    return;
+  }
+
+  out << "# EEShashFibreTable " << fNZ << " " << fNCos << " " << fNLambda
+      << " " << fFibreLength/mm << " " << fLambdaMin << " " << fLambdaMax
+      << "\n";
+  for ( G4int iz = 0; iz < fNZ; ++iz )
+    for ( G4int icos = 0; icos < fNCos; ++icos )
+      for ( G4int ilambda = 0; ilambda < fNLambda; ++ilambda ) {
+        G4int bin = (iz*fNCos + icos)*fNLambda + ilambda;
+        out << iz << " " << icos << " " << ilambda << " "
+            << fGenerated[bin] << " " << fArrived[bin] << " "
+            << fSumDelay[bin] << " " << fSumDelay2[bin] << "\n";
+      }
+
+  G4cout << ">>> EEShashFibreTable: written " << fNZ*fNCos*fNLambda
+         << " bins to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashFibreTable::Load(const G4String& fileName)
+{
+  std::ifstream in(fileName.c_str());
+  std::string line;
+  std::string tag, name;
+  G4int nZ = 0, nCos = 0, nLambda = 0;
+  G4double length = 0.;
+
+  if ( in && std::getline(in, line) ) {
+    std::istringstream header(line);
+    header >> tag >> name >> nZ >> nCos >> nLambda >> length
+           >> fLambdaMin >> fLambdaMax;
+  }
+  if ( name != "EEShashFibreTable" || nZ <= 0 || nCos <= 0 || nLambda <= 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read fibre table file " << fileName;
+    G4Exception("EEShashFibreTable::Load()",
+      "MyCode0006", FatalException, msg);
+    return;
+  }
+
+  fNZ = nZ;
+  fNCos = nCos;
+  fNLambda = nLambda;
+  fFibreLength = length*mm;
+
+  G4int nBins = fNZ*fNCos*fNLambda;
+  fGenerated.assign(nBins, 0.);
+  fArrived.assign(nBins, 0.);
+  fSumDelay.assign(nBins, 0.);
+  fSumDelay2.assign(nBins, 0.);
+
+  G4int iz, icos, ilambda;
+  G4double generated, arrived, sumDelay, sumDelay2;
+  while ( in >> iz >> icos >> ilambda
+             >> generated >> arrived >> sumDelay >> sumDelay2 ) {
+    if ( iz < 0 || iz >= fNZ || icos < 0 || icos >= fNCos ||
+         ilambda < 0 || ilambda >= fNLambda ) continue;
+    G4int bin = (iz*fNCos + icos)*fNLambda + ilambda;
+    fGenerated[bin] = generated;
+    fArrived[bin]   = arrived;
+    fSumDelay[bin]  = sumDelay;
+    fSumDelay2[bin] = sumDelay2;
+  }
+
+  fSliceGenerated.assign(fNZ, 0.);
+  fSliceArrived.assign(nBins, 0.);
+  for ( G4int bin = 0; bin < nBins; ++bin ) {
+    G4int slice = bin/(fNCos*fNLambda);
+    G4double arrived = bin%(fNCos*fNLambda) ? fSliceArrived[bin-1] : 0.;
+    fSliceGenerated[slice] += fGenerated[bin];
+    fSliceArrived[bin] = arrived + fArrived[bin];
+  }
+
+  G4cout << ">>> EEShashFibreTable: loaded " << nBins
+         << " bins from " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,162 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashKillPolicyMessenger.cc
+/// \brief Implementation of the EEShashKillPolicyMessenger class
+
+#include "EEShashKillPolicyMessenger.hh"
+#include "EEShashOpticalKillPolicy.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4Threading.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashKillPolicyMessenger::EEShashKillPolicyMessenger()
+ : G4UImessenger()
+{
+  fKillPolicyDir = new G4UIdirectory("/EEShash/killPolicy/");
+  fKillPolicyDir->SetGuidance("Limits beyond which optical photons are killed.");
+
+  fTimeWindowCmd = new G4UIcmdWithADoubleAndUnit("/EEShash/killPolicy/timeWindow", this);
+  fTimeWindowCmd->SetGuidance("End of the readout window; later photons are");
+  fTimeWindowCmd->SetGuidance("killed, or not tracked if born after it.");
+  fTimeWindowCmd->SetGuidance("0 switches it off.");
+  fTimeWindowCmd->SetParameterName("tMax", false);
+  fTimeWindowCmd->SetRange("tMax>=0.");
+  fTimeWindowCmd->SetDefaultUnit("ns");
+  fTimeWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTimeWindowCmd->SetToBeBroadcasted(false);
+
+  fMaxStepsCmd = new G4UIcmdWithAnInteger("/EEShash/killPolicy/maxSteps", this);
+  fMaxStepsCmd->SetGuidance("Maximum number of steps of an optical photon;");
+  fMaxStepsCmd->SetGuidance("0 switches it off.");
+  fMaxStepsCmd->SetParameterName("n", false);
+  fMaxStepsCmd->SetRange("n>=0");
+  fMaxStepsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMaxStepsCmd->SetToBeBroadcasted(false);
+
+  fMaxVertexStepsCmd = MakeRoleCommand("maxVertexSteps",
+    "Maximum number of steps of the photons born in a volume role;");
+
+  fMaxPathLengthCmd = new G4UIcmdWithADoubleAndUnit("/EEShash/killPolicy/maxPathLength", this);
+  fMaxPathLengthCmd->SetGuidance("Maximum path length of an optical photon;");
+  fMaxPathLengthCmd->SetGuidance("0 switches it off.");
+  fMaxPathLengthCmd->SetParameterName("length", false);
+  fMaxPathLengthCmd->SetRange("length>=0.");
+  fMaxPathLengthCmd->SetDefaultUnit("m");
+  fMaxPathLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMaxPathLengthCmd->SetToBeBroadcasted(false);
+
+  fMaxBouncesCmd = MakeRoleCommand("maxBounces",
+    "Maximum number of boundary hits while travelling in a volume role;");
+
+  fTimingCmd = new G4UIcmdWithABool("/EEShash/killPolicy/timing", this);
+  fTimingCmd->SetGuidance("Measure the CPU time spent on the killed photons before the kill.");
+  fTimingCmd->SetParameterName("timing", true);
+  fTimingCmd->SetDefaultValue(true);
+  fTimingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTimingCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashKillPolicyMessenger::~EEShashKillPolicyMessenger()
+{
+  delete fTimeWindowCmd;
+  delete fMaxStepsCmd;
+  delete fMaxVertexStepsCmd;
+  delete fMaxPathLengthCmd;
+  delete fMaxBouncesCmd;
+  delete fTimingCmd;
+  delete fKillPolicyDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4UIcommand* EEShashKillPolicyMessenger::MakeRoleCommand(const char* name,
+                                                         const char* guidance)
+{
+  G4UIcommand* command
+    = new G4UIcommand(G4String("/EEShash/killPolicy/") + name, this);
+  command->SetGuidance(guidance);
+  command->SetGuidance("0 switches it off.");
+  G4UIparameter* role = new G4UIparameter("role", 's', false);
+  role->SetParameterCandidates("other act fibre grease apd");
+  command->SetParameter(role);
+  G4UIparameter* n = new G4UIparameter("n", 'i', false);
+  n->SetParameterRange("n>=0");
+  command->SetParameter(n);
+  command->AvailableForStates(G4State_PreInit, G4State_Idle);
+  command->SetToBeBroadcasted(false);
+  return command;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashKillPolicyMessenger::SetNewValue(G4UIcommand* command,
+                                             G4String newValue)
+{
+  if ( ! G4Threading::IsMasterThread() ) return;
+
+  if ( command == fTimeWindowCmd ) {
+    EEShashOpticalKillPolicy::SetTimeWindow(
+      fTimeWindowCmd->GetNewDoubleValue(newValue));
+  }
+
+  if ( command == fMaxStepsCmd ) {
+    EEShashOpticalKillPolicy::SetMaxSteps(fMaxStepsCmd->GetNewIntValue(newValue));
+  }
+
+  if ( command == fMaxVertexStepsCmd || command == fMaxBouncesCmd ) {
+    G4String roleName;
+    G4int n;
+    std::istringstream is(newValue);
+    is >> roleName >> n;
+    G4int role = EEShashOpticalKillPolicy::GetRole(roleName);
+    if ( command == fMaxVertexStepsCmd )
+      EEShashOpticalKillPolicy::SetMaxVertexSteps(role, n);
+    else
+      EEShashOpticalKillPolicy::SetMaxBounces(role, n);
+  }
+
+  if ( command == fMaxPathLengthCmd ) {
+    EEShashOpticalKillPolicy::SetMaxPathLength(
+      fMaxPathLengthCmd->GetNewDoubleValue(newValue));
+  }
+
+  if ( command == fTimingCmd ) {
+    EEShashOpticalKillPolicy::SetTiming(fTimingCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,237 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashMaterialDatabase.cc
+/// \brief Implementation of the EEShashMaterialDatabase class
+
+#include "EEShashMaterialDatabase.hh"
+#include "G4NistManager.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4UnitsTable.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <fstream>
+#include <sstream>
+
+EEShashMaterialDatabase* EEShashMaterialDatabase::fInstance = 0;
+G4String EEShashMaterialDatabase::fFileName = "opticalProperties.dat";
+
+namespace {
+  G4Mutex materialDatabaseMutex = G4MUTEX_INITIALIZER;
+
+  // version of the file format read by Load()
+  const G4int kFileVersion = 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashMaterialDatabase* EEShashMaterialDatabase::Instance()
+{
+  if ( ! fInstance ) {
+    G4AutoLock lock(&materialDatabaseMutex);
+    if ( ! fInstance ) fInstance = new EEShashMaterialDatabase(fFileName);
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashMaterialDatabase::Delete()
+{
+  delete fInstance;
+  fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashMaterialDatabase::EEShashMaterialDatabase(const G4String& fileName)
+{
+  Load(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Element* EEShashMaterialDatabase::GetElement(const G4String& symbol) const
+{
+  return G4NistManager::Instance()->FindOrBuildElement(symbol);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashMaterialDatabase::HasProperties(const G4String& section) const
+{
+  return fSections.find(section) != fSections.end();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4MaterialPropertiesTable*
+EEShashMaterialDatabase::CreatePropertiesTable(const G4String& section) const
+{
+  std::map<G4String, Section>::const_iterator it = fSections.find(section);
+  if ( it == fSections.end() ) {
+    G4ExceptionDescription msg;
+    msg << "No optical properties of " << section << " in " << fFileName;
+    G4Exception("EEShashMaterialDatabase::CreatePropertiesTable()",
+      "MyCode0013", FatalException, msg);
+    return 0;
+  }
+
+  G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
+  const std::vector<Property>& properties = it->second.properties;
+  for ( size_t i=0; i<properties.size(); ++i ) {
+    const Property& property = properties[i];
+    mpt->AddProperty(property.key.c_str(),
+                     const_cast<G4double*>(&property.energy[0]),
+                     const_cast<G4double*>(&property.value[0]),
+                     property.energy.size());
+  }
+  const std::vector<std::pair<G4String,G4double> >& constants
+    = it->second.constants;
+  for ( size_t i=0; i<constants.size(); ++i )
+    mpt->AddConstProperty(constants[i].first.c_str(), constants[i].second);
+
+  return mpt;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashMaterialDatabase::SetProperties(G4Material* material,
+                                            const G4String& section) const
+{
+  material->SetMaterialPropertiesTable(CreatePropertiesTable(section));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashMaterialDatabase::SetProperties(G4Material* material) const
+{
+  SetProperties(material, material->GetName());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashMaterialDatabase::GetUnit(const G4String& unit,
+                                          const G4String& fileName)
+{
+  if ( unit == "1" ) return 1.;
+  if ( unit.size() > 2 && unit.substr(0,2) == "1/" )
+    return 1./GetUnit(unit.substr(2), fileName);
+  if ( ! G4UnitDefinition::IsUnitDefined(unit) ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown unit " << unit << " in " << fileName;
+    G4Exception("EEShashMaterialDatabase::Load()",
+      "MyCode0013", FatalException, msg);
+    return 1.;
+  }
+  return G4UnitDefinition::GetValueOf(unit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashMaterialDatabase::Load(const G4String& fileName)
+{
+  std::ifstream in(fileName.c_str());
+  std::string line, tag;
+  G4int version = 0;
+
+  if ( in && std::getline(in, line) ) {
+    std::istringstream header(line);
+    header >> tag >> version;
+  }
+  if ( tag != "EEShashOpticalProperties" || version != kFileVersion ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read optical properties file " << fileName
+        << " (expected EEShashOpticalProperties " << kFileVersion << ")";
+    G4Exception("EEShashMaterialDatabase::Load()",
+      "MyCode0013", FatalException, msg);
+    return;
+  }
+
+  Section* section = 0;
+  G4int nProperties = 0;
+  while ( std::getline(in, line) ) {
+    std::istringstream record(line);
+    std::string key;
+    if ( ! (record >> tag) || tag[0] == '#' ) continue;
+
+    G4bool ok = true;
+    if ( tag == "material" ) {
+      std::string name;
+      ok = bool(record >> name);
+      if ( ok ) section = &fSections[name];
+    }
+    else if ( tag == "property" && section ) {
+      G4int n = 0;
+      std::string energyUnit, valueUnit;
+      ok = bool(record >> key >> n >> energyUnit >> valueUnit) && n > 1;
+      if ( ok ) {
+        G4double eUnit = GetUnit(energyUnit, fileName);
+        G4double vUnit = GetUnit(valueUnit, fileName);
+        Property property;
+        property.key = key;
+        property.energy.resize(n);
+        property.value.resize(n);
+        for ( G4int i=0; ok && i<n; ++i ) {
+          ok = bool(in >> property.energy[i] >> property.value[i]);
+          property.energy[i] *= eUnit;
+          property.value[i] *= vUnit;
+          if ( i > 0 && property.energy[i] < property.energy[i-1] ) ok = false;
+        }
+        std::getline(in, line);  // rest of the last entry line
+        if ( ok ) {
+          section->properties.push_back(property);
+          ++nProperties;
+        }
+      }
+    }
+    else if ( tag == "const" && section ) {
+      G4double value;
+      std::string unit;
+      ok = bool(record >> key >> value >> unit);
+      if ( ok )
+        section->constants.push_back(
+          std::make_pair(G4String(key), value*GetUnit(unit, fileName)));
+    }
+    else ok = false;
+
+    if ( ! ok ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot read optical properties file " << fileName
+          << " at \"" << line << "\"";
+      G4Exception("EEShashMaterialDatabase::Load()",
+        "MyCode0013", FatalException, msg);
+      return;
+    }
+  }
+
+  G4cout << ">>> EEShashMaterialDatabase: loaded " << nProperties
+         << " properties of " << fSections.size() << " materials from "
+         << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
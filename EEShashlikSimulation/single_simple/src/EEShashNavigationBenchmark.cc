@@ -0,0 +1,332 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashNavigationBenchmark.cc
+/// \brief Implementation of the EEShashNavigationBenchmark class
+
+#include "EEShashNavigationBenchmark.hh"
+#include "EEShashNavigationMessenger.hh"
+
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4GeometryManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelProxy.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Timer.hh"
+#include "G4ios.hh"
+
+#include <cmath>
+#include <set>
+#include <algorithm>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // headers and nodes of a smart voxel tree; equal slices share a proxy
+  void CountVoxels(const G4SmartVoxelHeader* header,
+                   std::set<const void*>& headers,
+                   std::set<const void*>& nodes)
+  {
+    if ( ! headers.insert(header).second ) return;
+    for ( size_t i=0; i<header->GetNoSlices(); ++i ) {
+      G4SmartVoxelProxy* proxy = header->GetSlice(i);
+      if ( proxy->IsHeader() ) CountVoxels(proxy->GetHeader(), headers, nodes);
+      else                     nodes.insert(proxy->GetNode());
+    }
+  }
+
+  const char* AxisName(EAxis axis)
+  {
+    switch ( axis ) {
+      case kXAxis: return "x";
+      case kYAxis: return "y";
+      case kZAxis: return "z";
+      case kRho:   return "rho";
+      case kPhi:   return "phi";
+      default:     return "-";
+    }
+  }
+
+  struct MoreSteps {
+    const std::vector<G4long>& fSteps;
+    MoreSteps(const std::vector<G4long>& steps) : fSteps(steps) {}
+    G4long Steps(const G4LogicalVolume* lv) const {
+      size_t id = lv->GetInstanceID();
+      return id<fSteps.size() ? fSteps[id] : 0;
+    }
+    bool operator()(const G4LogicalVolume* a, const G4LogicalVolume* b) const {
+      return Steps(a) > Steps(b);
+    }
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashNavigationBenchmark::EEShashNavigationBenchmark()
+ : fPattern(kBeamRays),
+   fOptical(false),
+   fHalfWidth(50.*mm),
+   fOrigin(),
+   fMaxBounces(100),
+   fMessenger(0)
+{
+  fMessenger = new EEShashNavigationMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashNavigationBenchmark::~EEShashNavigationBenchmark()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::MakeRay(G4int ray, G4int nRays, G4double zStart,
+                                         G4ThreeVector& point,
+                                         G4ThreeVector& direction) const
+{
+  if ( fPattern == kIsotropicRays ) {
+    // Fibonacci sphere: even coverage, the same rays at every scan
+    G4double cosTheta = 1. - (2.*ray+1.)/nRays;
+    G4double sinTheta = std::sqrt(1. - cosTheta*cosTheta);
+    G4double phi = ray*pi*(3.-std::sqrt(5.));
+    point = fOrigin;
+    direction.set(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+    return;
+  }
+
+  // upstream of the calorimeter on a square grid, tilted towards the axis
+  G4int nGrid = std::max(1, G4int(std::sqrt(G4double(nRays))));
+  G4int gx = ray%nGrid;
+  G4int gy = (ray/nGrid)%nGrid;
+  G4double fx = nGrid>1 ? 2.*gx/(nGrid-1)-1. : 0.;
+  G4double fy = nGrid>1 ? 2.*gy/(nGrid-1)-1. : 0.;
+  point.set(fx*fHalfWidth, fy*fHalfWidth, zStart);
+  direction = G4ThreeVector(-0.002*fx, -0.002*fy, 1.).unit();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::Scan(G4int nRays) const
+{
+  G4VPhysicalVolume* worldPV = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking()->GetWorldVolume();
+  if ( nRays<=0 || ! worldPV ) return;
+
+  // upstream face of the world, inside it
+  G4double zStart
+    = worldPV->GetLogicalVolume()->GetSolid()->GetExtent().GetZmin() + 1.*mm;
+
+  G4Navigator navigator;
+  navigator.SetWorldVolume(worldPV);
+
+  // a few steps can be limited to zero at the boundaries; a ray stuck on
+  // one gives up rather than looping
+  const G4int maxStepsPerRay = 100000;
+
+  // by G4LogicalVolume::GetInstanceID()
+  std::vector<G4long> steps;
+
+  G4long nSteps = 0;
+  G4long nZeroSteps = 0;
+  G4long nBounces = 0;
+  G4int nStuck = 0;
+  G4Timer timer;
+  timer.Start();
+  for ( G4int i=0; i<nRays; ++i ) {
+    G4ThreeVector point, direction;
+    MakeRay(i, nRays, zStart, point, direction);
+
+    G4VPhysicalVolume* volume
+      = navigator.LocateGlobalPointAndSetup(point, &direction, false, false);
+    G4int bounces = 0;
+    G4int n = 0;
+    for ( ; volume && n<maxStepsPerRay; ++n ) {
+      size_t id = volume->GetLogicalVolume()->GetInstanceID();
+      if ( id >= steps.size() ) steps.resize(id+1, 0);
+      ++steps[id];
+
+      G4double safety = 0.;
+      G4double step = navigator.ComputeStep(point, direction, kInfinity, safety);
+      if ( step == kInfinity ) break;
+      if ( step <= 0. ) ++nZeroSteps;
+      point += step*direction;
+      navigator.SetGeometricallyLimitedStep();
+      ++nSteps;
+      volume = navigator.LocateGlobalPointAndSetup(point, &direction, true);
+
+      // an optical photon is reflected back into the volume it left
+      if ( fOptical && volume && bounces<fMaxBounces ) {
+        G4bool valid = false;
+        G4ThreeVector normal = navigator.GetGlobalExitNormal(point, &valid);
+        if ( valid ) {
+          direction -= 2.*direction.dot(normal)*normal;
+          volume = navigator.LocateGlobalPointAndSetup(point, &direction, true, false);
+          ++bounces;
+        }
+      }
+    }
+    nBounces += bounces;
+    if ( n == maxStepsPerRay ) ++nStuck;
+  }
+  timer.Stop();
+
+  G4cout << ">>> Navigation scan, " << nRays
+         << ( fOptical ? " optical photons" : " geantinos" );
+  if ( fPattern == kIsotropicRays ) G4cout << " from " << fOrigin/mm << " mm";
+  else G4cout << " in +-" << fHalfWidth/mm << " mm";
+  G4cout << " <<<" << G4endl;
+  G4cout << "    physical volumes : " << G4PhysicalVolumeStore::GetInstance()->size() << G4endl;
+  G4cout << "    steps            : " << nSteps << " (" << G4double(nSteps)/nRays
+         << " per ray, " << nZeroSteps << " of zero length)" << G4endl;
+  if ( fOptical ) G4cout << "    reflections      : " << nBounces << G4endl;
+  if ( nStuck ) G4cout << "    stuck rays       : " << nStuck << G4endl;
+  if ( nSteps ) G4cout << "    navigation       : "
+                       << timer.GetRealElapsed()/nSteps*1.e9 << " ns/step" << G4endl;
+  PrintVoxelStatistics(&steps);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::PrintVoxelStatistics(
+                                       const std::vector<G4long>* steps) const
+{
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  std::vector<G4LogicalVolume*> volumes;
+  G4long totalSteps = 0;
+  for ( size_t i=0; i<lvStore->size(); ++i ) {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    G4long lvSteps = steps ? MoreSteps(*steps).Steps(lv) : 0;
+    totalSteps += lvSteps;
+    if ( lv->GetNoDaughters() > 0 || lvSteps > 0 ) volumes.push_back(lv);
+  }
+  if ( steps ) std::stable_sort(volumes.begin(), volumes.end(), MoreSteps(*steps));
+
+  G4cout << "    " << std::left << std::setw(20) << "logical volume"
+         << std::right << std::setw(10) << "daughters"
+         << std::setw(12) << "steps" << std::setw(8) << "%"
+         << std::setw(10) << "smartless" << std::setw(5) << "opt"
+         << std::setw(6) << "axis" << std::setw(8) << "slices"
+         << std::setw(9) << "headers" << std::setw(8) << "nodes" << G4endl;
+  for ( size_t i=0; i<volumes.size(); ++i ) {
+    G4LogicalVolume* lv = volumes[i];
+    G4long lvSteps = steps ? MoreSteps(*steps).Steps(lv) : 0;
+    G4cout << "    " << std::left << std::setw(20) << lv->GetName()
+           << std::right << std::setw(10) << lv->GetNoDaughters()
+           << std::setw(12) << lvSteps << std::setw(8) << std::setprecision(3)
+           << ( totalSteps ? 100.*lvSteps/totalSteps : 0. )
+           << std::setw(10) << lv->GetSmartless()
+           << std::setw(5) << ( lv->IsToOptimise() ? "yes" : "no" );
+    const G4SmartVoxelHeader* header = lv->GetVoxelHeader();
+    if ( header ) {
+      std::set<const void*> headers, nodes;
+      CountVoxels(header, headers, nodes);
+      G4cout << std::setw(6) << AxisName(header->GetAxis())
+             << std::setw(8) << header->GetNoSlices()
+             << std::setw(9) << headers.size() << std::setw(8) << nodes.size();
+    }
+    else {
+      G4cout << std::setw(6) << "-" << std::setw(8) << "-"
+             << std::setw(9) << "-" << std::setw(8) << "-";
+    }
+    G4cout << G4endl;
+  }
+  G4cout << std::setprecision(6);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4LogicalVolume*>
+EEShashNavigationBenchmark::FindVolumes(const G4String& volume) const
+{
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  std::vector<G4LogicalVolume*> volumes;
+  for ( size_t i=0; i<lvStore->size(); ++i ) {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    if ( volume == "all" || lv->GetName() == volume ) volumes.push_back(lv);
+  }
+  if ( volumes.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "No logical volume " << volume << ".";
+    G4Exception("EEShashNavigationBenchmark::FindVolumes()",
+      "MyCode0014", JustWarning, msg);
+  }
+  return volumes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::Reoptimise() const
+{
+  // the voxels are built again now, and kept at the next run
+  G4GeometryManager* geometryManager = G4GeometryManager::GetInstance();
+  if ( ! geometryManager->IsGeometryClosed() ) return;
+  geometryManager->OpenGeometry();
+  geometryManager->CloseGeometry(true, false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::SetSmartless(const G4String& volume,
+                                              G4double smartless)
+{
+  std::vector<G4LogicalVolume*> volumes = FindVolumes(volume);
+  for ( size_t i=0; i<volumes.size(); ++i ) volumes[i]->SetSmartless(smartless);
+  Reoptimise();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::SetOptimisation(const G4String& volume,
+                                                 G4bool optimise)
+{
+  std::vector<G4LogicalVolume*> volumes = FindVolumes(volume);
+  for ( size_t i=0; i<volumes.size(); ++i ) volumes[i]->SetOptimisation(optimise);
+  Reoptimise();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationBenchmark::SetVoxelLimit(G4int minDaughters)
+{
+  // replicated and parameterised daughters are voxelised in any case
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  for ( size_t i=0; i<lvStore->size(); ++i ) {
+    G4LogicalVolume* lv = (*lvStore)[i];
+    lv->SetOptimisation(G4int(lv->GetNoDaughters()) >= minDaughters);
+  }
+  Reoptimise();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
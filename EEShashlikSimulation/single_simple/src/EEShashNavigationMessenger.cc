@@ -0,0 +1,191 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashNavigationMessenger.cc
+/// \brief Implementation of the EEShashNavigationMessenger class
+
+#include "EEShashNavigationMessenger.hh"
+#include "EEShashNavigationBenchmark.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashNavigationMessenger::EEShashNavigationMessenger(
+                                      EEShashNavigationBenchmark* benchmark)
+ : G4UImessenger(),
+   fBenchmark(benchmark)
+{
+  fNavigationDir = new G4UIdirectory("/EEShash/navigation/");
+  fNavigationDir->SetGuidance("Navigation benchmark and voxel tuning.");
+
+  fScanCmd = new G4UIcmdWithAnInteger("/EEShash/navigation/scan", this);
+  fScanCmd->SetGuidance("Follow rays through the geometry and report the");
+  fScanCmd->SetGuidance("time per step and the steps per logical volume.");
+  fScanCmd->SetParameterName("nRays", false);
+  fScanCmd->SetRange("nRays>0");
+  fScanCmd->AvailableForStates(G4State_Idle);
+  fScanCmd->SetToBeBroadcasted(false);
+
+  fPatternCmd = new G4UIcmdWithAString("/EEShash/navigation/pattern", this);
+  fPatternCmd->SetGuidance("Rays on a grid along the beam, or isotropic");
+  fPatternCmd->SetGuidance("from the origin.");
+  fPatternCmd->SetParameterName("pattern", false);
+  fPatternCmd->SetCandidates("beam isotropic");
+  fPatternCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPatternCmd->SetToBeBroadcasted(false);
+
+  fParticleCmd = new G4UIcmdWithAString("/EEShash/navigation/particle", this);
+  fParticleCmd->SetGuidance("Geantinos cross the boundaries, optical photons");
+  fParticleCmd->SetGuidance("are reflected back for a number of bounces.");
+  fParticleCmd->SetParameterName("particle", false);
+  fParticleCmd->SetCandidates("geantino opticalphoton");
+  fParticleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fParticleCmd->SetToBeBroadcasted(false);
+
+  fHalfWidthCmd = new G4UIcmdWithADoubleAndUnit("/EEShash/navigation/halfWidth", this);
+  fHalfWidthCmd->SetGuidance("Half width of the grid of the beam pattern.");
+  fHalfWidthCmd->SetParameterName("halfWidth", false);
+  fHalfWidthCmd->SetRange("halfWidth>=0.");
+  fHalfWidthCmd->SetUnitCategory("Length");
+  fHalfWidthCmd->SetDefaultUnit("mm");
+  fHalfWidthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fHalfWidthCmd->SetToBeBroadcasted(false);
+
+  fOriginCmd = new G4UIcmdWith3VectorAndUnit("/EEShash/navigation/origin", this);
+  fOriginCmd->SetGuidance("Origin of the isotropic pattern, e.g. in a tile.");
+  fOriginCmd->SetParameterName("x", "y", "z", false);
+  fOriginCmd->SetUnitCategory("Length");
+  fOriginCmd->SetDefaultUnit("mm");
+  fOriginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fOriginCmd->SetToBeBroadcasted(false);
+
+  fBouncesCmd = new G4UIcmdWithAnInteger("/EEShash/navigation/bounces", this);
+  fBouncesCmd->SetGuidance("Reflections of an optical photon before it is");
+  fBouncesCmd->SetGuidance("followed as a geantino.");
+  fBouncesCmd->SetParameterName("bounces", false);
+  fBouncesCmd->SetRange("bounces>=0");
+  fBouncesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBouncesCmd->SetToBeBroadcasted(false);
+
+  fSmartlessCmd = new G4UIcommand("/EEShash/navigation/smartless", this);
+  fSmartlessCmd->SetGuidance("Smartless (voxels per daughter) of a logical");
+  fSmartlessCmd->SetGuidance("volume, or of all of them; the geometry is");
+  fSmartlessCmd->SetGuidance("optimised again.");
+  G4UIparameter* volume = new G4UIparameter("volume", 's', false);
+  fSmartlessCmd->SetParameter(volume);
+  G4UIparameter* smartless = new G4UIparameter("smartless", 'd', false);
+  smartless->SetParameterRange("smartless>0.");
+  fSmartlessCmd->SetParameter(smartless);
+  fSmartlessCmd->AvailableForStates(G4State_Idle);
+  fSmartlessCmd->SetToBeBroadcasted(false);
+
+  fOptimiseCmd = new G4UIcommand("/EEShash/navigation/optimise", this);
+  fOptimiseCmd->SetGuidance("Voxelise a logical volume, or all of them, or not;");
+  fOptimiseCmd->SetGuidance("the geometry is optimised again.");
+  G4UIparameter* optimisedVolume = new G4UIparameter("volume", 's', false);
+  fOptimiseCmd->SetParameter(optimisedVolume);
+  G4UIparameter* optimise = new G4UIparameter("optimise", 'b', false);
+  fOptimiseCmd->SetParameter(optimise);
+  fOptimiseCmd->AvailableForStates(G4State_Idle);
+  fOptimiseCmd->SetToBeBroadcasted(false);
+
+  fVoxelLimitCmd = new G4UIcmdWithAnInteger("/EEShash/navigation/voxelLimit", this);
+  fVoxelLimitCmd->SetGuidance("Voxelise only the volumes with at least this");
+  fVoxelLimitCmd->SetGuidance("number of daughters; the geometry is optimised again.");
+  fVoxelLimitCmd->SetParameterName("minDaughters", false);
+  fVoxelLimitCmd->SetRange("minDaughters>=0");
+  fVoxelLimitCmd->AvailableForStates(G4State_Idle);
+  fVoxelLimitCmd->SetToBeBroadcasted(false);
+
+  fVoxelStatsCmd = new G4UIcmdWithoutParameter("/EEShash/navigation/voxelStats", this);
+  fVoxelStatsCmd->SetGuidance("Print the voxels of the logical volumes.");
+  fVoxelStatsCmd->AvailableForStates(G4State_Idle);
+  fVoxelStatsCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashNavigationMessenger::~EEShashNavigationMessenger()
+{
+  delete fScanCmd;
+  delete fPatternCmd;
+  delete fParticleCmd;
+  delete fHalfWidthCmd;
+  delete fOriginCmd;
+  delete fBouncesCmd;
+  delete fSmartlessCmd;
+  delete fOptimiseCmd;
+  delete fVoxelLimitCmd;
+  delete fVoxelStatsCmd;
+  delete fNavigationDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashNavigationMessenger::SetNewValue(G4UIcommand* command,
+                                             G4String newValue)
+{
+  if ( command == fScanCmd )
+    fBenchmark->Scan(fScanCmd->GetNewIntValue(newValue));
+  else if ( command == fPatternCmd )
+    fBenchmark->SetPattern(newValue == "isotropic" ? kIsotropicRays : kBeamRays);
+  else if ( command == fParticleCmd )
+    fBenchmark->SetOptical(newValue == "opticalphoton");
+  else if ( command == fHalfWidthCmd )
+    fBenchmark->SetHalfWidth(fHalfWidthCmd->GetNewDoubleValue(newValue));
+  else if ( command == fOriginCmd )
+    fBenchmark->SetOrigin(fOriginCmd->GetNew3VectorValue(newValue));
+  else if ( command == fBouncesCmd )
+    fBenchmark->SetMaxBounces(fBouncesCmd->GetNewIntValue(newValue));
+  else if ( command == fSmartlessCmd ) {
+    G4String volume;
+    G4double smartless;
+    std::istringstream is(newValue);
+    is >> volume >> smartless;
+    fBenchmark->SetSmartless(volume, smartless);
+  }
+  else if ( command == fOptimiseCmd ) {
+    G4String volume, optimise;
+    std::istringstream is(newValue);
+    is >> volume >> optimise;
+    fBenchmark->SetOptimisation(volume, G4UIcommand::ConvertToBool(optimise));
+  }
+  else if ( command == fVoxelLimitCmd )
+    fBenchmark->SetVoxelLimit(fVoxelLimitCmd->GetNewIntValue(newValue));
+  else if ( command == fVoxelStatsCmd )
+    fBenchmark->PrintVoxelStatistics();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,205 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalKillPolicy.cc
+/// \brief Implementation of the EEShashOpticalKillPolicy class
+
+#include "EEShashOpticalKillPolicy.hh"
+#include "TrackInformation.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4StepPoint.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <ctime>
+#include <iomanip>
+
+G4double EEShashOpticalKillPolicy::fTimeWindow = 0.;
+G4int    EEShashOpticalKillPolicy::fMaxSteps = 70000;
+G4int    EEShashOpticalKillPolicy::fMaxVertexSteps[kNofVolumeRoles] = { 0, 600, 0, 0, 0 };
+G4double EEShashOpticalKillPolicy::fMaxPathLength = 0.;
+G4int    EEShashOpticalKillPolicy::fMaxBounces[kNofVolumeRoles] = { 0, 0, 0, 0, 0 };
+G4bool   EEShashOpticalKillPolicy::fCalibration = false;
+G4bool   EEShashOpticalKillPolicy::fTiming = true;
+G4ThreadLocal EEShashOpticalKillPolicy::ThreadState* EEShashOpticalKillPolicy::fState = 0;
+EEShashOpticalKillPolicy::Counters EEShashOpticalKillPolicy::fMerged[kNofKillPolicies];
+
+namespace {
+  G4Mutex killPolicyMutex = G4MUTEX_INITIALIZER;
+
+  const char* policyNames[kNofKillPolicies] = {
+    "timeWindow", "maxSteps", "maxVertexSteps", "maxPathLength", "maxBounces" };
+  const char* roleNames[kNofVolumeRoles] = {
+    "other", "act", "fibre", "grease", "apd" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* EEShashOpticalKillPolicy::GetPolicyName(G4int policy)
+{
+  return policy >= 0 && policy < kNofKillPolicies ? policyNames[policy] : "none";
+}
+
+const char* EEShashOpticalKillPolicy::GetRoleName(G4int role)
+{
+  return role >= 0 && role < kNofVolumeRoles ? roleNames[role] : "unknown";
+}
+
+G4int EEShashOpticalKillPolicy::GetRole(const G4String& name)
+{
+  for ( G4int i = 0; i < kNofVolumeRoles; ++i )
+    if ( name == roleNames[i] ) return i;
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalKillPolicy::ThreadState& EEShashOpticalKillPolicy::GetState()
+{
+  if ( ! fState ) fState = new ThreadState;
+  return *fState;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashOpticalKillPolicy::CPUTime()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1.e-9*now.tv_nsec;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalKillPolicy::BeginOfTrack()
+{
+  ThreadState& state = GetState();
+  for ( G4int i = 0; i < kNofVolumeRoles; ++i ) state.fBounces[i] = 0;
+  if ( fTiming ) state.fStart = CPUTime();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalKillPolicy::Record(ThreadState& state, G4int policy,
+                                      const G4Track* track)
+{
+  TrackInformation* info
+    = static_cast<TrackInformation*>(track->GetUserInformation());
+  Counters& counters = state.fCounters[policy];
+  ++counters.fPhotons;
+  counters.fWeight += info ? info->GetParticleWeight() : 1.;
+  counters.fSteps += track->GetCurrentStepNumber();
+  // photons killed at birth have not cost any tracking yet
+  if ( fTiming && track->GetCurrentStepNumber() > 0 )
+    counters.fCPUBeforeKill += CPUTime() - state.fStart;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashOpticalKillPolicy::ApplyAtBirth(const G4Track* track)
+{
+  if ( fCalibration || fTimeWindow <= 0. ) return kNoKill;
+  if ( track->GetGlobalTime() <= fTimeWindow ) return kNoKill;
+
+  Record(GetState(), kKillTimeWindow, track);
+  return kKillTimeWindow;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashOpticalKillPolicy::Apply(const G4Step* step,
+                                      EEShashVolumeRole vertexRole,
+                                      EEShashVolumeRole preRole)
+{
+  const G4Track* track = step->GetTrack();
+  G4int nStep = track->GetCurrentStepNumber();
+  ThreadState& state = GetState();
+
+  G4int policy = kNoKill;
+  if ( fMaxSteps > 0 && nStep > fMaxSteps ) {
+    policy = kKillMaxSteps;
+  }
+  else if ( fCalibration ) {
+    return kNoKill;
+  }
+  // the arrival time at the readout is later than the time of the photon
+  else if ( fTimeWindow > 0. && track->GetGlobalTime() > fTimeWindow ) {
+    policy = kKillTimeWindow;
+  }
+  else if ( fMaxVertexSteps[vertexRole] > 0 && nStep > fMaxVertexSteps[vertexRole] ) {
+    policy = kKillVertexSteps;
+  }
+  else if ( fMaxPathLength > 0. && track->GetTrackLength() > fMaxPathLength ) {
+    policy = kKillPathLength;
+  }
+  else if ( fMaxBounces[preRole] > 0
+            && step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary
+            && ++state.fBounces[preRole] > fMaxBounces[preRole] ) {
+    policy = kKillBounces;
+  }
+
+  if ( policy != kNoKill ) Record(state, policy, track);
+  return policy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalKillPolicy::EndOfThreadRun()
+{
+  if ( ! fState ) return;
+
+  G4AutoLock lock(&killPolicyMutex);
+  for ( G4int i = 0; i < kNofKillPolicies; ++i ) {
+    const Counters& counters = fState->fCounters[i];
+    fMerged[i].fPhotons += counters.fPhotons;
+    fMerged[i].fWeight += counters.fWeight;
+    fMerged[i].fSteps += counters.fSteps;
+    fMerged[i].fCPUBeforeKill += counters.fCPUBeforeKill;
+    fState->fCounters[i] = Counters();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalKillPolicy::Print()
+{
+  G4AutoLock lock(&killPolicyMutex);
+  G4cout << ">>> Optical photons killed in the run";
+  if ( fCalibration ) G4cout << " (calibration, step limit only)";
+  G4cout << G4endl;
+  for ( G4int i = 0; i < kNofKillPolicies; ++i ) {
+    const Counters& counters = fMerged[i];
+    G4cout << "    " << std::left << std::setw(16) << policyNames[i] << std::right
+           << std::setw(12) << counters.fPhotons << " photons, weight "
+           << std::setw(12) << counters.fWeight << ", "
+           << std::setw(12) << counters.fSteps << " steps, "
+           << counters.fCPUBeforeKill << " s CPU before the kill" << G4endl;
+    fMerged[i] = Counters();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
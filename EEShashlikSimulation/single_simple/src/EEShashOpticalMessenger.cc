@@ -0,0 +1,147 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOpticalMessenger.cc
+/// \brief Implementation of the EEShashOpticalMessenger class
+
+#include "EEShashOpticalMessenger.hh"
+#include "G4EmUserPhysics.hh"
+#include "EEShashOpticalReadoutSD.hh"
+#include "EEShashStackingAction.hh"
+#include "CreateTree.h"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SDManager.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalMessenger::EEShashOpticalMessenger(G4EmUserPhysics* physics)
+ : G4UImessenger(),
+   fPhysics(physics)
+{
+  fOpticalDir = new G4UIdirectory("/EEShash/optical/");
+  fOpticalDir->SetGuidance("Optical photon options.");
+
+  fThinningCmd = new G4UIcmdWithADouble("/EEShash/optical/thinning", this);
+  fThinningCmd->SetGuidance("Thinning factor of the scintillation photons.");
+  fThinningCmd->SetGuidance("1/factor of the photons are generated, each with");
+  fThinningCmd->SetGuidance("a weight of factor; 1 means no thinning.");
+  fThinningCmd->SetParameterName("factor", false);
+  fThinningCmd->SetRange("factor>=1.");
+  fThinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fQEAtBirthCmd = new G4UIcmdWithABool("/EEShash/optical/qeAtBirth", this);
+  fQEAtBirthCmd->SetGuidance("Keep WLS photons at birth with the largest");
+  fQEAtBirthCmd->SetGuidance("photodetector QE, the rest of the QE being");
+  fQEAtBirthCmd->SetGuidance("played at the fibre end at the final energy.");
+  fQEAtBirthCmd->SetParameterName("qeAtBirth", true);
+  fQEAtBirthCmd->SetDefaultValue(true);
+  fQEAtBirthCmd->AvailableForStates(G4State_Idle);
+
+  fCerenkovWindowCmd = new G4UIcommand("/EEShash/optical/cerenkovWindow", this);
+  fCerenkovWindowCmd->SetGuidance("Wavelength range [nm] of the generated");
+  fCerenkovWindowCmd->SetGuidance("Cerenkov photons (photodetector window).");
+  G4UIparameter* lambdaMin = new G4UIparameter("lambdaMin", 'd', false);
+  lambdaMin->SetParameterRange("lambdaMin>0.");
+  fCerenkovWindowCmd->SetParameter(lambdaMin);
+  G4UIparameter* lambdaMax = new G4UIparameter("lambdaMax", 'd', false);
+  lambdaMax->SetParameterRange("lambdaMax>0.");
+  fCerenkovWindowCmd->SetParameter(lambdaMax);
+  fCerenkovWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhotonBudgetCmd = new G4UIcmdWithAnInteger("/EEShash/optical/photonBudget", this);
+  fPhotonBudgetCmd->SetGuidance("Target number of tracked optical photons per");
+  fPhotonBudgetCmd->SetGuidance("event; the others are sampled with weights.");
+  fPhotonBudgetCmd->SetGuidance("0 tracks every photon.");
+  fPhotonBudgetCmd->SetParameterName("budget", false);
+  fPhotonBudgetCmd->SetRange("budget>=0");
+  fPhotonBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTimeStepCmd = new G4UIcmdWithADoubleAndUnit("/EEShash/optical/timeStep", this);
+  fTimeStepCmd->SetGuidance("Time resolution of the stored photon arrival");
+  fTimeStepCmd->SetGuidance("times; 65535 steps cover the stored range.");
+  fTimeStepCmd->SetParameterName("step", false);
+  fTimeStepCmd->SetRange("step>0.");
+  fTimeStepCmd->SetDefaultUnit("ns");
+  fTimeStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalMessenger::~EEShashOpticalMessenger()
+{
+  delete fThinningCmd;
+  delete fQEAtBirthCmd;
+  delete fCerenkovWindowCmd;
+  delete fPhotonBudgetCmd;
+  delete fTimeStepCmd;
+  delete fOpticalDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOpticalMessenger::SetNewValue(G4UIcommand* command,
+                                          G4String newValue)
+{
+  if ( command == fThinningCmd ) {
+    fPhysics->SetThinningFactor(fThinningCmd->GetNewDoubleValue(newValue));
+  }
+
+  if ( command == fQEAtBirthCmd ) {
+    EEShashOpticalReadoutSD* readout = static_cast<EEShashOpticalReadoutSD*>(
+      G4SDManager::GetSDMpointer()->FindSensitiveDetector("OpticalSD"));
+    if ( readout )
+      readout->SetQEAtBirth(fQEAtBirthCmd->GetNewBoolValue(newValue));
+  }
+
+  if ( command == fCerenkovWindowCmd ) {
+    G4double lambdaMin, lambdaMax;
+    std::istringstream is(newValue);
+    is >> lambdaMin >> lambdaMax;
+    fPhysics->SetCerenkovWindow(lambdaMin, lambdaMax);
+  }
+
+  // shared by the threads, set by the master only
+  if ( command == fPhotonBudgetCmd && G4Threading::IsMasterThread() ) {
+    EEShashStackingAction::SetPhotonBudget(
+      fPhotonBudgetCmd->GetNewIntValue(newValue));
+  }
+
+  if ( command == fTimeStepCmd && G4Threading::IsMasterThread() ) {
+    CreateTree::SetTimeStep(fTimeStepCmd->GetNewDoubleValue(newValue)/ns);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
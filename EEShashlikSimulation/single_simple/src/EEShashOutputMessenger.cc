@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashOutputMessenger.cc
+/// \brief Implementation of the EEShashOutputMessenger class
+
+#include "EEShashOutputMessenger.hh"
+#include "EEShashTreeWriter.hh"
+#include "CreateTree.h"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4Threading.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOutputMessenger::EEShashOutputMessenger()
+ : G4UImessenger()
+{
+  fOutputDir = new G4UIdirectory("/EEShash/output/");
+  fOutputDir->SetGuidance("Output tree options.");
+
+  fCompressionCmd = new G4UIcommand("/EEShash/output/compression", this);
+  fCompressionCmd->SetGuidance("Compression algorithm and level of a branch,");
+  fCompressionCmd->SetGuidance("or of all of them (*).");
+  G4UIparameter* algorithm = new G4UIparameter("algorithm", 's', false);
+  algorithm->SetParameterCandidates("zlib lzma lz4 zstd");
+  fCompressionCmd->SetParameter(algorithm);
+  G4UIparameter* level = new G4UIparameter("level", 'i', false);
+  level->SetParameterRange("level>=0 && level<=9");
+  fCompressionCmd->SetParameter(level);
+  G4UIparameter* branch = new G4UIparameter("branch", 's', true);
+  branch->SetDefaultValue("*");
+  fCompressionCmd->SetParameter(branch);
+  fCompressionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCompressionCmd->SetToBeBroadcasted(false);
+
+  fBasketSizeCmd = new G4UIcmdWithAnInteger("/EEShash/output/basketSize", this);
+  fBasketSizeCmd->SetGuidance("Basket size [bytes] of all the branches;");
+  fBasketSizeCmd->SetGuidance("0 keeps the ROOT default.");
+  fBasketSizeCmd->SetParameterName("size", false);
+  fBasketSizeCmd->SetRange("size>=0");
+  fBasketSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBasketSizeCmd->SetToBeBroadcasted(false);
+
+  fAutoFlushCmd = new G4UIcmdWithAnInteger("/EEShash/output/autoFlush", this);
+  fAutoFlushCmd->SetGuidance("AutoFlush of the tree: every n entries if");
+  fAutoFlushCmd->SetGuidance("positive, every -n bytes if negative;");
+  fAutoFlushCmd->SetGuidance("0 keeps the ROOT default.");
+  fAutoFlushCmd->SetParameterName("n", false);
+  fAutoFlushCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAutoFlushCmd->SetToBeBroadcasted(false);
+
+  fWriterDepthCmd = new G4UIcmdWithAnInteger("/EEShash/output/writerDepth", this);
+  fWriterDepthCmd->SetGuidance("Events that can wait for the background writer");
+  fWriterDepthCmd->SetGuidance("(sequential mode); 0 writes on the simulation");
+  fWriterDepthCmd->SetGuidance("thread.");
+  fWriterDepthCmd->SetParameterName("depth", false);
+  fWriterDepthCmd->SetRange("depth>=0");
+  fWriterDepthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWriterDepthCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOutputMessenger::~EEShashOutputMessenger()
+{
+  delete fCompressionCmd;
+  delete fBasketSizeCmd;
+  delete fAutoFlushCmd;
+  delete fWriterDepthCmd;
+  delete fOutputDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashOutputMessenger::SetNewValue(G4UIcommand* command,
+                                         G4String newValue)
+{
+  if ( ! G4Threading::IsMasterThread() ) return;
+
+  if ( command == fCompressionCmd ) {
+    G4String algorithm, branch;
+    G4int level;
+    std::istringstream is(newValue);
+    is >> algorithm >> level >> branch;
+    // ROOT's algorithm numbers
+    G4int code = 1;
+    if ( algorithm == "lzma" ) code = 2;
+    if ( algorithm == "lz4" )  code = 4;
+    if ( algorithm == "zstd" ) code = 5;
+    CreateTree::SetCompression(100*code + level, branch);
+  }
+
+  if ( command == fBasketSizeCmd ) {
+    CreateTree::SetBasketSize(fBasketSizeCmd->GetNewIntValue(newValue));
+  }
+
+  if ( command == fAutoFlushCmd ) {
+    CreateTree::SetAutoFlush(fAutoFlushCmd->GetNewIntValue(newValue));
+  }
+
+  if ( command == fWriterDepthCmd ) {
+    EEShashTreeWriter::SetDepth(fWriterDepthCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,8 +28,10 @@
 /// \file EEShashPrimaryGeneratorAction.cc
 /// \brief Implementation of the EEShashPrimaryGeneratorAction class
 
-#include "common.h"
 #include "EEShashPrimaryGeneratorAction.hh"
+#include "EEShashEventContext.hh"
+#include "EEShashShowerLibrary.hh"
+#include "EEShashShowerSource.hh"
 
 #include "G4RunManager.hh"
 #include "G4LogicalVolumeStore.hh"
@@ -43,30 +45,12 @@
 #include "Randomize.hh"
 
 
-G4double xBeamPos;
-G4double yBeamPos;
-G4int NPhotAct;
-G4int NPhotFib;
-G4int NPhotFib2;
-G4int NPhotFib3;
-G4int NPhotFib4;
-G4int fibreStart0;
-G4int fibre0;
-G4int fibre1;
-G4int fibre2;
-G4int fibre3;
-G4double EOpt_0;
-G4double EOpt_1;
-G4double EOpt_2;
-G4double EOpt_3;
-
-
-
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EEShashPrimaryGeneratorAction::EEShashPrimaryGeneratorAction()
  : G4VUserPrimaryGeneratorAction(),
-   fParticleGun(0)
+   fParticleGun(0),
+   fShowerSource(0)
 {
   G4int nofParticles = 1;
   fParticleGun = new G4ParticleGun(nofParticles);
@@ -80,14 +64,8 @@ EEShashPrimaryGeneratorAction::EEShashPrimaryGeneratorAction()
   fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0.,0.,1.));
   fParticleGun->SetParticleEnergy(100. *GeV);
 
-
-
-  G4Random::setTheEngine(new CLHEP::RanecuEngine);
- 
-  G4int myseed = time( NULL );
-  rand_ = new TRandom3(myseed);
-  G4Random::setTheSeed(myseed); //to have random events decomment
-
+  // the engine is seeded once in main(); in MT mode the workers get
+  // their seeds from the master
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -95,6 +73,7 @@ EEShashPrimaryGeneratorAction::EEShashPrimaryGeneratorAction()
 EEShashPrimaryGeneratorAction::~EEShashPrimaryGeneratorAction()
 {
   delete fParticleGun;
+  delete fShowerSource;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -126,10 +105,10 @@ void EEShashPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 
   // smear gun 
-  float x = rand_->Gaus( 0., 10 );
-  float y = rand_->Gaus( 0., 10 );
-  //float x = rand_->Uniform( 0., 30.0 );
-  //float y = rand_->Uniform( 0., 30.0 );
+  float x = G4RandGauss::shoot( 0., 10 );
+  float y = G4RandGauss::shoot( 0., 10 );
+  //float x = G4UniformRand()*30.0;
+  //float y = G4UniformRand()*30.0;
 
   // Unsmeared beam position (position center):
   //x = -18.5;
@@ -194,21 +173,7 @@ void EEShashPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 
   G4cout<<"xBeam:"<<xBeam<<" yBeam:"<<yBeam<<G4endl;
-  NPhotAct=0;
-  NPhotFib=0;
-  NPhotFib2=0;
-  NPhotFib3=0;
-  NPhotFib4=0;
-  fibreStart0=0;
-  fibre0=0;
-  fibre1=0;
-  fibre2=0;
-  fibre3=0;
-  EOpt_0=0;
-  EOpt_1=0;
-  EOpt_2=0;
-  EOpt_3=0;
-  for(int i=0;i<nPhotonsForTiming;++i)  time_vector.push_back(-1);
+  EEShashEventContext::Instance()->Reset();
 
   // Set gun position
   fParticleGun->SetParticlePosition(G4ThreeVector(xBeam, yBeam, -1.587*m));
@@ -226,10 +191,33 @@ void EEShashPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 
 
-  fParticleGun->GeneratePrimaryVertex(anEvent);
+  // with a shower library, the optical photons of a stored shower of the
+  // gun particle take the place of the particle
+  EEShashShowerLibrary* showerLibrary = EEShashShowerLibrary::Instance();
+  if ( showerLibrary && showerLibrary->IsReplaying() ) {
+    G4int pdg = fParticleGun->GetParticleDefinition()->GetPDGEncoding();
+    G4double energy = fParticleGun->GetParticleEnergy();
+    G4int bin = showerLibrary->FindBin(pdg, energy, xBeam, yBeam);
+    if ( bin < 0 ) {
+      G4ExceptionDescription msg;
+      msg << "No shower of " << fParticleGun->GetParticleDefinition()->GetParticleName()
+          << " at " << energy/GeV << " GeV within one impact bin of ("
+          << xBeam/mm << ", " << yBeam/mm << ") mm in the shower library";
+      G4Exception("EEShashPrimaryGeneratorAction::GeneratePrimaries()",
+        "MyCode0015", FatalException, msg);
+      return;
+    }
+    const EEShashShowerEntry* shower = showerLibrary->SampleShower(bin);
+    if ( ! fShowerSource ) fShowerSource = new EEShashShowerSource;
+    fShowerSource->GeneratePhotons(anEvent, *shower,
+                                   showerLibrary->GetDeposits(*shower),
+                                   G4ThreeVector(xBeam - shower->impactX*mm,
+                                                 yBeam - shower->impactY*mm, 0.));
+  }
+  else
+    fParticleGun->GeneratePrimaryVertex(anEvent);
 
-  xBeamPos = xBeam;
-  yBeamPos = yBeam;
+  EEShashEventContext::Instance()->SetBeamPosition(xBeam, yBeam);
 }
 
 
@@ -0,0 +1,260 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashProfiler.cc
+/// \brief Implementation of the EEShashProfiler class
+
+#include "EEShashProfiler.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+G4String EEShashProfiler::fReportFile = "";
+G4int EEShashProfiler::fSampling = 64;
+G4ThreadLocal EEShashProfiler::ThreadTable* EEShashProfiler::fTable = 0;
+std::map<std::string,EEShashProfiler::Counters> EEShashProfiler::fMerged;
+
+namespace {
+  G4Mutex profilerMutex = G4MUTEX_INITIALIZER;
+
+  // fields of a merged key, separated by tabs
+  std::vector<std::string> SplitKey(const std::string& key)
+  {
+    std::vector<std::string> fields;
+    size_t begin = 0;
+    for ( size_t end; (end = key.find('\t', begin)) != std::string::npos; begin = end+1 )
+      fields.push_back(key.substr(begin, end-begin));
+    fields.push_back(key.substr(begin));
+    return fields;
+  }
+
+  typedef std::pair<std::string,G4double> Entry;
+  bool MoreCPU(const Entry& a, const Entry& b) { return a.second > b.second; }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool EEShashProfiler::Key::operator<(const Key& other) const
+{
+  if ( fVolume != other.fVolume ) return fVolume < other.fVolume;
+  if ( fParticle != other.fParticle ) return fParticle < other.fParticle;
+  return fCreator < other.fCreator;
+}
+
+bool EEShashProfiler::Key::operator==(const Key& other) const
+{
+  return fVolume == other.fVolume && fParticle == other.fParticle
+      && fCreator == other.fCreator;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfiler::SetReportFile(const G4String& fileName, G4int sampling)
+{
+  fReportFile = fileName;
+  fSampling = sampling > 0 ? sampling : 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashProfiler::ThreadTable& EEShashProfiler::GetTable()
+{
+  if ( ! fTable ) fTable = new ThreadTable;
+  return *fTable;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashProfiler::Counters& EEShashProfiler::Find(ThreadTable& table,
+                                                 const Key& key)
+{
+  if ( ! table.fLast || ! (key == table.fLastKey) ) {
+    table.fLastKey = key;
+    table.fLast = &table.fCounters[key];
+  }
+  return *table.fLast;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashProfiler::CPUTime()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1.e-9*now.tv_nsec;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfiler::RecordStep(const G4Step* step)
+{
+  ThreadTable& table = GetTable();
+  const G4Track* track = step->GetTrack();
+  G4VPhysicalVolume* volume = step->GetPreStepPoint()->GetPhysicalVolume();
+  Counters& counters = Find(table, Key(volume ? volume->GetLogicalVolume() : 0,
+                                       track->GetDefinition(),
+                                       track->GetCreatorProcess()));
+  ++counters.fSteps;
+
+  if ( table.fStart >= 0. ) {
+    counters.fCPUTime += CPUTime() - table.fStart;
+    ++counters.fSamples;
+    table.fStart = -1.;
+  }
+  // the next step of this track is timed
+  if ( ++table.fCounter % fSampling == 0 ) table.fStart = CPUTime();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfiler::RecordTrack(const G4Track* track)
+{
+  ThreadTable& table = GetTable();
+  G4VPhysicalVolume* volume = track->GetVolume();
+  ++Find(table, Key(volume ? volume->GetLogicalVolume() : 0,
+                    track->GetDefinition(),
+                    track->GetCreatorProcess())).fTracks;
+
+  // a measurement started on the last step of the previous track moves to
+  // the first step of this one, so that first steps are sampled as well;
+  // the time in between belongs to the stacking and tracking
+  if ( table.fStart >= 0. ) table.fStart = CPUTime();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfiler::EndOfThreadRun()
+{
+  if ( ! fTable ) return;
+
+  G4AutoLock lock(&profilerMutex);
+  std::map<Key,Counters>::const_iterator it = fTable->fCounters.begin();
+  for ( ; it != fTable->fCounters.end(); ++it ) {
+    const Key& key = it->first;
+    std::string name = key.fVolume ? key.fVolume->GetName() : "OutOfWorld";
+    name += '\t';
+    name += key.fParticle->GetParticleName();
+    name += '\t';
+    name += key.fCreator ? key.fCreator->GetProcessName() : "primary";
+
+    Counters& merged = fMerged[name];
+    merged.fTracks += it->second.fTracks;
+    merged.fSteps += it->second.fSteps;
+    merged.fSamples += it->second.fSamples;
+    // a key without any sampled step counts as no time at all
+    if ( it->second.fSamples > 0 )
+      merged.fCPUTime += it->second.fCPUTime
+                       *G4double(it->second.fSteps)/it->second.fSamples;
+  }
+
+  delete fTable;
+  fTable = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfiler::WriteReport()
+{
+  if ( ! IsEnabled() ) return;
+
+  G4AutoLock lock(&profilerMutex);
+  G4double totalCPU = 0.;
+  G4long totalSteps = 0;
+  std::vector<Entry> entries;
+  std::map<std::string,Counters>::const_iterator it = fMerged.begin();
+  for ( ; it != fMerged.end(); ++it ) {
+    totalCPU += it->second.fCPUTime;
+    totalSteps += it->second.fSteps;
+    entries.push_back(Entry(it->first, it->second.fCPUTime));
+  }
+  std::stable_sort(entries.begin(), entries.end(), MoreCPU);
+
+  G4bool json = fReportFile.size() > 5
+             && fReportFile.substr(fReportFile.size()-5) == ".json";
+  std::ofstream report(fReportFile.c_str());
+  report.precision(6);
+  if ( json ) {
+    report << "{\n  \"sampling\": " << fSampling
+           << ",\n  \"steps\": " << totalSteps
+           << ",\n  \"cpu_s\": " << totalCPU
+           << ",\n  \"entries\": [";
+  }
+  else {
+    report << "volume,particle,creator,tracks,steps,sampled_steps,cpu_s,cpu_fraction\n";
+  }
+  for ( size_t i=0; i<entries.size(); ++i ) {
+    const Counters& counters = fMerged[entries[i].first];
+    std::vector<std::string> fields = SplitKey(entries[i].first);
+    G4double fraction = totalCPU > 0. ? counters.fCPUTime/totalCPU : 0.;
+    if ( json ) {
+      report << ( i ? "," : "" ) << "\n    {\"volume\": \"" << fields[0]
+             << "\", \"particle\": \"" << fields[1]
+             << "\", \"creator\": \"" << fields[2]
+             << "\", \"tracks\": " << counters.fTracks
+             << ", \"steps\": " << counters.fSteps
+             << ", \"sampled_steps\": " << counters.fSamples
+             << ", \"cpu_s\": " << counters.fCPUTime
+             << ", \"cpu_fraction\": " << fraction << "}";
+    }
+    else {
+      report << fields[0] << "," << fields[1] << "," << fields[2] << ","
+             << counters.fTracks << "," << counters.fSteps << ","
+             << counters.fSamples << "," << counters.fCPUTime << ","
+             << fraction << "\n";
+    }
+  }
+  if ( json ) report << "\n  ]\n}\n";
+  report.close();
+
+  G4cout << ">>> Profile of the run, " << totalSteps << " steps, "
+         << totalCPU << " s sampled CPU, written to " << fReportFile << G4endl;
+  for ( size_t i=0; i<entries.size() && i<10; ++i ) {
+    const Counters& counters = fMerged[entries[i].first];
+    std::vector<std::string> fields = SplitKey(entries[i].first);
+    G4cout << "    " << std::setw(6) << std::setprecision(3)
+           << ( totalCPU > 0. ? 100.*counters.fCPUTime/totalCPU : 0. ) << " %  "
+           << std::left << std::setw(16) << fields[0] << std::setw(14) << fields[1]
+           << std::setw(16) << fields[2] << std::right
+           << std::setw(12) << counters.fSteps << " steps" << G4endl;
+  }
+  G4cout << std::setprecision(6);
+
+  // the next run starts from zero
+  fMerged.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashProfilingTrackingAction.cc
+/// \brief Implementation of the EEShashProfilingTrackingAction class
+
+#include "EEShashProfilingTrackingAction.hh"
+#include "EEShashProfiler.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashProfilingTrackingAction::EEShashProfilingTrackingAction(
+                                             G4UserTrackingAction* action)
+ : G4UserTrackingAction(),
+   fAction(action)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashProfilingTrackingAction::~EEShashProfilingTrackingAction()
+{
+  delete fAction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfilingTrackingAction::PreUserTrackingAction(const G4Track* track)
+{
+  EEShashProfiler::RecordTrack(track);
+  fAction->PreUserTrackingAction(track);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfilingTrackingAction::PostUserTrackingAction(const G4Track* track)
+{
+  fAction->PostUserTrackingAction(track);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashProfilingTrackingAction::SetTrackingManagerPointer(
+                                             G4TrackingManager* manager)
+{
+  G4UserTrackingAction::SetTrackingManagerPointer(manager);
+  fAction->SetTrackingManagerPointer(manager);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
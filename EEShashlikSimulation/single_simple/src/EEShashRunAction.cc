@@ -34,6 +34,13 @@
 
 #include "EEShashRunAction.hh"
 #include "EEShashAnalysis.hh"
+#include "CreateTree.h"
+#include "EEShashTreeMerger.hh"
+#include "EEShashTreeWriter.hh"
+#include "EEShashProfiler.hh"
+#include "EEShashRunTelemetry.hh"
+#include "EEShashOpticalKillPolicy.hh"
+#include "EEShashVolumeRoleTable.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
@@ -49,8 +56,6 @@
 // #define nBGOs 24
 // #define nFibers 4
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-
 EEShashRunAction::EEShashRunAction( )
  : G4UserRunAction()
 { 
@@ -163,10 +168,17 @@ EEShashRunAction::~EEShashRunAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EEShashRunAction::BeginOfRunAction(const G4Run* /*run*/)
+void EEShashRunAction::BeginOfRunAction(const G4Run* run)
 { 
   //inform the runManager to save random number seed
   //G4RunManager::GetRunManager()->SetRandomNumberStore(true);
+
+  // workers fill a tree of their own, the sequential one is made in main()
+  if ( ! isMaster ) EEShashTreeMerger::BeginOfWorkerRun();
+  else if ( EEShashTreeWriter::Instance() ) EEShashTreeWriter::Instance()->BeginOfRun();
+
+  // the master starts before the workers
+  if ( isMaster ) EEShashRunTelemetry::BeginOfRun(run->GetRunID());
   
   // Get analysis manager
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
@@ -191,7 +203,7 @@ void EEShashRunAction::BeginOfRunAction(const G4Run* /*run*/)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EEShashRunAction::EndOfRunAction(const G4Run* /*run*/)
+void EEShashRunAction::EndOfRunAction(const G4Run* run)
 {
   // print histogram statistics
   //
@@ -231,6 +243,20 @@ void EEShashRunAction::EndOfRunAction(const G4Run* /*run*/)
   analysisManager->Write();
   analysisManager->CloseFile();
 
+  if ( ! isMaster ) EEShashTreeMerger::EndOfWorkerRun();
+  else if ( EEShashTreeMerger::Instance() ) EEShashTreeMerger::Instance()->Flush();
+  else if ( EEShashTreeWriter::Instance() ) EEShashTreeWriter::Instance()->EndOfRun();
+
+  // the workers end their run before the master
+  EEShashProfiler::EndOfThreadRun();
+  if ( isMaster ) EEShashProfiler::WriteReport();
+  EEShashRunTelemetry::EndOfThreadRun();
+  if ( isMaster ) EEShashRunTelemetry::WriteReport(run);
+  EEShashOpticalKillPolicy::EndOfThreadRun();
+  if ( isMaster ) EEShashOpticalKillPolicy::Print();
+  EEShashVolumeRoleTable::EndOfThreadRun();
+  if ( isMaster ) EEShashVolumeRoleTable::Print();
+
   //hitsFile_->cd();
   //hitsTree_->Write();
   //hitsFile_->Close();
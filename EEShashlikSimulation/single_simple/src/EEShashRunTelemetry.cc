@@ -0,0 +1,285 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashRunTelemetry.cc
+/// \brief Implementation of the EEShashRunTelemetry class
+
+#include "EEShashRunTelemetry.hh"
+#include "EEShashCalorHit.hh"
+#include "EEShashOpticalHit.hh"
+#include "TrackInformation.hh"
+
+#include "G4Event.hh"
+#include "G4Run.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4TouchableHistory.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <ctime>
+#include <algorithm>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+G4String EEShashRunTelemetry::fStem = "";
+G4double EEShashRunTelemetry::fInterval = 0.;
+std::vector<G4String> EEShashRunTelemetry::fOutputFiles;
+G4ThreadLocal EEShashRunTelemetry::Counters* EEShashRunTelemetry::fCounters = 0;
+G4double EEShashRunTelemetry::fRunStart = 0.;
+G4double EEShashRunTelemetry::fNextSample = 0.;
+G4long   EEShashRunTelemetry::fStartBytes = 0;
+G4long   EEShashRunTelemetry::fEvents = 0;
+G4long   EEShashRunTelemetry::fPrimaries = 0;
+G4long   EEShashRunTelemetry::fCreated = 0;
+G4long   EEShashRunTelemetry::fTracked = 0;
+G4double EEShashRunTelemetry::fDetected = 0.;
+G4int    EEShashRunTelemetry::fThreads = 0;
+std::vector<G4float> EEShashRunTelemetry::fEventTimes;
+std::map<std::string,G4double> EEShashRunTelemetry::fPools;
+std::ofstream* EEShashRunTelemetry::fSamples = 0;
+
+namespace {
+  G4Mutex telemetryMutex = G4MUTEX_INITIALIZER;
+
+  // value below which a fraction of the sorted times lies
+  G4double Quantile(const std::vector<G4float>& sorted, G4double fraction)
+  {
+    if ( sorted.empty() ) return 0.;
+    size_t i = static_cast<size_t>(fraction*(sorted.size()-1) + 0.5);
+    return sorted[i];
+  }
+
+  template <class T>
+  void AddPool(std::map<std::string,G4double>& pools, const char* name,
+               G4Allocator<T>* allocator)
+  {
+    if ( allocator ) pools[name] += allocator->GetAllocatedSize();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::SetOutput(const G4String& outputFile,
+                                    G4double interval)
+{
+  fStem = outputFile;
+  if ( fStem.size() > 5 && fStem.substr(fStem.size()-5) == ".root" )
+    fStem = fStem.substr(0, fStem.size()-5);
+  fInterval = interval;
+  fOutputFiles.push_back(outputFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::AddOutputFile(const G4String& fileName)
+{
+  fOutputFiles.push_back(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashRunTelemetry::Counters& EEShashRunTelemetry::GetCounters()
+{
+  if ( ! fCounters ) fCounters = new Counters;
+  return *fCounters;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashRunTelemetry::WallTime()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + 1.e-9*now.tv_nsec;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashRunTelemetry::PeakRSS()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss/1024.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long EEShashRunTelemetry::OutputBytes()
+{
+  G4long bytes = 0;
+  for ( size_t i=0; i<fOutputFiles.size(); ++i ) {
+    struct stat info;
+    if ( stat(fOutputFiles[i].c_str(), &info) == 0 ) bytes += info.st_size;
+  }
+  return bytes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::BeginOfRun(G4int runID)
+{
+  if ( ! IsEnabled() ) return;
+
+  G4AutoLock lock(&telemetryMutex);
+  fRunStart = WallTime();
+  fNextSample = fRunStart + fInterval;
+  fStartBytes = OutputBytes();
+  fEvents = fPrimaries = fCreated = fTracked = 0;
+  fDetected = 0.;
+  fThreads = 0;
+  fEventTimes.clear();
+  fPools.clear();
+
+  if ( fInterval > 0. ) {
+    std::ostringstream name;
+    name << fStem << ".run" << runID << ".samples.jsonl";
+    fSamples = new std::ofstream(name.str().c_str());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::BeginOfEvent()
+{
+  if ( ! IsEnabled() ) return;
+
+  Counters& counters = GetCounters();
+  counters.fStart = WallTime();
+  counters.fCreated = counters.fTracked = 0;
+  counters.fDetected = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::EndOfEvent(const G4Event* event)
+{
+  if ( ! IsEnabled() ) return;
+
+  Counters& counters = GetCounters();
+  G4double now = WallTime();
+  G4int primaries = 0;
+  for ( G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i )
+    primaries += event->GetPrimaryVertex(i)->GetNumberOfParticle();
+
+  G4AutoLock lock(&telemetryMutex);
+  ++fEvents;
+  fPrimaries += primaries;
+  fCreated += counters.fCreated;
+  fTracked += counters.fTracked;
+  fDetected += counters.fDetected;
+  fEventTimes.push_back(now - counters.fStart);
+
+  if ( fSamples && now >= fNextSample ) {
+    WriteSample(now);
+    fNextSample = now + fInterval;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::WriteSample(G4double now)
+{
+  G4double elapsed = now - fRunStart;
+  *fSamples << "{\"wall_s\": " << elapsed
+            << ", \"events\": " << fEvents
+            << ", \"events_per_s\": " << ( elapsed > 0. ? fEvents/elapsed : 0. )
+            << ", \"photons_created\": " << fCreated
+            << ", \"photons_tracked\": " << fTracked
+            << ", \"photons_detected\": " << fDetected
+            << ", \"peak_rss_mb\": " << PeakRSS()
+            << ", \"output_bytes\": " << OutputBytes() - fStartBytes
+            << "}" << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::EndOfThreadRun()
+{
+  if ( ! IsEnabled() ) return;
+
+  G4AutoLock lock(&telemetryMutex);
+  if ( fCounters ) ++fThreads;
+  AddPool(fPools, "G4Track", aTrackAllocator());
+  AddPool(fPools, "G4DynamicParticle", pDynamicParticleAllocator());
+  AddPool(fPools, "G4TouchableHistory", aTouchableHistoryAllocator());
+  AddPool(fPools, "TrackInformation", aTrackInformationAllocator);
+  AddPool(fPools, "EEShashCalorHit", EEShashCalorHitAllocator);
+  AddPool(fPools, "EEShashOpticalHit", EEShashOpticalHitAllocator);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashRunTelemetry::WriteReport(const G4Run* run)
+{
+  if ( ! IsEnabled() ) return;
+
+  G4AutoLock lock(&telemetryMutex);
+  G4double elapsed = WallTime() - fRunStart;
+  G4double rate = elapsed > 0. ? 1./elapsed : 0.;
+  std::vector<G4float> times(fEventTimes);
+  std::sort(times.begin(), times.end());
+
+  std::ostringstream name;
+  name << fStem << ".run" << run->GetRunID() << ".telemetry.json";
+  std::ofstream report(name.str().c_str());
+  report.precision(6);
+  report << "{\n  \"run\": " << run->GetRunID()
+         << ",\n  \"threads\": " << fThreads
+         << ",\n  \"wall_s\": " << elapsed
+         << ",\n  \"events\": " << fEvents
+         << ",\n  \"events_per_s\": " << fEvents*rate
+         << ",\n  \"primaries_per_s\": " << fPrimaries*rate
+         << ",\n  \"photons_created_per_s\": " << fCreated*rate
+         << ",\n  \"photons_tracked_per_s\": " << fTracked*rate
+         << ",\n  \"photons_detected_per_s\": " << fDetected*rate
+         << ",\n  \"event_wall_s\": {\"p50\": " << Quantile(times, 0.5)
+         << ", \"p95\": " << Quantile(times, 0.95)
+         << ", \"max\": " << ( times.empty() ? 0. : times.back() ) << "}"
+         << ",\n  \"peak_rss_mb\": " << PeakRSS()
+         << ",\n  \"allocator_bytes\": {";
+  std::map<std::string,G4double>::const_iterator it = fPools.begin();
+  for ( ; it != fPools.end(); ++it )
+    report << ( it != fPools.begin() ? ", " : "" )
+           << "\"" << it->first << "\": " << static_cast<G4long>(it->second);
+  report << "},\n  \"output_bytes\": " << OutputBytes() - fStartBytes
+         << "\n}\n";
+  report.close();
+
+  if ( fSamples ) {
+    WriteSample(WallTime());
+    delete fSamples;
+    fSamples = 0;
+  }
+
+  G4cout << ">>> Telemetry of run " << run->GetRunID() << ": " << fEvents
+         << " events in " << elapsed << " s (" << fEvents*rate << " /s), "
+         << fTracked*rate << " photons tracked /s, event p95 "
+         << Quantile(times, 0.95) << " s, max RSS " << PeakRSS()
+         << " MB, written to " << name.str() << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,367 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashShowerLibrary.cc
+/// \brief Implementation of the EEShashShowerLibrary class
+
+#include "EEShashShowerLibrary.hh"
+
+#include "G4Step.hh"
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4LossTableManager.hh"
+#include "G4EmSaturation.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+EEShashShowerLibrary* EEShashShowerLibrary::fInstance = 0;
+G4ThreadLocal EEShashShowerLibrary::Buffer* EEShashShowerLibrary::fBuffer = 0;
+
+namespace {
+  G4Mutex showerLibraryMutex = G4MUTEX_INITIALIZER;
+
+  G4int ImpactBin(G4double position, G4double impactStep)
+  {
+    return G4int(std::floor(position/impactStep));
+  }
+
+  // showers of the same particle, energy and impact bin end up together
+  struct ShowerBinOrder
+  {
+    explicit ShowerBinOrder(G4double impactStep) : fImpactStep(impactStep) {}
+
+    bool operator()(const EEShashShowerEntry& a,
+                    const EEShashShowerEntry& b) const
+    {
+      if ( a.pdg != b.pdg ) return a.pdg < b.pdg;
+      if ( a.energy != b.energy ) return a.energy < b.energy;
+      G4int ax = ImpactBin(a.impactX*mm, fImpactStep);
+      G4int bx = ImpactBin(b.impactX*mm, fImpactStep);
+      if ( ax != bx ) return ax < bx;
+      return ImpactBin(a.impactY*mm, fImpactStep)
+           < ImpactBin(b.impactY*mm, fImpactStep);
+    }
+
+    G4double fImpactStep;
+  };
+
+  // the same order on the bins of the index, for the lookup of FindBin()
+  struct BinOrder
+  {
+    bool operator()(const EEShashShowerBin& a,
+                    const EEShashShowerBin& b) const
+    {
+      if ( a.pdg != b.pdg ) return a.pdg < b.pdg;
+      if ( a.energy != b.energy ) return a.energy < b.energy;
+      if ( a.ix != b.ix ) return a.ix < b.ix;
+      return a.iy < b.iy;
+    }
+  };
+
+  const uint64_t kAlignment = 8;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashShowerLibrary::EEShashShowerLibrary(const G4String& fileName,
+                                           G4int mode, G4double impactStep)
+ : fFileName(fileName),
+   fMode(mode),
+   fImpactStep(impactStep),
+   fFile(0),
+   fOffset(0),
+   fBase(0),
+   fSize(0)
+{
+  fInstance = this;
+
+  if ( fMode == kReplay ) {
+    Map();
+    return;
+  }
+
+  fFile = std::fopen(fFileName.c_str(), "wb");
+  if ( ! fFile ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write shower library " << fFileName;
+    G4Exception("EEShashShowerLibrary::EEShashShowerLibrary()",
+      "MyCode0015", FatalException, msg);
+    return;
+  }
+
+  // rewritten by Close()
+  EEShashShowerLibraryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::fwrite(&header, sizeof(header), 1, fFile);
+  fOffset = sizeof(header);
+
+  G4cout << "EEShashShowerLibrary: recording showers to " << fFileName
+         << ", impact bins of " << fImpactStep/mm << " mm" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashShowerLibrary::~EEShashShowerLibrary()
+{
+  Close();
+  if ( fBase ) munmap(const_cast<char*>(fBase), fSize);
+  if ( fInstance == this ) fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashShowerLibrary::Buffer& EEShashShowerLibrary::GetBuffer()
+{
+  if ( ! fBuffer ) fBuffer = new Buffer;
+  return *fBuffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerLibrary::RecordStep(const G4Step* step)
+{
+  G4double charge = step->GetTrack()->GetDefinition()->GetPDGCharge();
+  G4double edep = step->GetTotalEnergyDeposit();
+  if ( edep <= 0. && charge == 0. ) return;
+
+  // the scintillation yield applies to the energy left after Birks' law
+  if ( edep > 0. )
+    edep = G4LossTableManager::Instance()->EmSaturation()
+             ->VisibleEnergyDeposition(step);
+
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+  const G4ThreeVector& position = pre->GetPosition();
+  G4ThreeVector delta = post->GetPosition() - position;
+
+  EEShashShowerDeposit deposit;
+  deposit.x      = position.x()/mm;
+  deposit.y      = position.y()/mm;
+  deposit.z      = position.z()/mm;
+  deposit.t      = pre->GetGlobalTime()/ns;
+  deposit.dx     = delta.x()/mm;
+  deposit.dy     = delta.y()/mm;
+  deposit.dz     = delta.z()/mm;
+  deposit.dt     = (post->GetGlobalTime() - pre->GetGlobalTime())/ns;
+  deposit.edep   = edep/MeV;
+  deposit.beta   = charge != 0. ? 0.5*(pre->GetBeta() + post->GetBeta()) : 0.;
+  deposit.charge = charge/eplus;
+  GetBuffer().push_back(deposit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerLibrary::EndOfEvent(const G4Event* event)
+{
+  Buffer& buffer = GetBuffer();
+  const G4PrimaryVertex* vertex = event->GetPrimaryVertex();
+  const G4PrimaryParticle* primary = vertex ? vertex->GetPrimary() : 0;
+  if ( ! fFile || ! primary || event->IsAborted() ) {
+    buffer.clear();
+    return;
+  }
+
+  EEShashShowerEntry shower;
+  std::memset(&shower, 0, sizeof(shower));
+  shower.nDeposits = buffer.size();
+  shower.pdg       = primary->GetPDGcode();
+  shower.energy    = primary->GetKineticEnergy()/MeV;
+  shower.impactX   = vertex->GetX0()/mm;
+  shower.impactY   = vertex->GetY0()/mm;
+  for ( size_t i = 0; i < buffer.size(); ++i ) shower.edep += buffer[i].edep;
+
+  G4AutoLock lock(&showerLibraryMutex);
+  shower.offset = fOffset;
+  if ( ! buffer.empty() )
+    std::fwrite(&buffer[0], sizeof(EEShashShowerDeposit), buffer.size(), fFile);
+  fOffset += buffer.size()*sizeof(EEShashShowerDeposit);
+  fShowers.push_back(shower);
+  lock.unlock();
+
+  buffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerLibrary::Close()
+{
+  if ( ! fFile ) return;
+
+  std::stable_sort(fShowers.begin(), fShowers.end(), ShowerBinOrder(fImpactStep));
+
+  std::vector<EEShashShowerBin> bins;
+  for ( size_t i = 0; i < fShowers.size(); ++i ) {
+    const EEShashShowerEntry& shower = fShowers[i];
+    G4int ix = ImpactBin(shower.impactX*mm, fImpactStep);
+    G4int iy = ImpactBin(shower.impactY*mm, fImpactStep);
+    if ( bins.empty() || bins.back().pdg != shower.pdg
+         || bins.back().energy != shower.energy
+         || bins.back().ix != ix || bins.back().iy != iy ) {
+      EEShashShowerBin bin;
+      std::memset(&bin, 0, sizeof(bin));
+      bin.pdg         = shower.pdg;
+      bin.energy      = shower.energy;
+      bin.ix          = ix;
+      bin.iy          = iy;
+      bin.firstShower = i;
+      bins.push_back(bin);
+    }
+    ++bins.back().nShowers;
+  }
+
+  static const char zeros[kAlignment] = { 0 };
+  uint64_t padding = (kAlignment - fOffset % kAlignment) % kAlignment;
+  if ( padding ) std::fwrite(zeros, 1, padding, fFile);
+
+  EEShashShowerLibraryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, "EESHLIB", sizeof(header.magic));
+  header.version     = 1;
+  header.nBins       = bins.size();
+  header.nShowers    = fShowers.size();
+  header.indexOffset = fOffset + padding;
+  header.impactStep  = fImpactStep/mm;
+  if ( ! bins.empty() )
+    std::fwrite(&bins[0], sizeof(EEShashShowerBin), bins.size(), fFile);
+  if ( ! fShowers.empty() )
+    std::fwrite(&fShowers[0], sizeof(EEShashShowerEntry), fShowers.size(), fFile);
+  std::fseek(fFile, 0, SEEK_SET);
+  std::fwrite(&header, sizeof(header), 1, fFile);
+  std::fclose(fFile);
+  fFile = 0;
+
+  G4cout << "EEShashShowerLibrary: " << fShowers.size() << " showers in "
+         << bins.size() << " bins written to " << fFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerLibrary::Map()
+{
+  int fd = open(fFileName.c_str(), O_RDONLY);
+  struct stat st;
+  if ( fd < 0 || fstat(fd, &st) != 0 ) {
+    if ( fd >= 0 ) close(fd);
+    G4ExceptionDescription msg;
+    msg << "Cannot open shower library " << fFileName;
+    G4Exception("EEShashShowerLibrary::Map()",
+      "MyCode0015", FatalException, msg);
+    return;
+  }
+  fSize = st.st_size;
+  void* base = fSize ? mmap(0, fSize, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  close(fd);
+  if ( base == MAP_FAILED ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot map shower library " << fFileName;
+    G4Exception("EEShashShowerLibrary::Map()",
+      "MyCode0015", FatalException, msg);
+    return;
+  }
+  fBase = static_cast<const char*>(base);
+  // the showers are replayed in random order
+  madvise(base, fSize, MADV_RANDOM);
+
+  if ( fSize < sizeof(EEShashShowerLibraryHeader)
+       || std::strncmp(Header().magic, "EESHLIB", 8) != 0
+       || Header().indexOffset + Header().nBins*sizeof(EEShashShowerBin)
+          + Header().nShowers*sizeof(EEShashShowerEntry) > fSize ) {
+    munmap(base, fSize);
+    fBase = 0;
+    G4ExceptionDescription msg;
+    msg << fFileName << " is not a shower library";
+    G4Exception("EEShashShowerLibrary::Map()",
+      "MyCode0015", FatalException, msg);
+    return;
+  }
+  fImpactStep = Header().impactStep*mm;
+
+  G4cout << "EEShashShowerLibrary: " << Header().nShowers << " showers in "
+         << Header().nBins << " bins mapped from " << fFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashShowerLibrary::FindBin(G4int pdg, G4double energy,
+                                    G4double x, G4double y) const
+{
+  if ( ! fBase ) return -1;
+
+  G4float e = energy/MeV;
+  G4int ix = ImpactBin(x, fImpactStep);
+  G4int iy = ImpactBin(y, fImpactStep);
+
+  // the bins are sorted by particle, energy and impact bin: look up the
+  // first bin of the particle within the energy tolerance, then the impact
+  // bin itself and its four neighbours, as a shower further than one bin
+  // would be moved by a visible amount
+  const EEShashShowerBin* first = Bins();
+  const EEShashShowerBin* last = first + Header().nBins;
+  EEShashShowerBin key;
+  std::memset(&key, 0, sizeof(key));
+  key.pdg = pdg;
+  key.energy = e - 1.e-5*e;
+  key.ix = std::numeric_limits<int32_t>::min();
+  key.iy = std::numeric_limits<int32_t>::min();
+  const EEShashShowerBin* bin = std::lower_bound(first, last, key, BinOrder());
+  if ( bin == last || bin->pdg != pdg
+       || std::fabs(bin->energy - e) > 1.e-5*e ) return -1;
+
+  // the nearest first, then the neighbours in the order of the index
+  static const G4int offsets[5][2] =
+    { { 0, 0 }, { -1, 0 }, { 0, -1 }, { 0, 1 }, { 1, 0 } };
+  key.energy = bin->energy;
+  for ( G4int i = 0; i < 5; ++i ) {
+    key.ix = ix + offsets[i][0];
+    key.iy = iy + offsets[i][1];
+    bin = std::lower_bound(first, last, key, BinOrder());
+    if ( bin != last && ! BinOrder()(key, *bin) ) return G4int(bin - first);
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const EEShashShowerEntry* EEShashShowerLibrary::SampleShower(G4int bin) const
+{
+  const EEShashShowerBin& entry = Bins()[bin];
+  uint64_t i = uint64_t(G4UniformRand()*entry.nShowers);
+  if ( i >= entry.nShowers ) i = entry.nShowers-1;
+  return Showers() + entry.firstShower + i;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
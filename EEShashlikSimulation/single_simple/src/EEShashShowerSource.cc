@@ -0,0 +1,459 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashShowerSource.cc
+/// \brief Implementation of the EEShashShowerSource class
+
+#include "EEShashShowerSource.hh"
+#include "EEShashShowerLibrary.hh"
+#include "EEShashCerenkov.hh"
+#include "G4EmUserPhysics.hh"
+#include "TrackInformation.hh"
+
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4TouchableHistory.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Poisson.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+G4bool EEShashShowerSource::fScintillationOn = true;
+G4bool EEShashShowerSource::fCerenkovOn = false;
+G4ThreadLocal G4Navigator* EEShashShowerSource::fNavigator = 0;
+G4ThreadLocal EEShashShowerSource* EEShashShowerSource::fCurrent = 0;
+
+namespace {
+  const G4int kNofRindexPoints = 100;
+  const G4int kNofBetaPoints = 200;
+  // photons generated, and held in memory, at a time
+  const G4int kChunkPhotons = 10000;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerPhotonInformation::Print() const
+{
+  G4cout << "EEShashShowerPhotonInformation: "
+         << ( fProcess ? fProcess->GetProcessName() : G4String("no process") )
+         << ", weight " << fWeight << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashShowerSource::EEShashShowerSource()
+ : fInitialised(false),
+   fDeposits(0),
+   fNofDeposits(0),
+   fNextDeposit(0),
+   fEvent(0),
+   fNofPhotons(0),
+   fScintillationProcess(0),
+   fCerenkovProcess(0),
+   fYield(0.),
+   fResolutionScale(1.),
+   fYieldRatio(1.),
+   fFastTime(0.),
+   fSlowTime(0.),
+   fRindex(0),
+   fCerenkovEnergyMin(0.),
+   fCerenkovEnergyMax(0.),
+   fMaxRindex(1.),
+   fBetaMin(1.)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashShowerSource::~EEShashShowerSource()
+{
+  if ( fCurrent == this ) fCurrent = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::Initialise()
+{
+  fInitialised = true;
+
+  // the processes of this thread, the creators of the photons
+  G4ProcessTable* processTable = G4ProcessTable::GetProcessTable();
+  if ( fScintillationOn )
+    fScintillationProcess = processTable->FindProcess("Scintillation", "e-");
+  if ( fCerenkovOn )
+    fCerenkovProcess = processTable->FindProcess("Cerenkov", "e-");
+
+  G4LogicalVolume* tile = G4LogicalVolumeStore::GetInstance()->GetVolume("ActLV");
+  G4MaterialPropertiesTable* properties
+    = tile ? tile->GetMaterial()->GetMaterialPropertiesTable() : 0;
+  if ( ! properties ) {
+    G4ExceptionDescription msg;
+    msg << "No optical properties of the tiles, the library showers make no light";
+    G4Exception("EEShashShowerSource::Initialise()",
+      "MyCode0015", JustWarning, msg);
+    fScintillationProcess = 0;
+    fCerenkovProcess = 0;
+    return;
+  }
+
+  // scintillation, as G4Scintillation
+  if ( fScintillationProcess
+       && properties->ConstPropertyExists("SCINTILLATIONYIELD") ) {
+    fYield = properties->GetConstProperty("SCINTILLATIONYIELD")
+             /G4EmUserPhysics::GetThinningFactor();
+    if ( properties->ConstPropertyExists("RESOLUTIONSCALE") )
+      fResolutionScale = properties->GetConstProperty("RESOLUTIONSCALE");
+    if ( properties->ConstPropertyExists("FASTTIMECONSTANT") )
+      fFastTime = properties->GetConstProperty("FASTTIMECONSTANT");
+    if ( properties->ConstPropertyExists("SLOWTIMECONSTANT") )
+      fSlowTime = properties->GetConstProperty("SLOWTIMECONSTANT");
+    BuildSpectrum(properties->GetProperty("FASTCOMPONENT"), fFastEnergy, fFastCDF);
+    BuildSpectrum(properties->GetProperty("SLOWCOMPONENT"), fSlowEnergy, fSlowCDF);
+    if ( fFastCDF.empty() ) fYieldRatio = 0.;
+    else if ( fSlowCDF.empty() ) fYieldRatio = 1.;
+    else if ( properties->ConstPropertyExists("YIELDRATIO") )
+      fYieldRatio = properties->GetConstProperty("YIELDRATIO");
+  }
+  if ( fFastCDF.empty() && fSlowCDF.empty() ) fScintillationProcess = 0;
+
+  // Cerenkov in the energy window of EEShashCerenkov
+  const EEShashCerenkov* cerenkov
+    = dynamic_cast<const EEShashCerenkov*>(fCerenkovProcess);
+  fRindex = properties->GetProperty("RINDEX");
+  if ( cerenkov && fRindex ) {
+    fCerenkovEnergyMin = std::max(fRindex->GetMinLowEdgeEnergy(), cerenkov->GetEnergyMin());
+    fCerenkovEnergyMax = std::min(fRindex->GetMaxLowEdgeEnergy(), cerenkov->GetEnergyMax());
+  }
+  if ( ! cerenkov || ! fRindex || fCerenkovEnergyMax <= fCerenkovEnergyMin ) {
+    fCerenkovProcess = 0;
+  }
+  else {
+    std::vector<G4double> rindex(kNofRindexPoints);
+    G4double de = (fCerenkovEnergyMax - fCerenkovEnergyMin)/(kNofRindexPoints-1);
+    for ( G4int i = 0; i < kNofRindexPoints; ++i )
+      rindex[i] = fRindex->Value(fCerenkovEnergyMin + i*de);
+    fMaxRindex = *std::max_element(rindex.begin(), rindex.end());
+    fBetaMin = 1./fMaxRindex;
+
+    // Frank-Tamm for a unit charge, trapezoidal rule where n*beta > 1
+    const G4double Rfact = 369.81/(eV*cm);
+    fCerenkovPerLength.resize(kNofBetaPoints+1);
+    for ( G4int j = 0; j <= kNofBetaPoints; ++j ) {
+      G4double beta = fBetaMin + j*(1. - fBetaMin)/kNofBetaPoints;
+      G4double integral = 0.;
+      G4double previous = 0.;
+      for ( G4int i = 0; i < kNofRindexPoints; ++i ) {
+        G4double value = 1. - 1./(beta*beta*rindex[i]*rindex[i]);
+        if ( value < 0. ) value = 0.;
+        if ( i > 0 ) integral += 0.5*(previous + value)*de;
+        previous = value;
+      }
+      fCerenkovPerLength[j] = Rfact*integral;
+    }
+  }
+
+  G4cout << "EEShashShowerSource: "
+         << ( fScintillationProcess ? "scintillation " : "" )
+         << ( fCerenkovProcess ? "Cerenkov " : "" )
+         << "photons from the library showers" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::BuildSpectrum(const G4MaterialPropertyVector* component,
+                                        std::vector<G4double>& energy,
+                                        std::vector<G4double>& cdf)
+{
+  energy.clear();
+  cdf.clear();
+  if ( ! component || component->GetVectorLength() < 2 ) return;
+
+  G4double sum = 0.;
+  for ( size_t i = 0; i < component->GetVectorLength(); ++i ) {
+    if ( i > 0 )
+      sum += 0.5*((*component)[i] + (*component)[i-1])
+             *(component->Energy(i) - component->Energy(i-1));
+    energy.push_back(component->Energy(i));
+    cdf.push_back(sum);
+  }
+  if ( sum <= 0. ) {
+    energy.clear();
+    cdf.clear();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashShowerSource::SampleSpectrum(const std::vector<G4double>& energy,
+                                             const std::vector<G4double>& cdf) const
+{
+  G4double value = G4UniformRand()*cdf.back();
+  size_t i = std::upper_bound(cdf.begin(), cdf.end(), value) - cdf.begin();
+  if ( i == 0 ) return energy.front();
+  if ( i >= cdf.size() ) return energy.back();
+  G4double f = (value - cdf[i-1])/(cdf[i] - cdf[i-1]);
+  return energy[i-1] + f*(energy[i] - energy[i-1]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashShowerSource::GetCerenkovPhotonsPerLength(G4double beta) const
+{
+  if ( beta <= fBetaMin || fCerenkovPerLength.empty() ) return 0.;
+  if ( beta >= 1. ) return fCerenkovPerLength.back();
+
+  G4double x = (beta - fBetaMin)/(1. - fBetaMin)*kNofBetaPoints;
+  G4int i = G4int(x);
+  if ( i >= kNofBetaPoints ) return fCerenkovPerLength.back();
+  return fCerenkovPerLength[i]
+         + (x - i)*(fCerenkovPerLength[i+1] - fCerenkovPerLength[i]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashShowerSource::GeneratePhotons(G4Event* event,
+                                           const EEShashShowerEntry& shower,
+                                           const EEShashShowerDeposit* deposits,
+                                           const G4ThreeVector& shift)
+{
+  if ( ! fInitialised ) Initialise();
+
+  fDeposits = deposits;
+  fNofDeposits = shower.nDeposits;
+  fNextDeposit = 0;
+  fShift = shift;
+  fCurrent = this;
+
+  fEvent = event;
+  G4int n = GenerateChunk();
+  fEvent = 0;
+  return n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashShowerSource::GenerateNextPhotons()
+{
+  if ( fNextDeposit >= fNofDeposits ) return false;
+
+  GenerateChunk();
+  G4EventManager::GetEventManager()->StackTracks(&fTracks);
+  fTracks.clear();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashShowerSource::GenerateChunk()
+{
+  fNofPhotons = 0;
+  while ( fNextDeposit < fNofDeposits && fNofPhotons < kChunkPhotons ) {
+    const EEShashShowerDeposit& deposit = fDeposits[fNextDeposit++];
+    G4ThreeVector position
+      = G4ThreeVector(deposit.x*mm, deposit.y*mm, deposit.z*mm) + fShift;
+    G4ThreeVector delta(deposit.dx*mm, deposit.dy*mm, deposit.dz*mm);
+    if ( fScintillationProcess && deposit.edep > 0. )
+      GenerateScintillation(deposit, position, delta);
+    if ( fCerenkovProcess && deposit.beta > 0. )
+      GenerateCerenkov(deposit, position, delta);
+  }
+  return fNofPhotons;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::GenerateScintillation(const EEShashShowerDeposit& deposit,
+                                                const G4ThreeVector& position,
+                                                const G4ThreeVector& delta)
+{
+  G4double mean = fYield*deposit.edep*MeV;
+  G4int n;
+  if ( mean > 10. )
+    n = G4int(G4RandGauss::shoot(mean, fResolutionScale*std::sqrt(mean)) + 0.5);
+  else
+    n = G4int(G4Poisson(mean));
+
+  // thinned photons carry the weight TrackingAction gives their siblings
+  G4double weight = G4EmUserPhysics::GetThinningFactor();
+
+  for ( G4int i = 0; i < n; ++i ) {
+    G4bool fast = G4UniformRand() < fYieldRatio;
+    G4double energy = fast ? SampleSpectrum(fFastEnergy, fFastCDF)
+                           : SampleSpectrum(fSlowEnergy, fSlowCDF);
+    G4double decayTime = fast ? fFastTime : fSlowTime;
+
+    // isotropic, with a random linear polarisation
+    G4double cosTheta = 1. - 2.*G4UniformRand();
+    G4double sinTheta = std::sqrt((1. - cosTheta)*(1. + cosTheta));
+    G4double phi = twopi*G4UniformRand();
+    G4ThreeVector direction(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+    G4ThreeVector perpendicular = direction.orthogonal().unit();
+    G4double psi = twopi*G4UniformRand();
+    G4ThreeVector polarisation = std::cos(psi)*perpendicular
+                               + std::sin(psi)*direction.cross(perpendicular);
+
+    G4double u = G4UniformRand();
+    G4double time = (deposit.t + u*deposit.dt)*ns
+                    - decayTime*std::log(G4UniformRand());
+    AddPhoton(position + u*delta, time, energy, direction,
+              polarisation, fScintillationProcess, weight);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::GenerateCerenkov(const EEShashShowerDeposit& deposit,
+                                           const G4ThreeVector& position,
+                                           const G4ThreeVector& delta)
+{
+  G4double beta = deposit.beta;
+  G4double mean = GetCerenkovPhotonsPerLength(beta)
+                  *deposit.charge*deposit.charge*delta.mag();
+  if ( mean <= 0. ) return;
+  G4int n = G4int(G4Poisson(mean));
+
+  G4ThreeVector axis = delta.unit();
+  G4double maxCos = 1./(beta*fMaxRindex);
+  G4double maxSin2 = (1. - maxCos)*(1. + maxCos);
+
+  for ( G4int i = 0; i < n; ++i ) {
+    // energy and angle, as EEShashCerenkov
+    G4double energy, cosTheta, sin2Theta;
+    do {
+      energy = fCerenkovEnergyMin
+               + G4UniformRand()*(fCerenkovEnergyMax - fCerenkovEnergyMin);
+      cosTheta = 1./(beta*fRindex->Value(energy));
+      sin2Theta = (1. - cosTheta)*(1. + cosTheta);
+    } while ( G4UniformRand()*maxSin2 > sin2Theta );
+
+    G4double sinTheta = std::sqrt(sin2Theta);
+    G4double phi = twopi*G4UniformRand();
+    G4double sinPhi = std::sin(phi);
+    G4double cosPhi = std::cos(phi);
+    G4ThreeVector direction(sinTheta*cosPhi, sinTheta*sinPhi, cosTheta);
+    direction.rotateUz(axis);
+    G4ThreeVector polarisation(cosTheta*cosPhi, cosTheta*sinPhi, -sinTheta);
+    polarisation.rotateUz(axis);
+
+    G4double u = G4UniformRand();
+    G4double time = (deposit.t + u*deposit.dt)*ns;
+    AddPhoton(position + u*delta, time, energy, direction,
+              polarisation, fCerenkovProcess, 1.);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::AddPhoton(const G4ThreeVector& position,
+                                    G4double time, G4double energy,
+                                    const G4ThreeVector& direction,
+                                    const G4ThreeVector& polarisation,
+                                    const G4VProcess* process, G4double weight)
+{
+  ++fNofPhotons;
+
+  if ( ! fEvent ) {
+    G4DynamicParticle* particle
+      = new G4DynamicParticle(G4OpticalPhoton::OpticalPhotonDefinition(),
+                              direction, energy);
+    particle->SetPolarization(polarisation.x(), polarisation.y(),
+                              polarisation.z());
+    G4Track* track = new G4Track(particle, time, position);
+    track->SetParentID(0);
+    SetUpTrack(track, process, weight);
+    fTracks.push_back(track);
+    return;
+  }
+
+  G4PrimaryParticle* photon
+    = new G4PrimaryParticle(G4OpticalPhoton::OpticalPhotonDefinition());
+  photon->SetMomentum(energy*direction.x(), energy*direction.y(),
+                      energy*direction.z());
+  photon->SetPolarization(polarisation.x(), polarisation.y(), polarisation.z());
+  photon->SetUserInformation(new EEShashShowerPhotonInformation(process, weight));
+
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+  vertex->SetPrimary(photon);
+  fEvent->AddPrimaryVertex(vertex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::PrepareTrack(G4Track* track)
+{
+  const G4PrimaryParticle* primary
+    = track->GetDynamicParticle()->GetPrimaryParticle();
+  const EEShashShowerPhotonInformation* photonInfo = primary
+    ? dynamic_cast<const EEShashShowerPhotonInformation*>(primary->GetUserInformation())
+    : 0;
+  if ( ! photonInfo ) return;
+
+  SetUpTrack(track, photonInfo->GetProcess(), photonInfo->GetWeight());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashShowerSource::SetUpTrack(G4Track* track, const G4VProcess* process,
+                                     G4double weight)
+{
+  track->SetCreatorProcess(process);
+
+  TrackInformation* info = new TrackInformation(track);
+  info->SetParticleProdTimeInformation(track->GetGlobalTime()/picosecond);
+  info->SetParticleWeight(weight);
+  track->SetUserInformation(info);
+
+  // tracks without a parent get their touchable only when they are tracked,
+  // the stacking action needs the volume the photon starts in
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()->GetWorldVolume();
+  if ( ! fNavigator ) fNavigator = new G4Navigator;
+  if ( fNavigator->GetWorldVolume() != world ) fNavigator->SetWorldVolume(world);
+
+  G4ThreeVector direction = track->GetMomentumDirection();
+  fNavigator->LocateGlobalPointAndSetup(track->GetPosition(), &direction,
+                                        false, false);
+  G4TouchableHandle touchable = fNavigator->CreateTouchableHistory();
+  track->SetTouchableHandle(touchable);
+  track->SetNextTouchableHandle(touchable);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
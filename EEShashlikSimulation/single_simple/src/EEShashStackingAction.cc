@@ -0,0 +1,219 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashStackingAction.cc
+/// \brief Implementation of the EEShashStackingAction class
+
+#include "EEShashStackingAction.hh"
+#include "EEShashOpticalReadoutSD.hh"
+#include "EEShashFibreFastModel.hh"
+#include "EEShashTileFastModel.hh"
+#include "EEShashRunTelemetry.hh"
+#include "EEShashOpticalKillPolicy.hh"
+#include "EEShashShowerSource.hh"
+#include "TrackInformation.hh"
+#include "CreateTree.h"
+
+#include "G4Track.hh"
+#include "G4StackManager.hh"
+#include "G4VProcess.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4SDManager.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+
+G4int EEShashStackingAction::fPhotonBudget = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashStackingAction::EEShashStackingAction()
+ : G4UserStackingAction(),
+   fDetector(0),
+   fReadout(0)
+{
+  PrepareNewEvent();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashStackingAction::~EEShashStackingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack
+EEShashStackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  if ( track->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition() )
+    return fUrgent;
+
+  // photons of a replayed library shower are primaries
+  if ( track->GetParentID() == 0 )
+    EEShashShowerSource::PrepareTrack(const_cast<G4Track*>(track));
+
+  EEShashRunTelemetry::PhotonCreated();
+  if ( EEShashOpticalKillPolicy::ApplyAtBirth(track) != kNoKill ) return fKill;
+  if ( ! ApplyQEAtBirth(track) ) return fKill;
+
+  // the light of the tiles in fast simulation is collected before stacking,
+  // and costs too little to be thinned by the budget
+  EEShashTileFastModel* tileModel = EEShashTileFastModel::GetInstance();
+  if ( tileModel && tileModel->CollectAtBirth(track) ) return fKill;
+
+  if ( ! ApplyPhotonBudget(track) ) return fKill;
+
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashStackingAction::NewStage()
+{
+  // the photons of a replayed library shower come chunk by chunk, the next
+  // one as soon as the previous one is tracked
+  EEShashShowerSource* source = EEShashShowerSource::GetCurrent();
+  while ( source && stackManager->GetNUrgentTrack() == 0
+          && source->GenerateNextPhotons() ) {}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashStackingAction::PrepareNewEvent()
+{
+  for ( G4int i = 0; i < kNofVolumeStrata*kNofProcessStrata; ++i )
+    fNofGenerated[i] = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashStackingAction::ApplyQEAtBirth(const G4Track* track)
+{
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if ( ! creator || creator->GetProcessSubType() != fOpWLS ) return true;
+
+  EEShashOpticalReadoutSD* readout = GetReadout();
+  if ( ! readout || ! readout->GetQEAtBirth() ) return true;
+
+  TrackInformation* info
+    = static_cast<TrackInformation*>(track->GetUserInformation());
+  if ( ! info || info->GetQEApplied() ) return true;
+
+  // the same probability at any energy: a photon out of the QE window may
+  // still be re-emitted inside it, the readout plays the rest of the QE
+  // at the energy the photon arrives with
+  if ( G4UniformRand() >= readout->GetMaxAcceptance() ) return false;
+
+  info->SetQEApplied(true);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashStackingAction::ApplyPhotonBudget(const G4Track* track)
+{
+  if ( fPhotonBudget <= 0 ) return true;
+
+  // the calibration tables need every photon, unweighted
+  const EEShashDetectorConstruction* detector = GetDetector();
+  if ( ! detector || detector->GetTileMode() == kTileCalibration
+       || detector->GetFibreMode() == kFibreCalibration ) return true;
+
+  TrackInformation* info
+    = static_cast<TrackInformation*>(track->GetUserInformation());
+  if ( ! info ) return true;
+
+  G4int stratum = GetStratum(track);
+  if ( stratum < 0 ) return true;
+
+  CreateTree::Instance()->NOpt_generated += 1;
+
+  G4double budget
+    = G4double(fPhotonBudget)/(kNofVolumeStrata*kNofProcessStrata);
+  G4int n = ++fNofGenerated[stratum];
+  if ( n > budget ) {
+    G4double probability = budget/n;
+    if ( G4UniformRand() >= probability ) return false;
+    info->SetParticleWeight(info->GetParticleWeight()/probability);
+  }
+
+  CreateTree::Instance()->NOpt_tracked += 1;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashStackingAction::GetStratum(const G4Track* track)
+{
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if ( ! creator || ! track->GetVolume() ) return -1;
+
+  G4int process;
+  switch ( creator->GetProcessSubType() ) {
+    case fScintillation : process = 0; break;
+    case fOpWLS         : process = 1; break;
+    case fCerenkov      : process = 2; break;
+    default             : return -1;
+  }
+
+  G4int volume;
+  switch ( GetDetector()->GetRole(track->GetVolume()) ) {
+    case kActVolume       : volume = 0; break;
+    case kFibreCoreVolume : volume = 1; break;
+    case kGreaseVolume    : volume = 2; break;
+    default               : return -1;
+  }
+
+  return volume*kNofProcessStrata + process;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const EEShashDetectorConstruction* EEShashStackingAction::GetDetector()
+{
+  if ( ! fDetector ) {
+    fDetector = static_cast<const EEShashDetectorConstruction*>(
+      G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  }
+  return fDetector;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashOpticalReadoutSD* EEShashStackingAction::GetReadout()
+{
+  if ( ! fReadout ) {
+    // the tile calibration needs every WLS photon born in the fibres
+    const EEShashDetectorConstruction* detector = GetDetector();
+    if ( detector && detector->GetTileMode() == kTileCalibration ) return 0;
+
+    fReadout = static_cast<EEShashOpticalReadoutSD*>(
+      G4SDManager::GetSDMpointer()->FindSensitiveDetector("OpticalSD", false));
+  }
+  return fReadout;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
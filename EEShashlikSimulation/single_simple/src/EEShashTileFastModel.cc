@@ -0,0 +1,195 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTileFastModel.cc
+/// \brief Implementation of the EEShashTileFastModel class
+
+#include "EEShashTileFastModel.hh"
+#include "EEShashTileTable.hh"
+#include "EEShashFibreTable.hh"
+#include "EEShashOpticalReadoutSD.hh"
+#include "EEShashOpticalHit.hh"
+#include "TrackInformation.hh"
+#include "CreateTree.h"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4SystemOfUnits.hh"
+
+G4ThreadLocal EEShashTileFastModel* EEShashTileFastModel::fInstance = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTileFastModel::EEShashTileFastModel(const G4String& name,
+                                           G4Region* envelope,
+                                           EEShashTileTable* table,
+                                           G4int mode,
+                                           EEShashFibreTable* fibreTable,
+                                           EEShashOpticalReadoutSD* readout)
+ : G4VFastSimulationModel(name, envelope),
+   fEnvelope(envelope),
+   fTable(table),
+   fMode(mode),
+   fFibreTable(fibreTable),
+   fReadout(readout)
+{
+  if ( fMode == kTileFastSimulation ) fInstance = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTileFastModel::~EEShashTileFastModel()
+{
+  if ( fInstance == this ) fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashTileFastModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4OpticalPhoton::OpticalPhotonDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashTileFastModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+
+  // only the photons emitted in the tile, at their first step
+  if ( track->GetCurrentStepNumber() > 1 || track->GetParentID() == 0 )
+    return false;
+
+  if ( fMode == kTileCalibration ) {
+    fTable->RecordBirth(track->GetTrackID(),
+                        GetBin(track, fastTrack.GetPrimaryTrackLocalPosition()),
+                        track->GetGlobalTime());
+    return false;
+  }
+
+  return fMode == kTileFastSimulation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileFastModel::DoIt(const G4FastTrack& fastTrack,
+                                G4FastStep& fastStep)
+{
+  Collect(fastTrack.GetPrimaryTrack(),
+          fastTrack.GetPrimaryTrackLocalPosition());
+
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashTileFastModel::CollectAtBirth(const G4Track* track)
+{
+  if ( fMode != kTileFastSimulation || track->GetParentID() == 0 ) return false;
+
+  // the secondaries of a step share its pre-step touchable
+  const G4VTouchable* touchable = track->GetTouchable();
+  if ( ! touchable || ! touchable->GetVolume() ) return false;
+  if ( touchable->GetVolume()->GetLogicalVolume()->GetRegion() != fEnvelope )
+    return false;
+
+  Collect(track, touchable->GetHistory()->GetTopTransform()
+                   .TransformPoint(track->GetPosition()));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileFastModel::AddFibre(G4int fibre,
+                                    const G4AffineTransform& frame,
+                                    G4double halfLength)
+{
+  if ( fibre < 0 ) return;
+  if ( fibre >= G4int(fFibreFrames.size()) ) {
+    fFibreFrames.resize(fibre+1);
+    fFibreHalfLengths.resize(fibre+1, 0.);
+  }
+  fFibreFrames[fibre] = frame;
+  fFibreHalfLengths[fibre] = halfLength;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileFastModel::Collect(const G4Track* track,
+                                   const G4ThreeVector& localPosition)
+{
+  G4int bin = GetBin(track, localPosition);
+  const TrackInformation* info
+    = static_cast<const TrackInformation*>(track->GetUserInformation());
+  G4double weight = info ? info->GetParticleWeight() : 1.;
+
+  // expected captures are summed without sampling noise
+  CreateTree* tree = CreateTree::Instance();
+  float* expected[4]
+    = { &tree->Capture_0, &tree->Capture_1, &tree->Capture_2, &tree->Capture_3 };
+  for ( G4int i = 0; i < fTable->GetNofFibres() && i < 4; ++i )
+    *expected[i] += weight*fTable->GetCaptureProbability(bin, i);
+
+  G4int fibre;
+  G4double delay;
+  if ( ! fTable->SampleCapture(bin, fibre, delay) ) return;
+  G4double time = track->GetGlobalTime() + delay;
+  tree->Fibre_capture.push_back(fibre);
+  tree->Time_capture.push_back(time/ns);
+
+  // re-emitted in the fibre at the depth of the emission in the tile
+  if ( ! fFibreTable || ! fReadout ) return;
+  if ( fibre >= G4int(fFibreFrames.size()) || fFibreHalfLengths[fibre] <= 0. )
+    return;
+  const G4AffineTransform& frame = fFibreFrames[fibre];
+  G4ThreeVector inFibre = frame.TransformPoint(track->GetPosition());
+  G4double distance = fFibreHalfLengths[fibre] - inFibre.z();
+  G4double lambda, transport;
+  if ( ! fFibreTable->SampleEmission(distance, lambda, transport) ) return;
+
+  G4ThreeVector vertex
+    = frame.Inverse().TransformPoint(G4ThreeVector(0., 0., inFibre.z()));
+  fReadout->AddPhoton(fibre, 1239.84193/lambda*eV, time + transport,
+                      vertex.z(), vertex.theta(), EEShashOpticalHit::kWLS,
+                      weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashTileFastModel::GetBin(const G4Track* track,
+                                   const G4ThreeVector& localPosition) const
+{
+  G4double lambda = 1239.84193/(track->GetTotalEnergy()/eV);
+  return fTable->GetBin(localPosition, lambda);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,267 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTileTable.cc
+/// \brief Implementation of the EEShashTileTable class
+
+#include "EEShashTileTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+EEShashTileTable* EEShashTileTable::fInstance = 0;
+G4ThreadLocal EEShashTileTable::PendingMap* EEShashTileTable::fPending = 0;
+
+namespace {
+  G4Mutex tileTableMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTileTable::EEShashTileTable(G4double sizeXY, G4double thickness,
+                                   G4int nFibres, G4int nXY, G4int nZ,
+                                   G4int nLambda, G4double lambdaMin,
+                                   G4double lambdaMax)
+ : fSizeXY(sizeXY),
+   fThickness(thickness),
+   fNFibres(nFibres),
+   fNXY(nXY),
+   fNZ(nZ),
+   fNLambda(nLambda),
+   fLambdaMin(lambdaMin),
+   fLambdaMax(lambdaMax)
+{
+  Reset();
+
+  fInstance = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTileTable::~EEShashTileTable()
+{
+  if ( fInstance == this ) fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileTable::Reset()
+{
+  G4int nBins = fNXY*fNXY*fNZ*fNLambda;
+  fGenerated.assign(nBins, 0.);
+  fCaptured.assign(nBins*fNFibres, 0.);
+  fSumDelay.assign(nBins, 0.);
+  fSumDelay2.assign(nBins, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EEShashTileTable::GetBin(const G4ThreeVector& localPosition,
+                               G4double lambda) const
+{
+  if ( lambda < fLambdaMin || lambda >= fLambdaMax ) return -1;
+
+  G4int ix = G4int((localPosition.x()/fSizeXY + 0.5)*fNXY);
+  G4int iy = G4int((localPosition.y()/fSizeXY + 0.5)*fNXY);
+  G4int iz = G4int((localPosition.z()/fThickness + 0.5)*fNZ);
+  if ( ix < 0 || ix >= fNXY || iy < 0 || iy >= fNXY ) return -1;
+  // photons born on the faces still belong to the tile
+  if ( iz < 0 ) iz = 0;
+  if ( iz >= fNZ ) iz = fNZ-1;
+  G4int ilambda = G4int((lambda-fLambdaMin)/(fLambdaMax-fLambdaMin)*fNLambda);
+
+  return ((ix*fNXY + iy)*fNZ + iz)*fNLambda + ilambda;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTileTable::PendingMap& EEShashTileTable::GetPending()
+{
+  if ( ! fPending ) fPending = new PendingMap;
+  return *fPending;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileTable::RecordBirth(G4int trackID, G4int bin, G4double time)
+{
+  if ( bin < 0 ) return;
+  GetPending()[trackID] = std::make_pair(bin, time);
+  G4AutoLock lock(&tileTableMutex);
+  fGenerated[bin] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileTable::RecordCapture(G4int trackID, G4int fibre, G4double time)
+{
+  if ( fibre < 0 || fibre >= fNFibres ) return;
+  PendingMap& pending = GetPending();
+  PendingMap::iterator it = pending.find(trackID);
+  if ( it == pending.end() ) return;
+
+  // a photon is captured once, whatever the number of re-emitted photons
+  G4int bin = it->second.first;
+  G4double delay = (time - it->second.second)/ns;
+  pending.erase(it);
+
+  G4AutoLock lock(&tileTableMutex);
+  fCaptured[bin*fNFibres + fibre] += 1.;
+  fSumDelay[bin]  += delay;
+  fSumDelay2[bin] += delay*delay;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EEShashTileTable::GetCaptureProbability(G4int bin, G4int fibre) const
+{
+  if ( bin < 0 || fibre < 0 || fibre >= fNFibres ) return 0.;
+  if ( fGenerated[bin] <= 0. ) return 0.;
+  return fCaptured[bin*fNFibres + fibre]/fGenerated[bin];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EEShashTileTable::SampleCapture(G4int bin, G4int& fibre,
+                                       G4double& delay) const
+{
+  fibre = -1;
+  delay = 0.;
+  if ( bin < 0 || fGenerated[bin] <= 0. ) return false;
+
+  // the fibres compete for the same photon
+  G4double r = G4UniformRand()*fGenerated[bin];
+  G4double nCaptured = 0.;
+  for ( G4int i = 0; i < fNFibres; ++i ) {
+    nCaptured += fCaptured[bin*fNFibres + i];
+    if ( fibre < 0 && r < nCaptured ) fibre = i;
+  }
+  if ( fibre < 0 ) return false;
+
+  G4double mean = fSumDelay[bin]/nCaptured;
+  G4double rms2 = fSumDelay2[bin]/nCaptured - mean*mean;
+  G4double rms  = rms2 > 0. ? std::sqrt(rms2) : 0.;
+
+  delay = G4RandGauss::shoot(mean, rms);
+  if ( delay < 0. ) delay = 0.;
+  delay *= ns;
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileTable::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName.c_str());
+  if ( !out ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open tile table file " << fileName << " for writing";
+    G4Exception("EEShashTileTable::Write()",
+      "MyCode0006", FatalException, msg);
+    return;
+  }
+
+  out << "# EEShashTileTable " << fNFibres << " " << fNXY << " " << fNZ
+      << " " << fNLambda << " " << fSizeXY/mm << " " << fThickness/mm
+      << " " << fLambdaMin << " " << fLambdaMax << "\n";
+  G4int bin = 0;
+  for ( G4int ix = 0; ix < fNXY; ++ix )
+    for ( G4int iy = 0; iy < fNXY; ++iy )
+      for ( G4int iz = 0; iz < fNZ; ++iz )
+        for ( G4int ilambda = 0; ilambda < fNLambda; ++ilambda, ++bin ) {
+          out << ix << " " << iy << " " << iz << " " << ilambda << " "
+              << fGenerated[bin];
+          for ( G4int i = 0; i < fNFibres; ++i )
+            out << " " << fCaptured[bin*fNFibres + i];
+          out << " " << fSumDelay[bin] << " " << fSumDelay2[bin] << "\n";
+        }
+
+  G4cout << ">>> EEShashTileTable: written " << bin
+         << " bins to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTileTable::Load(const G4String& fileName)
+{
+  std::ifstream in(fileName.c_str());
+  std::string line;
+  std::string tag, name;
+  G4int nFibres = 0, nXY = 0, nZ = 0, nLambda = 0;
+  G4double sizeXY = 0., thickness = 0.;
+
+  if ( in && std::getline(in, line) ) {
+    std::istringstream header(line);
+    header >> tag >> name >> nFibres >> nXY >> nZ >> nLambda
+           >> sizeXY >> thickness >> fLambdaMin >> fLambdaMax;
+  }
+  if ( name != "EEShashTileTable" ||
+       nFibres <= 0 || nXY <= 0 || nZ <= 0 || nLambda <= 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read tile table file " << fileName;
+    G4Exception("EEShashTileTable::Load()",
+      "MyCode0006", FatalException, msg);
+    return;
+  }
+
+  fNFibres = nFibres;
+  fNXY = nXY;
+  fNZ = nZ;
+  fNLambda = nLambda;
+  fSizeXY = sizeXY*mm;
+  fThickness = thickness*mm;
+  Reset();
+
+  G4int nBins = 0;
+  G4int ix, iy, iz, ilambda;
+  while ( in >> ix >> iy >> iz >> ilambda ) {
+    G4int bin = ((ix*fNXY + iy)*fNZ + iz)*fNLambda + ilambda;
+    G4bool inRange = ix >= 0 && ix < fNXY && iy >= 0 && iy < fNXY &&
+                     iz >= 0 && iz < fNZ && ilambda >= 0 && ilambda < fNLambda;
+    G4double value;
+    in >> value;
+    if ( inRange ) fGenerated[bin] = value;
+    for ( G4int i = 0; i < fNFibres; ++i ) {
+      in >> value;
+      if ( inRange ) fCaptured[bin*fNFibres + i] = value;
+    }
+    in >> value;
+    if ( inRange ) fSumDelay[bin] = value;
+    in >> value;
+    if ( inRange ) fSumDelay2[bin] = value;
+    if ( inRange ) ++nBins;
+  }
+
+  G4cout << ">>> EEShashTileTable: loaded " << nBins
+         << " bins from " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,352 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTreeMerger.cc
+/// \brief Implementation of the EEShashTreeMerger class
+
+#include "EEShashTreeMerger.hh"
+#include "CreateTree.h"
+
+#include "TFile.h"
+#include "TMemFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <sstream>
+
+EEShashTreeMerger* EEShashTreeMerger::fInstance = 0;
+G4ThreadLocal TMemFile* EEShashTreeMerger::fChunkFile = 0;
+G4ThreadLocal G4int EEShashTreeMerger::fChunkEvents = 0;
+
+namespace {
+  G4Mutex mergerMutex = G4MUTEX_INITIALIZER;
+#ifdef G4MULTITHREADED
+  G4Condition queueCondition = G4CONDITION_INITIALIZER;  // message queued
+  G4Condition flushCondition = G4CONDITION_INITIALIZER;  // flush done
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTreeMerger::EEShashTreeMerger(const G4String& fileName,
+                                     G4int chunkSize)
+ : fFileName(fileName),
+   fChunkSize(chunkSize),
+   fStop(false),
+   fNofFlushes(0),
+   fNofFlushed(0),
+   fWriter(0),
+   fOutputFile(0),
+   fOutputTree(0),
+   fStatsTree(0),
+   fNextEvent(0),
+   fStatsRun(0),
+   fStatsThread(0),
+   fStatsEvents(0),
+   fStatsChunks(0),
+   fStatsBytes(0)
+{
+  fInstance = this;
+
+#ifdef G4MULTITHREADED
+  fWriter = new G4Thread;
+  G4THREADCREATE(fWriter, &EEShashTreeMerger::WriterLoop, this);
+#else
+  // sequential build: the chunks are written as they are shipped
+  WriterLoop(this);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTreeMerger::~EEShashTreeMerger()
+{
+  G4MUTEXLOCK(&mergerMutex);
+  fStop = true;
+#ifdef G4MULTITHREADED
+  G4CONDITIONBROADCAST(&queueCondition);
+#endif
+  G4MUTEXUNLOCK(&mergerMutex);
+
+#ifdef G4MULTITHREADED
+  G4THREADJOIN(*fWriter);
+  delete fWriter;
+#else
+  WriterLoop(this);
+#endif
+
+  if ( fInstance == this ) fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::BeginOfWorkerRun()
+{
+  if ( fInstance && ! fChunkFile ) OpenChunk();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::EventFilled()
+{
+  if ( ! fChunkFile ) return;
+  if ( ++fChunkEvents >= fInstance->fChunkSize ) ShipChunk();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::EndOfWorkerRun()
+{
+  if ( fChunkFile ) ShipChunk();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::OpenChunk()
+{
+  std::ostringstream name;
+  name << "chunk_t" << G4Threading::G4GetThreadId();
+  fChunkFile = new TMemFile(name.str().c_str(), "RECREATE");
+  fChunkFile->cd();
+  if ( CreateTree::Instance() ) CreateTree::Instance()->Rebook();
+  else new CreateTree("tree");
+  CreateTree::Instance()->ApplyOutputSettings();
+  fChunkEvents = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::ShipChunk()
+{
+  if ( fChunkEvents == 0 ) return;
+
+  // the baskets are compressed here, in the worker
+  TMemFile* file = fChunkFile;
+  TTree* tree = CreateTree::Instance()->GetTree();
+  file->cd();
+  tree->Write();
+
+  Message message;
+  message.thread    = G4Threading::G4GetThreadId();
+  message.file      = file;
+  message.nofEvents = fChunkEvents;
+  message.bytes     = file->GetSize();
+
+  // the worker goes on with a new chunk, the writer reads the tree back
+  // from the memory file
+  OpenChunk();
+  delete tree;
+  fInstance->Ship(message);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::Ship(const Message& message)
+{
+  G4MUTEXLOCK(&mergerMutex);
+  fQueue.push_back(message);
+#ifdef G4MULTITHREADED
+  G4CONDITIONBROADCAST(&queueCondition);
+#endif
+  G4MUTEXUNLOCK(&mergerMutex);
+
+#ifndef G4MULTITHREADED
+  WriterLoop(this);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::Flush()
+{
+  Message message;
+  message.thread    = -1;
+  message.file      = 0;
+  message.nofEvents = 0;
+  message.bytes     = 0;
+
+  G4MUTEXLOCK(&mergerMutex);
+  G4int flush = ++fNofFlushes;
+  fQueue.push_back(message);
+#ifdef G4MULTITHREADED
+  G4CONDITIONBROADCAST(&queueCondition);
+  while ( fNofFlushed < flush )
+    G4CONDITIONWAIT(&flushCondition, &mergerMutex);
+  G4MUTEXUNLOCK(&mergerMutex);
+#else
+  G4MUTEXUNLOCK(&mergerMutex);
+  WriterLoop(this);
+  (void)flush;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreadFunReturnType EEShashTreeMerger::WriterLoop(G4ThreadFunArgType arg)
+{
+  // in a sequential build this runs in the caller until the queue is empty
+  EEShashTreeMerger* merger = static_cast<EEShashTreeMerger*>(arg);
+
+  if ( ! merger->fOutputFile ) {
+    merger->fOutputFile = new TFile(merger->fFileName.c_str(), "RECREATE");
+    merger->fOutputTree = new CreateTree("tree");
+    merger->fOutputTree->OpenColumnExport();
+    merger->fStatsTree = new TTree("threadStats", "CreateTree chunks per thread");
+    merger->fStatsTree->Branch("run", &merger->fStatsRun, "run/I");
+    merger->fStatsTree->Branch("thread", &merger->fStatsThread, "thread/I");
+    merger->fStatsTree->Branch("events", &merger->fStatsEvents, "events/I");
+    merger->fStatsTree->Branch("chunks", &merger->fStatsChunks, "chunks/I");
+    merger->fStatsTree->Branch("bytes", &merger->fStatsBytes, "bytes/L");
+  }
+
+  while ( true ) {
+    G4MUTEXLOCK(&mergerMutex);
+#ifdef G4MULTITHREADED
+    while ( merger->fQueue.empty() && ! merger->fStop )
+      G4CONDITIONWAIT(&queueCondition, &mergerMutex);
+#endif
+    if ( merger->fQueue.empty() ) {
+      G4MUTEXUNLOCK(&mergerMutex);
+      break;
+    }
+    Message message = merger->fQueue.front();
+    merger->fQueue.pop_front();
+    G4MUTEXUNLOCK(&mergerMutex);
+
+    if ( message.file ) {
+      merger->ReadChunk(message);
+      merger->WriteReady(false);
+    }
+    else {
+      merger->WriteReady(true);
+      merger->WriteStats();
+      G4MUTEXLOCK(&mergerMutex);
+      ++merger->fNofFlushed;
+#ifdef G4MULTITHREADED
+      G4CONDITIONBROADCAST(&flushCondition);
+#endif
+      G4MUTEXUNLOCK(&mergerMutex);
+    }
+  }
+
+  if ( merger->fStop && merger->fOutputFile ) {
+    merger->WriteReady(true);
+    merger->fOutputTree->CloseColumnExport();
+    merger->fOutputFile->cd();
+    merger->fOutputTree->GetTree()->Write("", TObject::kOverwrite);
+    merger->fStatsTree->Write("", TObject::kOverwrite);
+    merger->fOutputFile->Close();
+    delete merger->fOutputFile;
+    merger->fOutputFile = 0;
+  }
+
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::ReadChunk(const Message& message)
+{
+  // first chunk of a run: the output settings may have changed
+  if ( fStats.empty() ) fOutputTree->ApplyOutputSettings();
+
+  ThreadStats& stats = fStats[message.thread];
+  stats.events += message.nofEvents;
+  stats.chunks += 1;
+  stats.bytes  += message.bytes;
+
+  TTree* tree = static_cast<TTree*>(message.file->Get("tree"));
+  if ( ! tree || tree->GetEntries() == 0 ) {
+    delete message.file;
+    return;
+  }
+
+  Chunk* chunk = new Chunk;
+  chunk->thread     = message.thread;
+  chunk->file       = message.file;
+  chunk->tree       = tree;
+  chunk->nofPending = tree->GetEntries();
+
+  // entries are read straight into the output tree's buffers; the event
+  // number alone tells where each one goes
+  fOutputTree->GetTree()->CopyAddresses(tree);
+  TBranch* eventBranch = tree->GetBranch("Event");
+  for ( Long64_t i = 0; i < tree->GetEntries(); ++i ) {
+    eventBranch->GetEntry(i);
+    fHeldBack[fOutputTree->Event] = std::make_pair(chunk, i);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::WriteEntry(Chunk* chunk, Long64_t entry)
+{
+  chunk->tree->GetEntry(entry);
+  fOutputTree->Fill();
+
+  if ( --chunk->nofPending == 0 ) {
+    delete chunk->file;  // and its tree
+    delete chunk;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::WriteReady(G4bool all)
+{
+  // in event order; all: the end of the run, do not wait for gaps
+  while ( ! fHeldBack.empty() ) {
+    std::map<G4int, std::pair<Chunk*,Long64_t> >::iterator it
+      = fHeldBack.begin();
+    if ( ! all && it->first != fNextEvent ) break;
+    fNextEvent = it->first + 1;
+    WriteEntry(it->second.first, it->second.second);
+    fHeldBack.erase(it);
+  }
+  if ( all ) fNextEvent = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeMerger::WriteStats()
+{
+  std::map<G4int, ThreadStats>::const_iterator it;
+  for ( it = fStats.begin(); it != fStats.end(); ++it ) {
+    fStatsThread = it->first;
+    fStatsEvents = it->second.events;
+    fStatsChunks = it->second.chunks;
+    fStatsBytes  = it->second.bytes;
+    fStatsTree->Fill();
+  }
+  fStats.clear();
+  ++fStatsRun;
+
+  // the file is complete after every run
+  fOutputFile->cd();
+  fOutputTree->GetTree()->Write("", TObject::kOverwrite);
+  fStatsTree->Write("", TObject::kOverwrite);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashTreeWriter.cc
+/// \brief Implementation of the EEShashTreeWriter class
+
+#include "EEShashTreeWriter.hh"
+#include "CreateTree.h"
+
+#include "G4Timer.hh"
+#include "G4ios.hh"
+
+#include "TThread.h"
+#include "TMutex.h"
+#include "TCondition.h"
+
+EEShashTreeWriter* EEShashTreeWriter::fInstance = 0;
+G4int EEShashTreeWriter::fDepth = 2;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTreeWriter::EEShashTreeWriter(CreateTree* output)
+ : fOutput(output),
+   fStop(false),
+   fBusy(false),
+   fNofEvents(0),
+   fMaxQueued(0),
+   fSumQueued(0.),
+   fNofStalls(0),
+   fStallTime(0.),
+   fWriteTime(0.)
+{
+  fInstance = this;
+
+  fMutex = new TMutex();
+  fFilled = new TCondition(fMutex);
+  fWritten = new TCondition(fMutex);
+  fThread = new TThread("EEShashTreeWriter", &EEShashTreeWriter::WriterLoop, this);
+  fThread->Run();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashTreeWriter::~EEShashTreeWriter()
+{
+  fMutex->Lock();
+  fStop = true;
+  fFilled->Broadcast();
+  fMutex->UnLock();
+  fThread->Join();
+  delete fThread;
+
+  CreateTree::fInstance = fOutput;
+  for ( size_t i = 0; i < fBuffers.size(); ++i ) delete fBuffers[i];
+
+  delete fWritten;
+  delete fFilled;
+  delete fMutex;
+
+  if ( fInstance == this ) fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeWriter::BeginOfRun()
+{
+  Drain();
+
+  // all the buffers are free, the depth may have changed
+  CreateTree::fInstance = fOutput;
+  for ( size_t i = 0; i < fBuffers.size(); ++i ) delete fBuffers[i];
+  fBuffers.clear();
+  fFree.clear();
+  if ( fDepth > 0 ) {
+    for ( G4int i = 0; i <= fDepth; ++i ) {
+      fBuffers.push_back(CreateTree::NewBuffer());
+      fFree.push_back(fBuffers.back());
+    }
+    CreateTree::fInstance = fFree.front();
+    fFree.pop_front();
+  }
+
+  fOutput->ApplyOutputSettings();
+
+  fNofEvents = 0;
+  fMaxQueued = 0;
+  fSumQueued = 0.;
+  fNofStalls = 0;
+  fStallTime = 0.;
+  fWriteTime = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeWriter::Fill()
+{
+  ++fNofEvents;
+  if ( fBuffers.empty() ) {
+    fOutput->Fill();
+    return;
+  }
+
+  fMutex->Lock();
+  fQueue.push_back(CreateTree::Instance());
+  G4int nofQueued = fQueue.size();
+  if ( nofQueued > fMaxQueued ) fMaxQueued = nofQueued;
+  fSumQueued += nofQueued;
+  fFilled->Signal();
+
+  if ( fFree.empty() ) {
+    G4Timer timer;
+    timer.Start();
+    while ( fFree.empty() ) fWritten->Wait();
+    timer.Stop();
+    ++fNofStalls;
+    fStallTime += timer.GetRealElapsed();
+  }
+  CreateTree::fInstance = fFree.front();
+  fFree.pop_front();
+  fMutex->UnLock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeWriter::EndOfRun()
+{
+  Drain();
+
+  G4cout << "EEShashTreeWriter: " << fNofEvents << " events, depth "
+         << fDepth << ", mean/max queued "
+         << ( fNofEvents > 0 ? fSumQueued/fNofEvents : 0. ) << "/"
+         << fMaxQueued << ", " << fNofStalls << " stalls for "
+         << fStallTime << " s, writer busy " << fWriteTime << " s" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashTreeWriter::Drain()
+{
+  fMutex->Lock();
+  while ( ! fQueue.empty() || fBusy ) fWritten->Wait();
+  fMutex->UnLock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void* EEShashTreeWriter::WriterLoop(void* arg)
+{
+  EEShashTreeWriter* writer = static_cast<EEShashTreeWriter*>(arg);
+
+  writer->fMutex->Lock();
+  while ( true ) {
+    while ( writer->fQueue.empty() && ! writer->fStop )
+      writer->fFilled->Wait();
+    if ( writer->fQueue.empty() ) break;
+    CreateTree* buffer = writer->fQueue.front();
+    writer->fQueue.pop_front();
+    writer->fBusy = true;
+    writer->fMutex->UnLock();
+
+    G4Timer timer;
+    timer.Start();
+    buffer->CopyEvent(*writer->fOutput);
+    writer->fOutput->Fill();
+    timer.Stop();
+
+    writer->fMutex->Lock();
+    writer->fWriteTime += timer.GetRealElapsed();
+    writer->fBusy = false;
+    writer->fFree.push_back(buffer);
+    writer->fWritten->Broadcast();
+  }
+  writer->fMutex->UnLock();
+
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
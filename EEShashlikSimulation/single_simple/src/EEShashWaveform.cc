@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashWaveform.cc
+/// \brief Implementation of the EEShashWaveform class
+
+#include "EEShashWaveform.hh"
+
+#include <fstream>
+#include <algorithm>
+
+std::vector<G4double> EEShashWaveform::fKernel;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashWaveform::EEShashWaveform(G4int nBins, G4double tMin, G4double tMax)
+ : fTMin(tMin),
+   fBinWidth((tMax-tMin)/nBins),
+   fSamples(nBins, 0.),
+   fBuffer(nBins, 0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashWaveform::~EEShashWaveform()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWaveform::Reset()
+{
+  fSamples.assign(fSamples.size(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWaveform::Fill(G4double time, G4double weight)
+{
+  G4double x = (time - fTMin)/fBinWidth;
+  if ( x < 0. || x >= fSamples.size() ) return;
+  fSamples[G4int(x)] += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWaveform::Convolve()
+{
+  if ( fKernel.empty() ) return;
+
+  // the waveform is mostly empty, loop on the filled bins only
+  G4int nBins = fSamples.size();
+  G4int nKernel = fKernel.size();
+  fBuffer.assign(nBins, 0.);
+  for ( G4int i = 0; i < nBins; ++i ) {
+    if ( fSamples[i] == 0. ) continue;
+    G4int n = std::min(nKernel, nBins - i);
+    for ( G4int j = 0; j < n; ++j ) fBuffer[i+j] += fSamples[i]*fKernel[j];
+  }
+  fSamples.swap(fBuffer);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWaveform::CopyTo(float* samples) const
+{
+  for ( size_t i = 0; i < fSamples.size(); ++i ) samples[i] = fSamples[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWaveform::LoadKernel(const G4String& fileName)
+{
+  std::ifstream in(fileName.c_str());
+  fKernel.clear();
+  G4double value;
+  while ( in >> value ) fKernel.push_back(value);
+
+  if ( fKernel.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read waveform kernel file " << fileName;
+    G4Exception("EEShashWaveform::LoadKernel()",
+      "MyCode0010", FatalException, msg);
+    return;
+  }
+
+  G4cout << "EEShashWaveform: " << fKernel.size()
+         << " kernel samples read from " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
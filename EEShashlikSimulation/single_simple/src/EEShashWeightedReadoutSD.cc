@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EEShashWeightedReadoutSD.cc
+/// \brief Implementation of the EEShashWeightedReadoutSD class
+
+#include "EEShashWeightedReadoutSD.hh"
+#include "EEShashFibreTable.hh"
+#include "TrackInformation.hh"
+#include "G4Track.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashWeightedReadoutSD::EEShashWeightedReadoutSD(
+                            const G4String& name, 
+                            const G4String& hitsCollectionName,
+                            G4int nofFibres,
+                            G4double acceptance)
+ : EEShashOpticalReadoutSD(name, hitsCollectionName, nofFibres, acceptance)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EEShashWeightedReadoutSD::~EEShashWeightedReadoutSD() 
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWeightedReadoutSD::Initialize(G4HCofThisEvent* hce)
+{
+  EEShashOpticalReadoutSD::Initialize(hce);
+
+  // photons still pending in the fibre calibration belong to the last event
+  if ( EEShashFibreTable::Instance() ) EEShashFibreTable::Instance()->ClearPending();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EEShashWeightedReadoutSD::PhotonArrived(const G4Track* track,
+                                             G4double& weight,
+                                             G4bool& preselected)
+{
+  // fibre calibration: every photon reaching the grease counts as arrived
+  if ( EEShashFibreTable::Instance() )
+    EEShashFibreTable::Instance()->RecordArrival(track->GetTrackID(),
+                                                 track->GetGlobalTime());
+
+  const TrackInformation* info
+    = static_cast<const TrackInformation*>(track->GetUserInformation());
+  if ( info ) {
+    weight = info->GetParticleWeight();
+    preselected = info->GetQEApplied();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -40,6 +40,7 @@
 //
 
 #include "G4EmUserPhysics.hh"
+#include "EEShashOpticalMessenger.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4LossTableManager.hh"
 #include "G4VEnergyLossProcess.hh"
@@ -51,7 +52,7 @@
 #include "G4EmProcessSubType.hh"
 #include "G4SystemOfUnits.hh"
 
-#include "G4Cerenkov.hh"
+#include "EEShashCerenkov.hh"
 #include "G4OpWLS.hh"
 #include "G4Scintillation.hh"
 #include "G4OpAbsorption.hh"
@@ -59,18 +60,71 @@
 #include "G4OpMieHG.hh"
 #include "G4OpBoundaryProcess.hh"
 #include "G4EmSaturation.hh"
+#include "G4FastSimulationManagerProcess.hh"
+#include "G4Threading.hh"
 
+G4double G4EmUserPhysics::thinningFactor = 1.;
+G4double G4EmUserPhysics::cerenkovLambdaMin = 480.;
+G4double G4EmUserPhysics::cerenkovLambdaMax = 620.;
+G4ThreadLocal EEShashCerenkov * G4EmUserPhysics::theCerenkovProcess = 0;
+G4ThreadLocal G4OpWLS * G4EmUserPhysics::theWLSProcess = 0;
+G4ThreadLocal G4Scintillation * G4EmUserPhysics::theScintillationProcess = 0;
+G4ThreadLocal G4OpAbsorption * G4EmUserPhysics::theAbsorptionProcess = 0;
+G4ThreadLocal G4OpRayleigh * G4EmUserPhysics::theRayleighScatteringProcess = 0;
+G4ThreadLocal G4OpMieHG * G4EmUserPhysics::theMieHGScatteringProcess = 0;
+G4ThreadLocal G4OpBoundaryProcess * G4EmUserPhysics::theBoundaryProcess = 0;
+G4ThreadLocal EEShashOpticalMessenger * G4EmUserPhysics::theWorkerMessenger = 0;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-G4EmUserPhysics::G4EmUserPhysics(const G4int& scint, const G4int& cher) :
+G4EmUserPhysics::G4EmUserPhysics(const G4int& scint, const G4int& cher, const G4int& fastSim) :
   G4VPhysicsConstructor("User Optical Options"),
   switchOnScintillation(scint),
-  switchOnCerenkov(cher)
+  switchOnCerenkov(cher),
+  switchOnFastSimulation(fastSim)
 {
   G4LossTableManager::Instance();
+  theMessenger = new EEShashOpticalMessenger(this);
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 G4EmUserPhysics::~G4EmUserPhysics()
-{}
+{
+  delete theMessenger;
+}
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void G4EmUserPhysics::SetThinningFactor(G4double factor)
+{
+  if( factor < 1. ) {
+    G4ExceptionDescription msg;
+    msg << "Thinning factor " << factor << " < 1 ignored";
+    G4Exception("G4EmUserPhysics::SetThinningFactor()",
+      "MyCode0007", JustWarning, msg);
+    return;
+  }
+  if( G4Threading::IsMasterThread() ) thinningFactor = factor;
+  if( theScintillationProcess )
+    theScintillationProcess->SetScintillationYieldFactor(1./factor);
+  G4cout << ">>> Optical photon thinning factor: " << factor << G4endl;
+}
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void G4EmUserPhysics::SetCerenkovWindow(G4double lambdaMin, G4double lambdaMax)
+{
+  if( lambdaMin <= 0. || lambdaMax <= lambdaMin ) {
+    G4ExceptionDescription msg;
+    msg << "Cerenkov window " << lambdaMin << " - " << lambdaMax
+        << " nm ignored";
+    G4Exception("G4EmUserPhysics::SetCerenkovWindow()",
+      "MyCode0008", JustWarning, msg);
+    return;
+  }
+  if( G4Threading::IsMasterThread() ) {
+    cerenkovLambdaMin = lambdaMin;
+    cerenkovLambdaMax = lambdaMax;
+  }
+  if( theCerenkovProcess )
+    theCerenkovProcess->SetEnergyWindow(1239.84193/lambdaMax*eV,
+                                        1239.84193/lambdaMin*eV);
+  G4cout << ">>> Cerenkov window: " << lambdaMin << " - "
+         << lambdaMax << " nm" << G4endl;
+}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void G4EmUserPhysics::ConstructParticle()
 {
@@ -80,10 +134,16 @@ void G4EmUserPhysics::ConstructParticle()
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void G4EmUserPhysics::ConstructProcess()
 {
+  if( ! G4Threading::IsMasterThread() && ! theWorkerMessenger )
+    theWorkerMessenger = new EEShashOpticalMessenger(this);
+
   theWLSProcess = new G4OpWLS();
   //  fWLSProcess = new G4OpWLS();
 
-  theCerenkovProcess = new G4Cerenkov("Cerenkov");
+  // photons outside the photodetector window are never generated
+  theCerenkovProcess = new EEShashCerenkov("Cerenkov",
+                                           1239.84193/cerenkovLambdaMax*eV,
+                                           1239.84193/cerenkovLambdaMin*eV);
   theScintillationProcess = new G4Scintillation("Scintillation");
   theAbsorptionProcess = new G4OpAbsorption();
   theRayleighScatteringProcess = new G4OpRayleigh();
@@ -98,7 +158,7 @@ void G4EmUserPhysics::ConstructProcess()
   theCerenkovProcess->SetMaxBetaChangePerStep(15.0);
   theCerenkovProcess->SetTrackSecondariesFirst(true);
 
-  theScintillationProcess->SetScintillationYieldFactor(1.);
+  theScintillationProcess->SetScintillationYieldFactor(1./thinningFactor);
   theScintillationProcess->SetTrackSecondariesFirst(true);
 
   // Use Birks Correction in the Scintillation process
@@ -135,6 +195,10 @@ void G4EmUserPhysics::ConstructProcess()
 
 	  pmanager->AddDiscreteProcess(theWLSProcess);
 
+	  // let EEShashFibreFastModel and EEShashTileFastModel take over the photons
+	  if( switchOnFastSimulation )
+	    pmanager->AddDiscreteProcess(new G4FastSimulationManagerProcess("fastSimProcess_opticalphoton"));
+
 	}
     }
 }
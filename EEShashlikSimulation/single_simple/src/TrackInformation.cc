@@ -2,7 +2,7 @@
 
 using namespace CLHEP;
 
-G4Allocator<TrackInformation> aTrackInformationAllocator;
+G4ThreadLocal G4Allocator<TrackInformation>* aTrackInformationAllocator = 0;
 
 TrackInformation::TrackInformation()
 {
@@ -21,6 +21,8 @@ TrackInformation::TrackInformation()
   parentMomentum = G4ThreeVector(0.,0.,0.);
   parentEnergy = 0.;
   parentTime = 0.;
+  particleWeight = 1.;
+  qeApplied = false;
 }
 
 TrackInformation::TrackInformation(const G4Track* aTrack)
@@ -39,6 +41,8 @@ TrackInformation::TrackInformation(const G4Track* aTrack)
   parentMomentum = aTrack->GetMomentum();
   parentEnergy = aTrack->GetTotalEnergy();
   parentTime = aTrack->GetGlobalTime();
+  particleWeight = 1.;
+  qeApplied = false;
 }
 
 TrackInformation::TrackInformation(const TrackInformation* aTrackInfo)
@@ -58,6 +62,8 @@ TrackInformation::TrackInformation(const TrackInformation* aTrackInfo)
   parentMomentum = aTrackInfo->parentMomentum;
   parentEnergy = aTrackInfo->parentEnergy;
   parentTime = aTrackInfo->parentTime;
+  particleWeight = aTrackInfo->particleWeight;
+  qeApplied = aTrackInfo->qeApplied;
 }
 
 void TrackInformation::SetParticleInformation(const TrackInformation* aTrackInfo)
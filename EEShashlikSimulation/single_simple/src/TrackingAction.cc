@@ -6,6 +6,11 @@
 #include "G4Track.hh"
 #include "G4UnitsTable.hh"
 #include "G4TrackingManager.hh"
+#include "G4VProcess.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4EmUserPhysics.hh"
+#include "EEShashRunTelemetry.hh"
+#include "EEShashOpticalKillPolicy.hh"
 
 using namespace CLHEP;
 
@@ -18,6 +23,10 @@ TrackingAction::~TrackingAction()
 
 void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
 {
+  if( aTrack->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition() ) {
+    EEShashRunTelemetry::PhotonTracked();
+    EEShashOpticalKillPolicy::BeginOfTrack();
+  }
   
   //---------------------
   // tracking information
@@ -53,6 +62,15 @@ void TrackingAction::PostUserTrackingAction(const G4Track* aTrack)
 	  TrackInformation* newTrackInfo = new TrackInformation((*secondaries)[i]);
 	  newTrackInfo -> SetParentInformation( aTrackInfo );
 	  newTrackInfo -> SetParticleProdTimeInformation( secTrack->GetGlobalTime()/picosecond );
+	  // thinned scintillation photons stand for several physical ones, the
+	  // others (e.g. WLS re-emission) carry on the weight of their parent
+	  G4double weight = aTrackInfo->GetParticleWeight();
+	  if( secTrack->GetCreatorProcess() && secTrack->GetCreatorProcess()->GetProcessSubType() == fScintillation )
+	    weight *= G4EmUserPhysics::GetThinningFactor();
+	  newTrackInfo -> SetParticleWeight( weight );
+	  // re-emissions of a photon kept at birth are not preselected again,
+	  // the readout plays the rest of the QE at their final energy
+	  newTrackInfo -> SetQEApplied( aTrackInfo->GetQEApplied() );
 	  secTrack -> SetUserInformation( newTrackInfo );
 	}
     }
@@ -74,6 +74,7 @@ private:
    G4double    dEdLHcal[20], RangeHcalLay[20];
    G4int       printModulo;                     
    G4int       evtNbOld;
+   G4double    eventStart;                      // wall time [s]
 
 };
 
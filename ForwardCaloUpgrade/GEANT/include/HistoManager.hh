@@ -60,6 +60,7 @@ class HistoManager
     void SetEcalCellNoise(G4double);
 
     void SetJobRunNumber(G4int);
+    void SetTelemetryInterval(G4double);
 
     G4int       GetnLtot()           {return nLtot;};
     G4int       GetnRtot()           {return nRtot;};
@@ -75,6 +76,7 @@ class HistoManager
     G4double    GetHcaldRbin()       {return dRbinHcal;};
 
     G4int       GetJobRunNumber()    {return RunNumber;};
+    G4double    GetTelemetryInterval() {return TelemetryInterval;};
  
     G4String    GetfileName()        {return fileName;};
 
@@ -114,6 +116,7 @@ class HistoManager
     G4double dLbin,  dRbin,  dLbinAbs,  dRbinAbs,  dRbinHcal;      
 
     G4int    RunNumber;
+    G4double TelemetryInterval;   // between samples of the run telemetry, 0 for none
 
     G4String  fileName ;
     HistoMessenger* histoMessenger;
@@ -41,6 +41,7 @@ class HistoMessenger: public G4UImessenger
     G4UIcmdWith3Vector*        RespEcalCmd;
     G4UIcmdWithADoubleAndUnit* NoiseEcalCmd;
     G4UIcmdWithAnInteger*      RunNumberCmd;
+    G4UIcmdWithADoubleAndUnit* TelemetryCmd;
 
 };
 
@@ -9,6 +9,9 @@
 #include "G4UserRunAction.hh"
 #include "globals.hh"
 
+#include <vector>
+#include <fstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class DetectorConstruction;
@@ -33,6 +36,12 @@ class RunAction : public G4UserRunAction
     
   void fillPerEvent(G4double, G4double, G4double); 
 
+// run telemetry: wall time of each event, written with the throughput,
+// peak RSS, allocator pools and output size to <rootfile>.telemetry.json
+
+  void fillTelemetry(G4double, G4int);
+  static G4double WallTime();
+
 private:
 
   G4double sumEcal, sum2Ecal;
@@ -42,6 +51,15 @@ private:
   DetectorConstruction*   Det;
   PrimaryGeneratorAction* Kin;
   HistoManager*           myana;
+
+  G4double runStart, nextSample, sampleInterval;
+  G4long   nPrimaries;
+  std::vector<G4float> eventTimes;
+  std::ofstream*       samples;
+
+  G4String TelemetryName(const G4String&);
+  void     writeSample(G4double);
+  void     writeTelemetry(const G4Run*);
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -58,6 +58,7 @@ void EventAction::BeginOfEventAction(const G4Event* evt)
 
   G4int evtNb = evt->GetEventID();
   evtNbOld    = evt->GetEventID();
+  eventStart  = RunAction::WallTime();
 
   if (evtNb%printModulo == 0) { 
     G4cout << "\n---> Begin of event: " << evtNb << G4endl;
@@ -90,6 +91,11 @@ void EventAction::EndOfEventAction(const G4Event* evt)
 //accumulates statistics
 //----------------------
   runAct->fillPerEvent(EnergyEcal, EnergyHcal, EnergyZero);
+
+  G4int nPrimaries = 0;
+  for (G4int iv=0; iv<evt->GetNumberOfPrimaryVertex(); ++iv)
+    nPrimaries += evt->GetPrimaryVertex(iv)->GetNumberOfParticle();
+  runAct->fillTelemetry(RunAction::WallTime() - eventStart, nPrimaries);
   
 // fill histos
 //------------
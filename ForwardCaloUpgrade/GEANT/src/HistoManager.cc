@@ -41,6 +41,7 @@ HistoManager::HistoManager()
  CellNoise     = 140.0*MeV; 
 
  RunNumber = 0;
+ TelemetryInterval = 0.;
 
  //gROOT->Reset();                         // ROOT style
 
@@ -508,6 +509,13 @@ void HistoManager::Book(G4double Ekin, G4int nLayers)
     RunNumber = Value;
   }
 
+// Set interval between telemetry samples
+//----------------------------------------
+  void HistoManager::SetTelemetryInterval(G4double Value)
+  {
+    TelemetryInterval = Value;
+  }
+
 // Set ROOT file name
 //--------------------
   void HistoManager::SetFileName(G4String userFile)
@@ -87,6 +87,14 @@ HistoMessenger::HistoMessenger(HistoManager * man)
   RunNumberCmd->SetRange("Run>0");
   RunNumberCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  TelemetryCmd = new G4UIcmdWithADoubleAndUnit("/test/histo/setTelemetryInterval",this);
+  TelemetryCmd->SetGuidance("Sample the run telemetry every interval of wall time");
+  TelemetryCmd->SetGuidance("0 writes only the summary at the end of the run");
+  TelemetryCmd->SetParameterName("Interval",false);
+  TelemetryCmd->SetDefaultUnit("s");
+  TelemetryCmd->SetRange("Interval>=0.0");
+  TelemetryCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -102,6 +110,7 @@ HistoMessenger::~HistoMessenger()
   delete RespEcalCmd;
   delete NoiseEcalCmd;
   delete RunNumberCmd;
+  delete TelemetryCmd;
   delete FileNameCmd;  
   delete histoDir;
   delete testDir;  
@@ -138,6 +147,9 @@ void HistoMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
 
   if( command == RunNumberCmd )
    { histoManager->SetJobRunNumber(RunNumberCmd->GetNewIntValue(newValue));}
+
+  if( command == TelemetryCmd )
+   { histoManager->SetTelemetryInterval(TelemetryCmd->GetNewDoubleValue(newValue));}
   
 }
 
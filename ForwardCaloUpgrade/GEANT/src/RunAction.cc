@@ -14,10 +14,20 @@
 #include "PrimaryGeneratorAction.hh"
 #include "HistoManager.hh"
 
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4TouchableHistory.hh"
+
+#include <algorithm>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::RunAction(DetectorConstruction* det, PrimaryGeneratorAction* kin,
-                     HistoManager* histo):Det(det),Kin(kin), myana(histo)
+                     HistoManager* histo):Det(det),Kin(kin), myana(histo),
+                     samples(0)
 {}
 
 RunAction::~RunAction()
@@ -57,6 +67,16 @@ void RunAction::BeginOfRunAction(const G4Run* aRun)
   sumEcal  = sumHcal  = sumZero  = 0.;
   sum2Ecal = sum2Hcal = sum2Zero = 0.;
 
+// start the telemetry of the run
+
+  runStart   = WallTime();
+  sampleInterval = myana->GetTelemetryInterval()/s;
+  nextSample = runStart + sampleInterval;
+  nPrimaries = 0;
+  eventTimes.clear();
+  if (sampleInterval > 0.) samples = 
+    new std::ofstream(TelemetryName(".samples.jsonl").c_str());
+
 }
 
 
@@ -71,6 +91,110 @@ void RunAction::fillPerEvent(G4double eEcal, G4double eHcal, G4double eZero)
 
 }
 
+void RunAction::fillTelemetry(G4double eventTime, G4int nPrim)
+{
+
+// wall time [s] and primaries of one event, sampled every interval
+
+  eventTimes.push_back(eventTime);
+  nPrimaries += nPrim;
+
+  G4double now = WallTime();
+  if (samples && now >= nextSample) {
+    writeSample(now);
+    nextSample = now + sampleInterval;
+  }
+
+}
+
+G4double RunAction::WallTime()
+{
+  struct timeval now;
+  gettimeofday(&now, 0);
+  return now.tv_sec + 1.e-6*now.tv_usec;
+}
+
+G4String RunAction::TelemetryName(const G4String& suffix)
+{
+  G4String name = myana->GetfileName();
+  if (name.size() > 5 && name.substr(name.size()-5) == ".root")
+    name = name.substr(0, name.size()-5);
+  return name + suffix;
+}
+
+void RunAction::writeSample(G4double now)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  G4double elapsed = now - runStart;
+  G4int nEvents = eventTimes.size();
+
+  *samples << "{\"wall_s\": " << elapsed
+           << ", \"events\": " << nEvents
+           << ", \"events_per_s\": " << (elapsed > 0. ? nEvents/elapsed : 0.)
+           << ", \"peak_rss_mb\": " << usage.ru_maxrss/1024.
+           << "}" << std::endl;
+}
+
+void RunAction::writeTelemetry(const G4Run* aRun)
+{
+
+// throughput, event wall time quantiles, memory and output size
+
+  G4double elapsed = WallTime() - runStart;
+  G4double rate    = elapsed > 0. ? 1./elapsed : 0.;
+  G4int    nEvents = eventTimes.size();
+
+  std::vector<G4float> times(eventTimes);
+  std::sort(times.begin(), times.end());
+  G4double p50 = 0., p95 = 0., tmax = 0.;
+  if (nEvents > 0) {
+    p50  = times[G4int(0.50*(nEvents-1) + 0.5)];
+    p95  = times[G4int(0.95*(nEvents-1) + 0.5)];
+    tmax = times.back();
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  struct stat info;
+  G4long outputBytes = 0;
+  if (stat(myana->GetfileName().c_str(), &info) == 0) outputBytes = info.st_size;
+
+  G4String name = TelemetryName(".telemetry.json");
+  std::ofstream report(name.c_str());
+  report.precision(6);
+  report << "{\n  \"run\": "             << aRun->GetRunID()
+         << ",\n  \"wall_s\": "           << elapsed
+         << ",\n  \"events\": "           << nEvents
+         << ",\n  \"events_per_s\": "     << nEvents*rate
+         << ",\n  \"primaries_per_s\": "  << nPrimaries*rate
+         << ",\n  \"event_wall_s\": {\"p50\": " << p50
+         << ", \"p95\": " << p95 << ", \"max\": " << tmax << "}"
+         << ",\n  \"peak_rss_mb\": "      << usage.ru_maxrss/1024.
+         << ",\n  \"allocator_bytes\": {\"G4Track\": "
+         << aTrackAllocator.GetAllocatedSize()
+         << ", \"G4DynamicParticle\": "
+         << aDynamicParticleAllocator.GetAllocatedSize()
+         << ", \"G4TouchableHistory\": "
+         << aTouchableHistoryAllocator.GetAllocatedSize() << "}"
+         << ",\n  \"output_bytes\": "     << outputBytes
+         << "\n}\n";
+  report.close();
+
+  if (samples) {
+    writeSample(WallTime());
+    delete samples;
+    samples = 0;
+  }
+
+  G4cout << "\n Telemetry : " << nEvents << " events in " << elapsed
+         << " s (" << nEvents*rate << " /s), event p95 " << p95
+         << " s, max RSS " << usage.ru_maxrss/1024. << " MB -> " << name
+         << G4endl;
+
+}
+
 void RunAction::EndOfRunAction(const G4Run* aRun)
 {
   G4int NbOfEvents = aRun->GetNumberOfEvent();
@@ -79,6 +203,7 @@ void RunAction::EndOfRunAction(const G4Run* aRun)
 // save histos
 
   myana-> Save();
+  writeTelemetry(aRun);
   
 // compute statistics: mean and rms
 
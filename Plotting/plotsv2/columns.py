@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+"""
+Reader of the columnar export of the simulation (COLUMN_EXPORT=<file>),
+without ROOT. The format is described in
+EEShashlikSimulation/single_simple/include/EEShashColumnReader.hh.
+
+    cols = ColumnFile('out.col')
+    eabs = cols['Eabs']                  # numpy array, one value per event
+    times, offsets = cols['Photon_time'] # vector branch: values, offsets
+    first_event = times[offsets[0]:offsets[1]]
+
+The arrays are numpy memmaps: only the pages of the columns used are read.
+"""
+
+########################################
+# Imports
+########################################
+
+import struct
+import numpy
+
+from optparse import OptionParser
+
+
+########################################
+# Format
+########################################
+
+HEADER = struct.Struct('=8sIIQQ')
+INDEX = struct.Struct('=48scBHIQQQ')
+KIND_VECTOR = 2
+TYPES = {
+    'f': numpy.float32, 'd': numpy.float64,
+    'i': numpy.int32,   'I': numpy.uint32,
+    's': numpy.int16,   'S': numpy.uint16,
+    'c': numpy.int8,    'C': numpy.uint8,
+    'l': numpy.int64,   'L': numpy.uint64,
+    'b': numpy.bool_,
+    }
+
+
+class ColumnFile:
+
+    def __init__(self, filename):
+        self.filename = filename
+        with open(filename, 'rb') as f:
+            magic, version, n_columns, self.n_entries, index_offset = HEADER.unpack(f.read(HEADER.size))
+            if magic.rstrip(b'\0') != b'EESHCOL':
+                raise IOError('not a column file: ' + filename)
+            f.seek(index_offset)
+            self.index = {}
+            for i in range(n_columns):
+                name, type, kind, reserved, count, data_offset, n_values, offsets_offset = INDEX.unpack(f.read(INDEX.size))
+                name = name.rstrip(b'\0').decode()
+                self.index[name] = (type.decode(), kind, count, data_offset, n_values, offsets_offset)
+
+    def columns(self):
+        return sorted(self.index.keys())
+
+    def __getitem__(self, name):
+        type, kind, count, data_offset, n_values, offsets_offset = self.index[name]
+        values = numpy.memmap(self.filename, dtype=TYPES[type], mode='r',
+                              offset=data_offset, shape=(n_values,))
+        if kind == KIND_VECTOR:
+            offsets = numpy.memmap(self.filename, dtype=numpy.uint64, mode='r',
+                                   offset=offsets_offset, shape=(self.n_entries+1,))
+            return values, offsets
+        if count > 1:
+            return values.reshape((self.n_entries, count))
+        return values
+
+
+########################################
+# Main
+########################################
+
+def main():
+
+    parser = OptionParser(usage='%prog <file> [column ...]')
+    (options, args) = parser.parse_args()
+
+    cols = ColumnFile(args[0])
+    print('{0} events'.format(cols.n_entries))
+    for name in (args[1:] or cols.columns()):
+        column = cols[name]
+        if isinstance(column, tuple):
+            print('{0:20s} vector, {1} values'.format(name, len(column[0])))
+        else:
+            print('{0:20s} mean {1}'.format(name, column.mean() if len(column) else 0))
+
+
+if __name__ == "__main__":
+    main()